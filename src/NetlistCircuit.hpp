@@ -0,0 +1,983 @@
+/*
+    NetlistCircuit.hpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    A general simulator for circuits made of resistors, capacitors,
+    ideal op-amps, and comparators, described as a netlist.
+
+    This revives the netlist interface of fossil/circuit.hpp, but replaces
+    its gradient search with modified nodal analysis (MNA). Each ideal op-amp
+    holds its negative input at a virtual ground, so that node's voltage is
+    known and the op-amp's output voltage becomes the unknown in the node's
+    current equation. The op-amp supplies whatever current its output needs,
+    so the output node has no current equation. For a circuit like Sloth,
+    this leaves one unknown per op-amp output plus one per other free node.
+
+    Capacitors use the trapezoidal rule, which is second-order accurate and
+    matches the spirit of the midpoint solver in SlothCircuit.hpp. The unknowns
+    are the changes in the node voltages over the time step, so the changes
+    are not swamped by roundoff in the voltages themselves. The circuit matrix
+    depends only on the time step and the resistor values, so it is factored
+    once into sparse LU factors, and each time step is a single forward and
+    back substitution. A comparator's output only changes the right-hand side.
+    When a comparator toggles inside a time step, the step is split at the
+    crossing, which refactors scratch factors for each of the two partial steps.
+    For a small circuit like Sloth, that makes a crossing step a few times
+    more expensive than a normal one.
+    The matrix is refactored when a resistor changes or the time step changes.
+
+    Building the netlist can throw std::logic_error for an invalid circuit,
+    as fossil/circuit.hpp did. Once the circuit is locked, `update` never
+    throws, allocates, or locks: `lock` sizes every buffer and the factors
+    for their largest use, and factoring is done in place from then on.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "SlothCircuit.hpp"
+
+namespace Analog
+{
+    // The LU factors of a small square matrix with row pivoting, stored sparsely,
+    // so that solving touches only the nonzero entries of L and U.
+    class NetlistFactors
+    {
+    private:
+        struct Entry
+        {
+            int col;
+            double value;
+        };
+
+        int n = 0;
+        std::vector<int> perm;          // row i of the factors came from row perm[i] of the matrix
+        std::vector<Entry> lower;       // the strictly lower entries of L, row by row (L has a unit diagonal)
+        std::vector<int> lowerEnd;
+        std::vector<Entry> upper;       // the strictly upper entries of U, row by row
+        std::vector<int> upperEnd;
+        std::vector<double> inverseDiagonal;
+        std::vector<double> a;          // the matrix being factored, in place
+
+    public:
+        bool factor(const std::vector<double>& matrix, int size)
+        {
+            // Factors the size-by-size matrix stored row by row in `matrix`.
+            // Returns false if the matrix is singular. Once the factors have been
+            // sized by a first call, later calls of the same size do not allocate memory.
+            n = size;
+            a.assign(matrix.begin(), matrix.begin() + n*n);
+            perm.resize(n);
+            lower.reserve(n*(n-1)/2);
+            lowerEnd.reserve(n);
+            upper.reserve(n*(n-1)/2);
+            upperEnd.reserve(n);
+            for (int i = 0; i < n; ++i)
+                perm[i] = i;
+
+            for (int k = 0; k < n; ++k)
+            {
+                int pivot = k;
+                for (int i = k + 1; i < n; ++i)
+                    if (std::abs(a[i*n + k]) > std::abs(a[pivot*n + k]))
+                        pivot = i;
+
+                if (a[pivot*n + k] == 0.0)
+                    return false;
+
+                if (pivot != k)
+                {
+                    for (int j = 0; j < n; ++j)
+                        std::swap(a[k*n + j], a[pivot*n + j]);
+                    std::swap(perm[k], perm[pivot]);
+                }
+
+                for (int i = k + 1; i < n; ++i)
+                {
+                    double m = a[i*n + k];
+                    if (m != 0.0)
+                    {
+                        m /= a[k*n + k];
+                        a[i*n + k] = m;
+                        for (int j = k + 1; j < n; ++j)
+                            a[i*n + j] -= m * a[k*n + j];
+                    }
+                }
+            }
+
+            lower.clear();
+            lowerEnd.clear();
+            upper.clear();
+            upperEnd.clear();
+            inverseDiagonal.resize(n);
+            for (int i = 0; i < n; ++i)
+            {
+                for (int j = 0; j < i; ++j)
+                    if (a[i*n + j] != 0.0)
+                        lower.push_back(Entry{j, a[i*n + j]});
+                lowerEnd.push_back(static_cast<int>(lower.size()));
+
+                for (int j = i + 1; j < n; ++j)
+                    if (a[i*n + j] != 0.0)
+                        upper.push_back(Entry{j, a[i*n + j]});
+                upperEnd.push_back(static_cast<int>(upper.size()));
+
+                inverseDiagonal[i] = 1.0 / a[i*n + i];
+            }
+            return true;
+        }
+
+        void solve(const double *b, double *x) const
+        {
+            // Solves A x = b, where A is the matrix most recently factored.
+            int e = 0;
+            for (int i = 0; i < n; ++i)
+            {
+                double sum = b[perm[i]];
+                for (; e < lowerEnd[i]; ++e)
+                    sum -= lower[e].value * x[lower[e].col];
+                x[i] = sum;
+            }
+
+            for (int i = n - 1; i >= 0; --i)
+            {
+                double sum = x[i];
+                for (e = (i > 0) ? upperEnd[i-1] : 0; e < upperEnd[i]; ++e)
+                    sum -= upper[e].value * x[upper[e].col];
+                x[i] = sum * inverseDiagonal[i];
+            }
+        }
+
+        int nonzeroCount() const
+        {
+            return n + static_cast<int>(lower.size() + upper.size());
+        }
+    };
+
+
+    // The continuous-time state equations of a netlist, as derived by hand
+    // in the README for Sloth. The state variables are the capacitor voltages s,
+    // the inputs u are the forced voltages other than ground, and q are the
+    // comparator outputs. Together they form the columns [s, u, q], and
+    //     ds/dt = D [s, u, q]
+    //     v     = V [s, u, q]
+    // where v is the voltage of any node.
+    struct NetlistStateSpace
+    {
+        int states = 0;
+        int inputs = 0;
+        int comparators = 0;
+        std::vector<int> capacitorA;        // the state s[i] is the voltage of capacitorA[i] minus that of capacitorB[i]
+        std::vector<int> capacitorB;
+        std::vector<int> inputNode;
+        std::vector<int> comparatorNeg;
+        std::vector<double> comparatorLow;
+        std::vector<double> comparatorHigh;
+        std::vector<double> D;              // states rows, row by row
+        std::vector<double> V;              // one row per node
+
+        int columns() const
+        {
+            return states + inputs + comparators;
+        }
+
+        int inputColumn(int input) const
+        {
+            return states + input;
+        }
+
+        int comparatorColumn(int comparator) const
+        {
+            return states + inputs + comparator;
+        }
+
+        double derivative(int state, int column) const
+        {
+            return D[state*columns() + column];
+        }
+
+        double voltage(int node, int column) const
+        {
+            return V[node*columns() + column];
+        }
+    };
+
+
+    class NetlistCircuit
+    {
+    private:
+        struct Node
+        {
+            bool forced = false;            // the voltage is set from outside: ground, an input, or a comparator output
+            bool ground = false;
+            bool virtualGround = false;     // the negative input of a linear amp
+            bool ampOutput = false;         // the output of a linear amp
+            int unknown = -1;               // index of this node's voltage change among the unknowns, or -1 if known
+            int row = -1;                   // index of this node's current equation, or -1 if it has none
+        };
+
+        struct Resistor
+        {
+            double resistance;
+            int a, b;
+        };
+
+        struct Capacitor
+        {
+            double capacitance;
+            int a, b;
+            int rowA = -1;
+            int rowB = -1;
+            double current = 0.0;           // the current from a to b at the end of the latest time step
+        };
+
+        struct Comparator
+        {
+            int neg, out;
+            double low, high;
+        };
+
+        struct Term
+        {
+            int node;
+            double conductance;
+        };
+
+        bool locked = false;
+        std::vector<Node> nodes;
+        std::vector<double> voltage;        // the voltage of every node, kept apart from `nodes` for the inner loops
+        std::vector<Resistor> resistors;
+        std::vector<Capacitor> capacitors;
+        std::vector<int> ampNeg;
+        std::vector<int> ampOut;
+        std::vector<Comparator> comparators;
+
+        // The solver works on n unknown voltage changes, with one current equation for each.
+        int n = 0;
+        std::vector<int> unknownNode;       // the node whose voltage change is each unknown
+        std::vector<Term> terms;            // for each equation, the resistor current out of its node is the sum of conductance*voltage
+        std::vector<int> termEnd;
+        NetlistFactors factors;             // the factors for time step `factorDt`
+        NetlistFactors partial;             // scratch factors for a step split at a comparator crossing
+        NetlistFactors normal;              // the factors of the normal equations solved by settleCurrents
+        bool normalValid = false;           // false if the normal equations are singular
+        double factorDt = 0.0;              // zero means the terms and factors need to be recalculated
+        bool currentsValid = false;         // false when the capacitor currents need to be made consistent with the voltages
+        std::vector<double> matrix;
+        std::vector<double> rhs;
+        std::vector<double> solution;
+        std::vector<double> delta;          // the change in every node's voltage over the time step
+        std::vector<double> etr;            // scratch space for settleCurrents
+        std::vector<double> settled;
+
+        int validNode(int index) const
+        {
+            if (index < 0 || index >= static_cast<int>(nodes.size()))
+                throw std::logic_error("NetlistCircuit: invalid node index " + std::to_string(index));
+            return index;
+        }
+
+        void confirmUnlocked() const
+        {
+            if (locked)
+                throw std::logic_error("NetlistCircuit: once the circuit is locked, you cannot add new nodes or components.");
+        }
+
+        bool refactor(NetlistFactors& f, double dt)
+        {
+            // The matrix relating the unknown voltage changes to the currents they
+            // cause: each resistor's conductance, plus 2C/dt for each capacitor.
+            matrix.assign(n * n, 0.0);
+            auto stamp = [&](int p, int q, double g)
+            {
+                const Node& np = nodes[p];
+                const Node& nq = nodes[q];
+                if (np.row >= 0)
+                {
+                    if (np.unknown >= 0) matrix[np.row*n + np.unknown] += g;
+                    if (nq.unknown >= 0) matrix[np.row*n + nq.unknown] -= g;
+                }
+                if (nq.row >= 0)
+                {
+                    if (nq.unknown >= 0) matrix[nq.row*n + nq.unknown] += g;
+                    if (np.unknown >= 0) matrix[nq.row*n + np.unknown] -= g;
+                }
+            };
+
+            for (const Resistor& r : resistors)
+                stamp(r.a, r.b, 1.0 / r.resistance);
+
+            for (const Capacitor& c : capacitors)
+                stamp(c.a, c.b, 2.0 * c.capacitance / dt);
+
+            return f.factor(matrix, n);
+        }
+
+        void gatherTerms()
+        {
+            // Combine the resistors into one sparse row for each equation,
+            // so the residual costs one multiply per distinct node in each row.
+            // Virtual grounds are always at zero volts, so they are left out.
+            const int count = static_cast<int>(nodes.size());
+            matrix.assign(n * count, 0.0);
+            for (const Resistor& r : resistors)
+            {
+                const double g = 1.0 / r.resistance;
+                const int ra = nodes[r.a].row;
+                const int rb = nodes[r.b].row;
+                if (ra >= 0)
+                {
+                    matrix[ra*count + r.a] += g;
+                    matrix[ra*count + r.b] -= g;
+                }
+                if (rb >= 0)
+                {
+                    matrix[rb*count + r.b] += g;
+                    matrix[rb*count + r.a] -= g;
+                }
+            }
+
+            terms.clear();
+            termEnd.clear();
+            for (int row = 0; row < n; ++row)
+            {
+                for (int i = 0; i < count; ++i)
+                    if (matrix[row*count + i] != 0.0 && !nodes[i].virtualGround)
+                        terms.push_back(Term{i, matrix[row*count + i]});
+                termEnd.push_back(static_cast<int>(terms.size()));
+            }
+        }
+
+        void residual(double *b) const
+        {
+            // The currents flowing out of each equation's node through the resistors,
+            // negated, plus the capacitor currents from the end of the previous step.
+            int e = 0;
+            for (int row = 0; row < n; ++row)
+            {
+                double sum = 0.0;
+                for (; e < termEnd[row]; ++e)
+                    sum += terms[e].conductance * voltage[terms[e].node];
+                b[row] = -sum;
+            }
+
+            for (const Capacitor& c : capacitors)
+            {
+                if (c.rowA >= 0) b[c.rowA] += c.current;
+                if (c.rowB >= 0) b[c.rowB] -= c.current;
+            }
+        }
+
+        void step(const NetlistFactors& f)
+        {
+            // Solve for the voltage changes over the time step, and store them in `delta`.
+            // The known nodes keep a zero change.
+            residual(rhs.data());
+            f.solve(rhs.data(), solution.data());
+            for (int k = 0; k < n; ++k)
+                delta[unknownNode[k]] = solution[k];
+        }
+
+        void commit(double dt)
+        {
+            // Apply the voltage changes in `delta`, and advance the capacitor currents.
+            const double scale = 2.0 / dt;
+            for (Capacitor& c : capacitors)
+                c.current = (scale * c.capacitance) * (delta[c.a] - delta[c.b]) - c.current;
+            for (int k = 0; k < n; ++k)
+                voltage[unknownNode[k]] += solution[k];
+        }
+
+        static double compare(const Comparator& k, double v)
+        {
+            // The comparator's positive input is grounded, so it is inverting.
+            return (v < 0) ? k.high : k.low;
+        }
+
+        void updateComparatorOutputs()
+        {
+            for (const Comparator& k : comparators)
+                voltage[k.out] = compare(k, voltage[k.neg]);
+        }
+
+        double incidence(int capacitor, int row) const
+        {
+            const Capacitor& c = capacitors[capacitor];
+            return ((c.rowA == row) ? 1.0 : 0.0) - ((c.rowB == row) ? 1.0 : 0.0);
+        }
+
+        void settleCurrents()
+        {
+            // Find the capacitor currents that satisfy the current equations for the
+            // present node voltages, in the least-squares sense in case the equations
+            // do not determine them uniquely. The trapezoidal rule needs them at the
+            // start of the first time step.
+            const int m = static_cast<int>(capacitors.size());
+            currentsValid = true;
+            if (m == 0)
+                return;
+
+            for (Capacitor& c : capacitors)
+                c.current = 0.0;
+            residual(rhs.data());       // with zero currents, this is minus the resistor current out of each node
+
+            // Each capacitor current leaves node a and enters node b.
+            // Solve the normal equations (E^T E) i = E^T r, whose matrix was factored by `lock`.
+            if (!normalValid)
+                return;
+            for (int p = 0; p < m; ++p)
+            {
+                etr[p] = 0.0;
+                for (int row = 0; row < n; ++row)
+                    etr[p] += incidence(p, row) * rhs[row];
+            }
+            normal.solve(etr.data(), settled.data());
+            for (int p = 0; p < m; ++p)
+                capacitors[p].current = settled[p];
+        }
+
+        void factorNormalEquations()
+        {
+            // E^T E depends only on which equations each capacitor touches.
+            const int m = static_cast<int>(capacitors.size());
+            matrix.assign(m * m, 0.0);
+            for (int p = 0; p < m; ++p)
+                for (int q = 0; q < m; ++q)
+                    for (int row = 0; row < n; ++row)
+                        matrix[p*m + q] += incidence(p, row) * incidence(q, row);
+            normalValid = (m > 0) && normal.factor(matrix, m);
+            etr.assign(m, 0.0);
+            settled.assign(m, 0.0);
+        }
+
+        bool isComparatorOutput(int nodeIndex) const
+        {
+            for (const Comparator& k : comparators)
+                if (k.out == nodeIndex)
+                    return true;
+            return false;
+        }
+
+    public:
+        int createNode()
+        {
+            confirmUnlocked();
+            nodes.push_back(Node());
+            voltage.push_back(0.0);
+            return static_cast<int>(nodes.size()) - 1;
+        }
+
+        int createForcedVoltageNode(double forcedVoltage)
+        {
+            // A node whose voltage is set from outside the circuit, for example a CV input.
+            int index = createNode();
+            nodes[index].forced = true;
+            voltage[index] = forcedVoltage;
+            return index;
+        }
+
+        int createGroundNode()
+        {
+            int index = createForcedVoltageNode(0.0);
+            nodes[index].ground = true;
+            return index;
+        }
+
+        int addResistor(double resistance, int aNodeIndex, int bNodeIndex)
+        {
+            confirmUnlocked();
+            if (!(resistance > 0.0))
+                throw std::logic_error("NetlistCircuit: resistance must be positive.");
+            resistors.push_back(Resistor{resistance, validNode(aNodeIndex), validNode(bNodeIndex)});
+            return static_cast<int>(resistors.size()) - 1;
+        }
+
+        int addCapacitor(double capacitance, int aNodeIndex, int bNodeIndex)
+        {
+            confirmUnlocked();
+            if (!(capacitance > 0.0))
+                throw std::logic_error("NetlistCircuit: capacitance must be positive.");
+            Capacitor c{capacitance, validNode(aNodeIndex), validNode(bNodeIndex)};
+            capacitors.push_back(c);
+            return static_cast<int>(capacitors.size()) - 1;
+        }
+
+        int addLinearAmp(int negNodeIndex, int outNodeIndex)
+        {
+            // An ideal op-amp with its positive input grounded. It drives its output
+            // to whatever voltage holds its negative input at zero volts.
+            confirmUnlocked();
+            Node& neg = nodes.at(validNode(negNodeIndex));
+            Node& out = nodes.at(validNode(outNodeIndex));
+            if (neg.forced || neg.virtualGround || neg.ampOutput || negNodeIndex == outNodeIndex)
+                throw std::logic_error("NetlistCircuit: a linear amp's negative input must be a free node of its own.");
+            if (out.forced || out.virtualGround || out.ampOutput)
+                throw std::logic_error("NetlistCircuit: a linear amp's output must be a free node that nothing else drives.");
+            neg.virtualGround = true;
+            out.ampOutput = true;
+            ampNeg.push_back(negNodeIndex);
+            ampOut.push_back(outNodeIndex);
+            return static_cast<int>(ampNeg.size()) - 1;
+        }
+
+        int addComparator(int negNodeIndex, int outNodeIndex, double low = QNEG, double high = QPOS)
+        {
+            // An op-amp with its positive input grounded and its output saturated:
+            // `high` when the negative input is below zero, otherwise `low`.
+            confirmUnlocked();
+            validNode(negNodeIndex);
+            Node& out = nodes.at(validNode(outNodeIndex));
+            if (out.forced || out.virtualGround || out.ampOutput)
+                throw std::logic_error("NetlistCircuit: a comparator's output must be a free node that nothing else drives.");
+            out.forced = true;
+            comparators.push_back(Comparator{negNodeIndex, outNodeIndex, low, high});
+            return static_cast<int>(comparators.size()) - 1;
+        }
+
+        void lock()
+        {
+            // Finishes building the circuit and numbers the unknowns and equations.
+            // Every free node that is not an op-amp output has a current equation,
+            // and every free node that is not a virtual ground has an unknown voltage.
+            if (locked)
+                return;
+
+            int unknowns = 0;
+            int rows = 0;
+            for (int i = 0; i < static_cast<int>(nodes.size()); ++i)
+            {
+                Node& node = nodes[i];
+                if (!node.forced && !node.virtualGround)
+                {
+                    node.unknown = unknowns++;
+                    unknownNode.push_back(i);
+                }
+                if (!node.forced && !node.ampOutput)
+                    node.row = rows++;
+            }
+
+            if (unknowns != rows)
+                throw std::logic_error("NetlistCircuit: the circuit has " + std::to_string(unknowns) + " unknowns but " + std::to_string(rows) + " equations.");
+
+            for (Capacitor& c : capacitors)
+            {
+                c.rowA = nodes[c.a].row;
+                c.rowB = nodes[c.b].row;
+            }
+
+            n = unknowns;
+            rhs.assign(n, 0.0);
+            solution.assign(n, 0.0);
+            delta.assign(nodes.size(), 0.0);
+            locked = true;
+
+            // Size the scratch space for its largest use, so `update` never allocates memory.
+            const std::size_t count = nodes.size();
+            const std::size_t m = capacitors.size();
+            matrix.reserve(std::max({n * count, static_cast<std::size_t>(n * n), m * m}));
+            terms.reserve(n * count);
+            termEnd.reserve(n);
+            gatherTerms();
+            factorNormalEquations();
+
+            // Confirm that the circuit can be solved, at an arbitrary time step.
+            // This also sizes the factors, which are refactored in place from then on.
+            if (!refactor(factors, 1.0e-5) || !refactor(partial, 1.0e-5))
+                throw std::logic_error("NetlistCircuit: the circuit equations are singular.");
+            factorDt = 0.0;
+
+            initialize();
+        }
+
+        bool isLocked() const
+        {
+            return locked;
+        }
+
+        void initialize()
+        {
+            // Discharge every capacitor: all free nodes return to zero volts.
+            for (int i = 0; i < static_cast<int>(nodes.size()); ++i)
+                if (!nodes[i].forced)
+                    voltage[i] = 0.0;
+            for (Capacitor& c : capacitors)
+                c.current = 0.0;
+            updateComparatorOutputs();
+            currentsValid = false;
+        }
+
+        int nodeCount() const
+        {
+            return static_cast<int>(nodes.size());
+        }
+
+        int unknownCount() const
+        {
+            return n;
+        }
+
+        int resistorCount() const
+        {
+            return static_cast<int>(resistors.size());
+        }
+
+        int capacitorCount() const
+        {
+            return static_cast<int>(capacitors.size());
+        }
+
+        int linearAmpCount() const
+        {
+            return static_cast<int>(ampNeg.size());
+        }
+
+        int comparatorCount() const
+        {
+            return static_cast<int>(comparators.size());
+        }
+
+        int factorNonzeroCount() const
+        {
+            return factors.nonzeroCount();
+        }
+
+        double nodeVoltage(int nodeIndex) const
+        {
+            return voltage.at(nodeIndex);
+        }
+
+        void setNodeVoltage(int nodeIndex, double nodeVoltage)
+        {
+            // Sets the voltage of a free node, for example to give a capacitor an initial charge.
+            // The next update first finds capacitor currents consistent with the new voltages.
+            const Node& node = nodes.at(validNode(nodeIndex));
+            if (node.forced)
+                throw std::logic_error("NetlistCircuit: use setForcedVoltage to change a forced node.");
+            if (node.virtualGround)
+                throw std::logic_error("NetlistCircuit: a linear amp's negative input is always at zero volts.");
+            voltage[nodeIndex] = nodeVoltage;
+            currentsValid = false;
+        }
+
+        void setForcedVoltage(int nodeIndex, double forcedVoltage)
+        {
+            // Changes an input voltage. Cheap enough to call on every sample.
+            voltage[nodeIndex] = forcedVoltage;
+        }
+
+        double resistance(int resistorIndex) const
+        {
+            return resistors.at(resistorIndex).resistance;
+        }
+
+        void setResistance(int resistorIndex, double ohms)
+        {
+            // Changes a resistor, for example a potentiometer.
+            // The matrix is refactored on the next update, but only if the value changed.
+            Resistor& r = resistors.at(resistorIndex);
+            if (ohms != r.resistance)
+            {
+                r.resistance = ohms;
+                factorDt = 0.0;
+            }
+        }
+
+        NetlistStateSpace stateSpace() const
+        {
+            // Derives the state equations by replacing each capacitor with a voltage source
+            // equal to its state, and solving the resistor network for the capacitor currents
+            // and node voltages once for each column of [s, u, q].
+            // The unknowns are the n voltages and then the m capacitor currents.
+            if (!locked)
+                throw std::logic_error("NetlistCircuit: lock the circuit before deriving its state equations.");
+
+            NetlistStateSpace ss;
+            const int count = static_cast<int>(nodes.size());
+            const int m = static_cast<int>(capacitors.size());
+            ss.states = m;
+            for (const Capacitor& c : capacitors)
+            {
+                if (nodes[c.a].unknown < 0 && nodes[c.b].unknown < 0)
+                    throw std::logic_error("NetlistCircuit: a capacitor between two known voltages has no state.");
+                ss.capacitorA.push_back(c.a);
+                ss.capacitorB.push_back(c.b);
+            }
+
+            std::vector<int> column(count, -1);     // the column of each input or comparator output node
+            for (int i = 0; i < count; ++i)
+            {
+                if (nodes[i].forced && !nodes[i].ground && !isComparatorOutput(i))
+                {
+                    column[i] = m + ss.inputs++;
+                    ss.inputNode.push_back(i);
+                }
+            }
+
+            for (const Comparator& k : comparators)
+            {
+                column[k.out] = m + ss.inputs + ss.comparators++;
+                ss.comparatorNeg.push_back(k.neg);
+                ss.comparatorLow.push_back(k.low);
+                ss.comparatorHigh.push_back(k.high);
+            }
+
+            // Each equation is a row of coefficients for every node, plus the capacitor currents.
+            const int size = n + m;
+            const int cols = ss.columns();
+            std::vector<double> coef(size * count, 0.0);
+            std::vector<double> a(size * size, 0.0);
+            std::vector<double> rhs(size * cols, 0.0);
+            for (const Resistor& r : resistors)
+            {
+                const double g = 1.0 / r.resistance;
+                if (nodes[r.a].row >= 0)
+                {
+                    coef[nodes[r.a].row*count + r.a] += g;
+                    coef[nodes[r.a].row*count + r.b] -= g;
+                }
+                if (nodes[r.b].row >= 0)
+                {
+                    coef[nodes[r.b].row*count + r.b] += g;
+                    coef[nodes[r.b].row*count + r.a] -= g;
+                }
+            }
+
+            for (int c = 0; c < m; ++c)
+            {
+                const Capacitor& cap = capacitors[c];
+                if (cap.rowA >= 0) a[cap.rowA*size + n + c] += 1.0;
+                if (cap.rowB >= 0) a[cap.rowB*size + n + c] -= 1.0;
+                coef[(n + c)*count + cap.a] += 1.0;
+                coef[(n + c)*count + cap.b] -= 1.0;
+                rhs[(n + c)*cols + c] = 1.0;
+            }
+
+            // Move the known voltages to the right-hand side.
+            for (int row = 0; row < size; ++row)
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    const double g = coef[row*count + i];
+                    if (g == 0.0)
+                        continue;
+                    if (nodes[i].unknown >= 0)
+                        a[row*size + nodes[i].unknown] += g;
+                    else if (column[i] >= 0)
+                        rhs[row*cols + column[i]] -= g;
+                }
+            }
+
+            NetlistFactors f;
+            if (!f.factor(a, size))
+                throw std::logic_error("NetlistCircuit: the capacitor voltages do not determine the circuit, so it has no state equations.");
+
+            ss.D.assign(m * cols, 0.0);
+            ss.V.assign(count * cols, 0.0);
+            std::vector<double> b(size);
+            std::vector<double> x(size);
+            for (int j = 0; j < cols; ++j)
+            {
+                for (int row = 0; row < size; ++row)
+                    b[row] = rhs[row*cols + j];
+                f.solve(b.data(), x.data());
+
+                for (int c = 0; c < m; ++c)
+                    ss.D[c*cols + j] = x[n + c] / capacitors[c].capacitance;
+
+                for (int i = 0; i < count; ++i)
+                {
+                    if (nodes[i].unknown >= 0)
+                        ss.V[i*cols + j] = x[nodes[i].unknown];
+                    else if (column[i] == j)
+                        ss.V[i*cols + j] = 1.0;
+                }
+            }
+            return ss;
+        }
+
+        int update(float sampleRateHz)
+        {
+            // Advances the circuit by one sample.
+            // Returns the number of linear solves needed: 1, or 3 when a comparator
+            // toggled inside the time step and the step was split at the crossing.
+            if (!locked)
+                lock();
+
+            const double dt = 1.0 / sampleRateHz;
+            if (dt != factorDt)
+            {
+                gatherTerms();
+                refactor(factors, dt);
+                factorDt = dt;
+            }
+
+            if (!currentsValid)
+                settleCurrents();
+
+            step(factors);
+
+            // Find the earliest comparator crossing inside the time step, if any.
+            double alpha = 1.0;
+            int crossing = -1;
+            for (int k = 0; k < static_cast<int>(comparators.size()); ++k)
+            {
+                const Comparator& c = comparators[k];
+                const double v1 = voltage[c.neg];
+                const double v2 = v1 + delta[c.neg];
+                if (compare(c, v2) != compare(c, v1))
+                {
+                    const double fraction = v1 / (v1 - v2);
+                    if (fraction < alpha)
+                    {
+                        alpha = fraction;
+                        crossing = k;
+                    }
+                }
+            }
+
+            if (crossing < 0 || !(alpha > 0.0 && alpha < 1.0))
+            {
+                commit(dt);
+                updateComparatorOutputs();
+                return 1;
+            }
+
+            // Simulate up to the crossing, toggle the comparator, then simulate the rest of the step.
+            // Any other comparator that toggles in the second part waits for the next step.
+            const double dt1 = alpha * dt;
+            refactor(partial, dt1);
+            step(partial);
+            commit(dt1);
+            const Comparator& c = comparators[crossing];
+            voltage[c.out] = (voltage[c.out] == c.high) ? c.low : c.high;
+
+            const double dt2 = dt - dt1;
+            refactor(partial, dt2);
+            step(partial);
+            commit(dt2);
+            updateComparatorOutputs();
+            return 3;
+        }
+    };
+
+    // The Sloth schematic expressed as a netlist, following fossil/torpor_sloth_circuit.hpp.
+    // The component values and variant come from params_t (see TorporParameters).
+    // Time dilation shrinks every capacitor by the same factor, which has the same
+    // effect as the scaled time step in SlothCircuit.hpp.
+    template <typename params_t>
+    class SlothNetlist : public NetlistCircuit
+    {
+    private:
+        int knobResistor;
+        int cvNode;
+        int xNode;
+        int wNode;
+        int yNode;
+        int zNode;
+
+    public:
+        SlothNetlist()
+        {
+            int ng = createGroundNode();
+            int n1 = createNode();
+            int n2 = createNode();
+            int n3 = createNode();
+            int n4 = createNode();
+            int n5 = createNode();
+            int n6 = createNode();
+            int n7 = createNode();
+            int n8 = createNode();
+            int n9 = createForcedVoltageNode(0.0);   // CV input node
+
+            addLinearAmp(n1, n2);       // U3
+            addLinearAmp(n4, n5);       // U4
+            addLinearAmp(n6, n7);       // U2
+            addComparator(n7, n8);      // U1
+
+            addResistor(params_t::R1, n1, n7);
+            addResistor(params_t::R2, n1, n8);
+            knobResistor = addResistor(params_t::knobResistance(0.0), n1, n3);   // R3 + R9
+            addResistor(params_t::R4, n6, n7);
+            addResistor(params_t::R5, n5, n6);
+            addResistor(params_t::R6, n2, n3);
+            addResistor(params_t::R7, n3, n4);
+            addResistor(params_t::R8, n9, n6);
+
+            addCapacitor(params_t::C1 / params_t::timeDilation, n1, n2);
+            addCapacitor(params_t::C2 / params_t::timeDilation, n4, n5);
+            addCapacitor(params_t::C3 / params_t::timeDilation, n3, ng);
+
+            lock();
+
+            cvNode = n9;
+            xNode = n2;
+            wNode = n3;
+            yNode = n5;
+            zNode = n7;
+            initialize();
+        }
+
+        void initialize()
+        {
+            NetlistCircuit::initialize();
+            setNodeVoltage(wNode, params_t::w0);
+        }
+
+        void setKnobPosition(double fraction)
+        {
+            setResistance(knobResistor, params_t::knobResistance(fraction));
+        }
+
+        void setControlVoltage(double cv)
+        {
+            setForcedVoltage(cvNode, params_t::clampControlVoltage(cv));
+        }
+
+        int cvNodeIndex() const
+        {
+            return cvNode;
+        }
+
+        int xNodeIndex() const
+        {
+            return xNode;
+        }
+
+        int wNodeIndex() const
+        {
+            return wNode;
+        }
+
+        int yNodeIndex() const
+        {
+            return yNode;
+        }
+
+        int zNodeIndex() const
+        {
+            return zNode;
+        }
+
+        double xVoltage() const
+        {
+            return nodeVoltage(xNode);
+        }
+
+        double wVoltage() const
+        {
+            return nodeVoltage(wNode);
+        }
+
+        double yVoltage() const
+        {
+            return nodeVoltage(yNode);
+        }
+
+        double zVoltage() const
+        {
+            return nodeVoltage(zNode);
+        }
+    };
+}
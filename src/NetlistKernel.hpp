@@ -0,0 +1,444 @@
+/*
+    NetlistKernel.hpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Generates the C++ source code of a specialized update kernel for a netlist.
+
+    The generator derives the circuit's state equations from the netlist
+    (see NetlistCircuit::stateSpace), the same way the README derives the
+    Sloth equations by hand. It then writes a class whose `update` uses the same
+    midpoint solver as SlothCircuit, with every coefficient a compile-time
+    constant and every sum written out term by term. Terms whose coefficients
+    are zero are left out. The result runs as fast as a hand-derived
+    simulation, with no netlist to traverse at run time.
+
+    The component values are fixed when the kernel is generated, so a
+    potentiometer is frozen at its netlist value. Run the generator again for
+    each component variant, or use NetlistCircuit for a live resistance.
+    The inputs (forced voltages other than ground) can change on every sample,
+    and an input's setter can clamp it to a range, as the Sloth kernels
+    clamp their control voltage to the supply rails.
+
+    See kernelgen.cpp, which generates SlothKernels.hpp.
+*/
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "NetlistCircuit.hpp"
+
+namespace Analog
+{
+    struct NetlistKernelPort
+    {
+        std::string name;   // the name of the generated accessor
+        int node;           // the netlist node it reads or writes
+        bool clamped = false;       // whether an input setter limits its voltage to [minVoltage, maxVoltage]
+        double minVoltage = 0.0;
+        double maxVoltage = 0.0;
+    };
+
+
+    struct NetlistKernelSpec
+    {
+        std::string className;
+        std::string description;                    // a one-line comment above the class
+        std::vector<NetlistKernelPort> inputs;      // setters; every input of the netlist must be listed
+        std::vector<NetlistKernelPort> outputs;     // node voltage getters
+    };
+
+
+    inline std::string NetlistKernelLiteral(double value)
+    {
+        // Format a double so that it reads back exactly, and is always a double literal.
+        char text[40];
+        std::snprintf(text, sizeof(text), "%.17g", value);
+        std::string s = text;
+        if (s.find_first_of(".e") == std::string::npos)
+            s += ".0";
+        return s;
+    }
+
+
+    class NetlistKernelWriter
+    {
+    private:
+        const NetlistStateSpace ss;
+        const NetlistKernelSpec& spec;
+        std::vector<std::string> column;    // the kernel's name for each variable in [s, u, q]
+        std::string code;
+
+        void line(const std::string& text)
+        {
+            code += (text.empty() ? "" : "    ") + text + "\n";
+        }
+
+        static std::string name(const char *prefix, int index)
+        {
+            return prefix + std::to_string(index);
+        }
+
+        static std::string name(const char *prefix, int row, int col)
+        {
+            return prefix + std::to_string(row) + "_" + std::to_string(col);
+        }
+
+        static std::string sum(const std::vector<std::string>& terms)
+        {
+            if (terms.empty())
+                return "0.0";
+            std::string s = terms[0];
+            for (size_t i = 1; i < terms.size(); ++i)
+                s += " + " + terms[i];
+            return s;
+        }
+
+        static std::string linear(const std::vector<std::pair<double, std::string>>& terms)
+        {
+            // Writes the sum of coefficient*variable terms, with the signs folded in.
+            if (terms.empty())
+                return "0.0";
+            std::string s;
+            for (size_t i = 0; i < terms.size(); ++i)
+            {
+                double coef = terms[i].first;
+                if (i > 0)
+                {
+                    s += (coef < 0) ? " - " : " + ";
+                    coef = std::abs(coef);
+                }
+                if (coef == 1.0)
+                    s += terms[i].second;
+                else if (coef == -1.0)
+                    s += "-" + terms[i].second;
+                else
+                    s += NetlistKernelLiteral(coef) + "*" + terms[i].second;
+            }
+            return s;
+        }
+
+        std::string voltage(int node, bool atEnd) const
+        {
+            // The voltage of a node as a linear function of [s, u, q].
+            // At the end of the step, each state is written as its start value plus its change.
+            std::vector<std::pair<double, std::string>> terms;
+            for (int j = 0; j < ss.columns(); ++j)
+            {
+                const double v = ss.voltage(node, j);
+                if (v == 0.0)
+                    continue;
+                std::string var = column[j];
+                if (j < ss.states && atEnd)
+                    var = "(" + var + " + " + name("ds", j) + ")";
+                else if (j >= ss.comparatorColumn(0))
+                    var = var + "()";
+                terms.push_back(std::make_pair(v, var));
+            }
+            return linear(terms);
+        }
+
+        bool hasInputTerms(int state) const
+        {
+            for (int j = ss.inputColumn(0); j < ss.comparatorColumn(0); ++j)
+                if (ss.derivative(state, j) != 0.0)
+                    return true;
+            return false;
+        }
+
+        void check()
+        {
+            if (static_cast<int>(spec.inputs.size()) != ss.inputs)
+                throw std::logic_error("NetlistKernelWriter: the netlist has " + std::to_string(ss.inputs) + " inputs, but " + std::to_string(spec.inputs.size()) + " were named.");
+
+            for (int k = 0; k < ss.comparators; ++k)
+                for (int j = 0; j < ss.comparators; ++j)
+                    if (ss.voltage(ss.comparatorNeg[k], ss.comparatorColumn(j)) != 0.0)
+                        throw std::logic_error("NetlistKernelWriter: a comparator's input depends directly on a comparator output.");
+        }
+
+    public:
+        NetlistKernelWriter(const NetlistCircuit& circuit, const NetlistKernelSpec& _spec)
+            : ss(circuit.stateSpace())
+            , spec(_spec)
+        {
+            column.resize(ss.columns());
+            for (int i = 0; i < ss.states; ++i)
+                column[i] = name("s", i);
+
+            for (int j = 0; j < ss.inputs; ++j)
+            {
+                int found = -1;
+                for (int p = 0; p < static_cast<int>(spec.inputs.size()); ++p)
+                    if (spec.inputs[p].node == ss.inputNode[j])
+                        found = p;
+                if (found < 0)
+                    throw std::logic_error("NetlistKernelWriter: input node " + std::to_string(ss.inputNode[j]) + " was not named.");
+                column[ss.inputColumn(j)] = name("u", j);
+            }
+
+            for (int k = 0; k < ss.comparators; ++k)
+                column[ss.comparatorColumn(k)] = name("q", k);
+
+            check();
+            write(circuit);
+        }
+
+        const std::string& source() const
+        {
+            return code;
+        }
+
+    private:
+        void write(const NetlistCircuit& circuit)
+        {
+            const int cols = ss.columns();
+            line("// " + spec.description);
+            line("// State variables are capacitor voltages:");
+            for (int i = 0; i < ss.states; ++i)
+                line("//     s" + std::to_string(i) + " = v[" + std::to_string(ss.capacitorA[i]) + "] - v[" + std::to_string(ss.capacitorB[i]) + "]");
+            line("class " + spec.className);
+            line("{");
+            line("private:");
+            line("    // The state equations: ds/dt = D [s, u, q].");
+            for (int i = 0; i < ss.states; ++i)
+                for (int j = 0; j < cols; ++j)
+                    if (ss.derivative(i, j) != 0.0)
+                        line("    static constexpr double " + name("D", i, j) + " = " + NetlistKernelLiteral(ss.derivative(i, j)) + ";");
+            line("");
+
+            line("    float coefSampleRateHz = 0.0f;");
+            for (int i = 0; i < ss.states; ++i)
+                for (int j = 0; j < cols; ++j)
+                    if (ss.derivative(i, j) != 0.0)
+                        line("    double " + name("d", i, j) + "{};     // dt * " + name("D", i, j));
+            for (int i = 0; i < ss.states; ++i)
+                line("    double " + name("s", i) + "{};");
+            for (int j = 0; j < ss.inputs; ++j)
+                line("    double " + name("u", j) + "{};");
+            line("");
+
+            for (int k = 0; k < ss.comparators; ++k)
+            {
+                line("    static double " + name("Q", k) + "(double v)");
+                line("    {");
+                line("        return (v < 0) ? " + NetlistKernelLiteral(ss.comparatorHigh[k]) + " : " + NetlistKernelLiteral(ss.comparatorLow[k]) + ";");
+                line("    }");
+                line("");
+                line("    double " + name("v", k) + "() const");
+                line("    {");
+                line("        return " + voltage(ss.comparatorNeg[k], false) + ";");
+                line("    }");
+                line("");
+                line("    double " + name("q", k) + "() const");
+                line("    {");
+                line("        return " + name("Q", k) + "(" + name("v", k) + "());");
+                line("    }");
+                line("");
+            }
+
+            line("    void calculate(double dt)");
+            line("    {");
+            for (int i = 0; i < ss.states; ++i)
+                for (int j = 0; j < cols; ++j)
+                    if (ss.derivative(i, j) != 0.0)
+                        line("        " + name("d", i, j) + " = dt * " + name("D", i, j) + ";");
+            line("    }");
+            line("");
+
+            line("public:");
+            line("    static constexpr double tolerance = 1.0e-12;");
+            line("    int iterationLimit = 5;");
+            line("");
+            line("    " + spec.className + "()");
+            line("    {");
+            line("        initialize();");
+            line("    }");
+            line("");
+            line("    void initialize()");
+            line("    {");
+            for (int i = 0; i < ss.states; ++i)
+                line("        " + name("s", i) + " = " + NetlistKernelLiteral(circuit.nodeVoltage(ss.capacitorA[i]) - circuit.nodeVoltage(ss.capacitorB[i])) + ";");
+            for (int j = 0; j < ss.inputs; ++j)
+                line("        " + name("u", j) + " = " + NetlistKernelLiteral(circuit.nodeVoltage(ss.inputNode[j])) + ";");
+            line("    }");
+
+            for (const NetlistKernelPort& p : spec.inputs)
+            {
+                int j = 0;
+                while (ss.inputNode[j] != p.node)
+                    ++j;
+                line("");
+                line("    void " + p.name + "(double voltage)");
+                line("    {");
+                if (p.clamped)
+                    line("        " + name("u", j) + " = std::max(" + NetlistKernelLiteral(p.minVoltage) + ", std::min(" + NetlistKernelLiteral(p.maxVoltage) + ", voltage));");
+                else
+                    line("        " + name("u", j) + " = voltage;");
+                line("    }");
+            }
+
+            for (const NetlistKernelPort& p : spec.outputs)
+            {
+                line("");
+                line("    double " + p.name + "() const");
+                line("    {");
+                line("        return " + voltage(p.node, false) + ";");
+                line("    }");
+            }
+
+            writeUpdate();
+            line("};");
+        }
+
+        void writeUpdate()
+        {
+            // The midpoint solver from SlothSolver::solve, written out for this circuit.
+            line("");
+            line("    int update(float sampleRateHz)");
+            line("    {");
+            line("        // Advances the circuit by one sample.");
+            line("        // Returns the number of iterations needed for convergence [2..iterationLimit].");
+            line("        if (sampleRateHz != coefSampleRateHz)");
+            line("        {");
+            line("            calculate(1.0 / sampleRateHz);");
+            line("            coefSampleRateHz = sampleRateHz;");
+            line("        }");
+            line("");
+            line("        // The inputs are constant over the time step.");
+            for (int i = 0; i < ss.states; ++i)
+            {
+                if (!hasInputTerms(i))
+                    continue;
+                std::vector<std::string> terms;
+                for (int j = ss.inputColumn(0); j < ss.comparatorColumn(0); ++j)
+                    if (ss.derivative(i, j) != 0.0)
+                        terms.push_back(name("d", i, j) + "*" + column[j]);
+                line("        const double " + name("f", i) + " = " + sum(terms) + ";");
+            }
+            for (int k = 0; k < ss.comparators; ++k)
+                line("        const double " + name("vs", k) + " = " + name("v", k) + "();");
+            line("");
+            line("        // Start with crude estimates that the voltages remain constant over the time step.");
+            for (int i = 0; i < ss.states; ++i)
+                line("        double " + name("sm", i) + " = " + name("s", i) + ";");
+            for (int k = 0; k < ss.comparators; ++k)
+                line("        double " + name("qm", k) + " = " + name("Q", k) + "(" + name("vs", k) + ");");
+            for (int i = 0; i < ss.states; ++i)
+                line("        double " + name("e", i) + " = 0.0;");
+            line("");
+            line("        const double toleranceSquared = tolerance * tolerance;");
+            line("        for (int iter = 1; true; ++iter)");
+            line("        {");
+            for (int i = 0; i < ss.states; ++i)
+            {
+                std::vector<std::string> terms;
+                for (int j = 0; j < ss.states; ++j)
+                    if (ss.derivative(i, j) != 0.0)
+                        terms.push_back(name("d", i, j) + "*" + name("sm", j));
+                if (hasInputTerms(i))
+                    terms.push_back(name("f", i));
+                for (int k = 0; k < ss.comparators; ++k)
+                    if (ss.derivative(i, ss.comparatorColumn(k)) != 0.0)
+                        terms.push_back(name("d", i, ss.comparatorColumn(k)) + "*" + name("qm", k));
+                line("            const double " + name("ds", i) + " = " + sum(terms) + ";");
+            }
+            for (int k = 0; k < ss.comparators; ++k)
+                line("            const double " + name("ve", k) + " = " + voltage(ss.comparatorNeg[k], true) + ";");
+            line("");
+            line("            if (iter > 1)");
+            line("            {");
+            {
+                std::vector<std::string> terms;
+                for (int i = 0; i < ss.states; ++i)
+                    terms.push_back("(" + name("ds", i) + " - " + name("e", i) + ")*(" + name("ds", i) + " - " + name("e", i) + ")");
+                line("                const double variance = " + sum(terms) + ";");
+            }
+            line("                if (variance < toleranceSquared || iter >= iterationLimit)");
+            line("                {");
+            for (int i = 0; i < ss.states; ++i)
+                line("                    " + name("s", i) + " += " + name("ds", i) + ";");
+            line("                    return iter;");
+            line("                }");
+            line("            }");
+            line("");
+            for (int i = 0; i < ss.states; ++i)
+                line("            " + name("sm", i) + " = " + name("s", i) + " + " + name("ds", i) + "/2;");
+            for (int k = 0; k < ss.comparators; ++k)
+            {
+                const std::string vs = name("vs", k);
+                const std::string ve = name("ve", k);
+                const std::string Q = name("Q", k);
+                line("            if (" + vs + " * " + ve + " >= 0)");
+                line("            {");
+                line("                " + name("qm", k) + " = " + Q + "((" + vs + " + " + ve + ")/2);");
+                line("            }");
+                line("            else");
+                line("            {");
+                line("                const double alpha = " + vs + " / (" + vs + " - " + ve + ");");
+                line("                " + name("qm", k) + " = alpha*" + Q + "(" + vs + ") + (1-alpha)*" + Q + "(" + ve + ");");
+                line("            }");
+            }
+            for (int i = 0; i < ss.states; ++i)
+                line("            " + name("e", i) + " = " + name("ds", i) + ";");
+            line("        }");
+            line("    }");
+        }
+    };
+
+
+    inline std::string GenerateNetlistKernel(const NetlistCircuit& circuit, const NetlistKernelSpec& spec)
+    {
+        // Returns the source code of a class that simulates the locked netlist `circuit`.
+        // Throws std::logic_error if the netlist has no state equations the kernel can use.
+        NetlistKernelWriter writer(circuit, spec);
+        return writer.source();
+    }
+
+
+    template <typename params_t>
+    std::string GenerateSlothKernel(const char *variant)
+    {
+        // The knob is frozen at its default position of 0.
+        SlothNetlist<params_t> netlist;
+        NetlistKernelSpec spec;
+        spec.className = std::string(variant) + "Kernel";
+        spec.description = "Generated from SlothNetlist<" + std::string(variant) + "Parameters> with the knob at 0.";
+        // The control voltage is clamped to the supply rails, as SlothNetlist does.
+        spec.inputs.push_back(NetlistKernelPort{"setControlVoltage", netlist.cvNodeIndex(), true, params_t::VNEG, params_t::VPOS});
+        spec.outputs.push_back(NetlistKernelPort{"xVoltage", netlist.xNodeIndex()});
+        spec.outputs.push_back(NetlistKernelPort{"wVoltage", netlist.wNodeIndex()});
+        spec.outputs.push_back(NetlistKernelPort{"yVoltage", netlist.yNodeIndex()});
+        spec.outputs.push_back(NetlistKernelPort{"zVoltage", netlist.zNodeIndex()});
+        return GenerateNetlistKernel(netlist, spec);
+    }
+
+
+    inline std::string GenerateSlothKernels()
+    {
+        // The source code of SlothKernels.hpp.
+        std::string code =
+            "/*\n"
+            "    SlothKernels.hpp  -  generated by kernelgen.cpp. Do not edit.\n"
+            "\n"
+            "    Update kernels for the Sloth variants, derived from their netlists.\n"
+            "    Run the script `kg` to regenerate this file.\n"
+            "*/\n"
+            "#pragma once\n"
+            "\n"
+            "#include <algorithm>\n"
+            "\n"
+            "namespace Analog\n"
+            "{\n";
+
+        code += GenerateSlothKernel<TorporParameters>("Torpor");
+        code += "\n\n";
+        code += GenerateSlothKernel<ApathyParameters>("Apathy");
+        code += "\n\n";
+        code += GenerateSlothKernel<InertiaParameters>("Inertia");
+        code += "}\n";
+        return code;
+    }
+}
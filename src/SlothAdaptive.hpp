@@ -0,0 +1,372 @@
+/*
+    SlothAdaptive.hpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    An adaptive step-size simulation of the Sloth circuit, intended for
+    offline rendering of long trajectories. It integrates the differential
+    equations with the Dormand-Prince 5(4) embedded Runge-Kutta pair,
+    taking large steps while the trajectory is smooth.
+
+    The comparator output Q is held constant inside each step.
+    When the voltage z changes polarity, the exact time of the zero crossing
+    is found by root-finding on the step's continuous (dense) output,
+    the step is cut short there, and integration resumes with the new Q.
+
+    Output samples at any sample rate are interpolated from the dense
+    output of the step that contains each sample time.
+*/
+#pragma once
+
+#include "SlothCircuit.hpp"
+
+namespace Analog
+{
+    struct AdaptiveStats
+    {
+        long acceptedSteps = 0;
+        long rejectedSteps = 0;
+        long crossings = 0;
+    };
+
+
+    template <typename circuit_t>
+    class AdaptiveSlothCircuit : protected SlothComponents
+    {
+    private:
+        circuit_t circuit;      // supplies the variant parameters and the initial state
+
+        double absTolerance = 1.0e-9;   // volts
+        double relTolerance = 1.0e-9;
+        double maxStep = 0.05;          // circuit seconds; keeps steps short enough not to miss a pair of crossings
+
+        // Coefficients with a time step of one circuit second give the rate of change of each voltage.
+        SlothCoefficients rate;
+        double K{};
+        double U{};
+
+        // The state at the start of the current step.
+        double s0[3]{};         // (x, w, y)
+        double f0[3]{};         // derivatives at s0
+        double q{};             // comparator output for the current step
+        double t0 = 0.0;        // circuit time at s0
+
+        // The accepted step [t0, t1] and its dense output coefficients.
+        bool haveStep = false;
+        double h = 0.0;         // full length of the step that produced the dense output
+        double t1 = 0.0;        // end of the valid part of the step (earlier than t0+h after a crossing)
+        double dense[5][3]{};
+        double s1[3]{};
+        double f1[3]{};
+        double q1{};
+
+        double nextStep = 1.0e-4;   // suggested length of the next step
+        double time = 0.0;          // circuit time of the most recently emitted sample
+        double out[4]{};            // (x, w, y, z) at `time`
+
+        AdaptiveStats stats;
+
+        void derivatives(const double s[3], double qv, double ds[3]) const
+        {
+            const double z = rate.zy*s[2] + rate.z0;
+            ds[0] = rate.xz*z + rate.xq*qv + rate.xw*s[1];
+            ds[1] = rate.wx*s[0] + rate.ww*s[1];
+            ds[2] = rate.yw*s[1];
+        }
+
+        double zOf(const double s[3]) const
+        {
+            return rate.zy*s[2] + rate.z0;
+        }
+
+        void denseState(double theta, double s[3]) const
+        {
+            // Evaluate the continuous extension of the step at the fraction theta.
+            const double u = 1.0 - theta;
+            for (int i = 0; i < 3; ++i)
+                s[i] = dense[0][i] + theta*(dense[1][i] + u*(dense[2][i] + theta*(dense[3][i] + u*dense[4][i])));
+        }
+
+        void restart()
+        {
+            // Begin a new step at the current state, with fresh derivatives.
+            q = Q(zOf(s0));
+            derivatives(s0, q, f0);
+            haveStep = false;
+        }
+
+        void takeStep()
+        {
+            // Dormand-Prince 5(4) coefficients.
+            const double a21 = 1.0/5.0;
+            const double a31 = 3.0/40.0, a32 = 9.0/40.0;
+            const double a41 = 44.0/45.0, a42 = -56.0/15.0, a43 = 32.0/9.0;
+            const double a51 = 19372.0/6561.0, a52 = -25360.0/2187.0, a53 = 64448.0/6561.0, a54 = -212.0/729.0;
+            const double a61 = 9017.0/3168.0, a62 = -355.0/33.0, a63 = 46732.0/5247.0, a64 = 49.0/176.0, a65 = -5103.0/18656.0;
+            const double b1 = 35.0/384.0, b3 = 500.0/1113.0, b4 = 125.0/192.0, b5 = -2187.0/6784.0, b6 = 11.0/84.0;
+            const double e1 = 71.0/57600.0, e3 = -71.0/16695.0, e4 = 71.0/1920.0, e5 = -17253.0/339200.0, e6 = 22.0/525.0, e7 = -1.0/40.0;
+
+            // Dense output coefficients (Hairer, Norsett & Wanner).
+            const double d1 = -12715105075.0/11282082432.0, d3 = 87487479700.0/32700410799.0, d4 = -10690763975.0/1880347072.0;
+            const double d5 = 701980252875.0/199316789632.0, d6 = -1453857185.0/822651844.0, d7 = 69997945.0/29380423.0;
+
+            double k2[3], k3[3], k4[3], k5[3], k6[3], k7[3];
+            double s[3], y5[3];
+
+            double step = std::min(nextStep, maxStep);
+            while (true)
+            {
+                for (int i = 0; i < 3; ++i) s[i] = s0[i] + step*(a21*f0[i]);
+                derivatives(s, q, k2);
+                for (int i = 0; i < 3; ++i) s[i] = s0[i] + step*(a31*f0[i] + a32*k2[i]);
+                derivatives(s, q, k3);
+                for (int i = 0; i < 3; ++i) s[i] = s0[i] + step*(a41*f0[i] + a42*k2[i] + a43*k3[i]);
+                derivatives(s, q, k4);
+                for (int i = 0; i < 3; ++i) s[i] = s0[i] + step*(a51*f0[i] + a52*k2[i] + a53*k3[i] + a54*k4[i]);
+                derivatives(s, q, k5);
+                for (int i = 0; i < 3; ++i) s[i] = s0[i] + step*(a61*f0[i] + a62*k2[i] + a63*k3[i] + a64*k4[i] + a65*k5[i]);
+                derivatives(s, q, k6);
+                for (int i = 0; i < 3; ++i) y5[i] = s0[i] + step*(b1*f0[i] + b3*k3[i] + b4*k4[i] + b5*k5[i] + b6*k6[i]);
+                derivatives(y5, q, k7);
+
+                // Estimate the local error by comparing the 5th and 4th order solutions.
+                double errorNorm = 0.0;
+                for (int i = 0; i < 3; ++i)
+                {
+                    double e = step*(e1*f0[i] + e3*k3[i] + e4*k4[i] + e5*k5[i] + e6*k6[i] + e7*k7[i]);
+                    double scale = absTolerance + relTolerance*std::max(std::abs(s0[i]), std::abs(y5[i]));
+                    errorNorm = std::max(errorNorm, std::abs(e) / scale);
+                }
+
+                // Standard step size controller, limiting how fast the step can change.
+                double factor = (errorNorm == 0.0) ? 5.0 : std::max(0.2, std::min(5.0, 0.9 * std::pow(errorNorm, -0.2)));
+                if (errorNorm <= 1.0)
+                {
+                    ++stats.acceptedSteps;
+                    nextStep = std::min(step * factor, maxStep);
+                    break;
+                }
+
+                ++stats.rejectedSteps;
+                step *= std::max(0.2, factor);
+            }
+
+            // Build the dense output for the accepted step.
+            for (int i = 0; i < 3; ++i)
+            {
+                double ydiff = y5[i] - s0[i];
+                double bspl = step*f0[i] - ydiff;
+                dense[0][i] = s0[i];
+                dense[1][i] = ydiff;
+                dense[2][i] = bspl;
+                dense[3][i] = ydiff - step*k7[i] - bspl;
+                dense[4][i] = step*(d1*f0[i] + d3*k3[i] + d4*k4[i] + d5*k5[i] + d6*k6[i] + d7*k7[i]);
+                s1[i] = y5[i];
+                f1[i] = k7[i];
+            }
+            h = step;
+            t1 = t0 + step;
+            q1 = q;
+            haveStep = true;
+
+            // Did z change polarity during the step?
+            const double za = zOf(s0);
+            const double zb = zOf(s1);
+            if (Q(zb) != q)
+            {
+                // Find the crossing time with the Illinois variant of regula falsi.
+                double lo = 0.0, glo = za;
+                double hi = 1.0, ghi = zb;
+                double theta = 1.0;
+                int side = 0;
+                for (int iter = 0; iter < 60 && (hi - lo)*step > 1.0e-15; ++iter)
+                {
+                    theta = (lo*ghi - hi*glo) / (ghi - glo);
+                    double sc[3];
+                    denseState(theta, sc);
+                    double g = zOf(sc);
+                    if (g == 0.0)
+                        break;
+                    if ((g < 0.0) == (glo < 0.0))
+                    {
+                        lo = theta;
+                        glo = g;
+                        if (side == -1) ghi /= 2;
+                        side = -1;
+                    }
+                    else
+                    {
+                        hi = theta;
+                        ghi = g;
+                        if (side == +1) glo /= 2;
+                        side = +1;
+                    }
+                }
+
+                // Cut the step short at the crossing, and toggle the comparator.
+                ++stats.crossings;
+                denseState(theta, s1);
+                t1 = t0 + theta*step;
+                q1 = (q == QPOS) ? QNEG : QPOS;
+                derivatives(s1, q1, f1);
+            }
+        }
+
+        void advanceStep()
+        {
+            // Make the end of the current step the start of the next one.
+            for (int i = 0; i < 3; ++i)
+            {
+                s0[i] = s1[i];
+                f0[i] = f1[i];
+            }
+            q = q1;
+            t0 = t1;
+            takeStep();
+        }
+
+        void evaluate(double t)
+        {
+            // Move forward to circuit time t, and calculate the voltages there.
+            if (!haveStep)
+                takeStep();
+
+            while (t > t1)
+                advanceStep();
+
+            double s[3];
+            denseState((t - t0) / h, s);
+            time = t;
+            out[0] = s[0];
+            out[1] = s[1];
+            out[2] = s[2];
+            out[3] = zOf(s);
+        }
+
+        void synchronize()
+        {
+            // Discard any step that extends beyond the present,
+            // because the inputs are about to change.
+            for (int i = 0; i < 3; ++i)
+                s0[i] = out[i];
+            t0 = time;
+            rate.calculate(1.0, K, U);
+            restart();
+        }
+
+    public:
+        AdaptiveSlothCircuit()
+        {
+            K = circuit.variableResistance();
+            U = circuit.controlVoltage();
+            initialize();
+        }
+
+        void initialize()
+        {
+            circuit.initialize();
+            time = 0.0;
+            out[0] = circuit.xVoltage();
+            out[1] = circuit.wVoltage();
+            out[2] = circuit.yVoltage();
+            out[3] = circuit.zVoltage();
+            stats = AdaptiveStats();
+            synchronize();
+        }
+
+        SlothState saveState() const
+        {
+            return SlothState{out[0], out[1], out[2], out[3]};
+        }
+
+        void restoreState(const SlothState& state)
+        {
+            // Replace the node voltages, and resume integrating from there.
+            out[0] = state.x;
+            out[1] = state.w;
+            out[2] = state.y;
+            out[3] = state.z;
+            synchronize();
+        }
+
+        void setTolerance(double absoluteVolts, double relative)
+        {
+            absTolerance = absoluteVolts;
+            relTolerance = relative;
+            synchronize();
+        }
+
+        void setMaxStep(double circuitSeconds)
+        {
+            maxStep = circuitSeconds;
+            synchronize();
+        }
+
+        void setKnobPosition(double fraction)
+        {
+            double k = knobResistance(fraction);
+            if (k != K)
+            {
+                K = k;
+                circuit.setKnobPosition(fraction);
+                synchronize();
+            }
+        }
+
+        void setControlVoltage(double cv)
+        {
+            double u = clampControlVoltage(cv);
+            if (u != U)
+            {
+                U = u;
+                circuit.setControlVoltage(cv);
+                synchronize();
+            }
+        }
+
+        const AdaptiveStats& getStats() const
+        {
+            return stats;
+        }
+
+        double xVoltage() const
+        {
+            return out[0];
+        }
+
+        double wVoltage() const
+        {
+            return out[1];
+        }
+
+        double yVoltage() const
+        {
+            return out[2];
+        }
+
+        double zVoltage() const
+        {
+            return out[3];
+        }
+
+        void update(float sampleRateHz)
+        {
+            // Generates the next sample at the given sample rate.
+            evaluate(time + circuit.timeDilationFactor() / sampleRateHz);
+        }
+
+        void process(float sampleRateHz, int nSamples, float *xOutput, float *yOutput, float *zOutput)
+        {
+            // Generates a block of samples, like SlothCircuit::process.
+            // Each sample time is calculated from the start of the block,
+            // so rounding errors do not accumulate.
+            const double start = time;
+            const double dt = circuit.timeDilationFactor() / sampleRateHz;
+            for (int s = 0; s < nSamples; ++s)
+            {
+                evaluate(start + (s+1)*dt);
+                if (xOutput) xOutput[s] = static_cast<float>(out[0]);
+                if (yOutput) yOutput[s] = static_cast<float>(out[2]);
+                if (zOutput) zOutput[s] = static_cast<float>(out[3]);
+            }
+        }
+    };
+}
@@ -0,0 +1,156 @@
+/*
+    SlothAudio.hpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Renders a Sloth circuit as a stereo audio stream, with x on the left
+    channel and y on the right, for playing it through a sound card.
+
+    Audio callbacks run on a thread that must never wait, so the user
+    interface passes knob, CV, and volume changes through SlothParameter
+    slots. Each slot is a single lock-free atomic target value. The audio
+    thread reads the targets at the start of every short sub-block and moves
+    smoothly toward them, so a sudden jump of the knob or CV changes the
+    circuit gradually instead of making it click. The circuit coefficients
+    are recalculated once per sub-block, not once per sample.
+
+    Rendering never allocates memory, locks, or makes system calls.
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include "SlothCircuit.hpp"
+
+namespace Analog
+{
+    class SlothParameter
+    {
+    private:
+        std::atomic<float> target;
+        float current;
+
+        static_assert(std::atomic<float>::is_always_lock_free, "SlothParameter requires lock-free atomic floats.");
+
+    public:
+        explicit SlothParameter(float value)
+            : target(value)
+            , current(value)
+            {}
+
+        void set(float value)
+        {
+            // May be called from any thread.
+            target.store(value, std::memory_order_relaxed);
+        }
+
+        float get() const
+        {
+            // Returns the most recently requested value, which the audio thread may not have reached yet.
+            return target.load(std::memory_order_relaxed);
+        }
+
+        float value() const
+        {
+            // Audio thread only: the smoothed value currently in effect.
+            return current;
+        }
+
+        float next(float alpha)
+        {
+            // Audio thread only: move the fraction `alpha` of the remaining distance
+            // toward the target, and return the result.
+            const float t = target.load(std::memory_order_relaxed);
+            const float step = alpha * (t - current);
+            current = (std::abs(step) < 1.0e-7f * (1.0f + std::abs(t))) ? t : (current + step);
+            return current;
+        }
+
+        void snap()
+        {
+            // Audio thread only: jump straight to the target.
+            current = target.load(std::memory_order_relaxed);
+        }
+    };
+
+
+    template <typename circuit_t>
+    class SlothAudioVoice
+    {
+    public:
+        static const int SubBlockSize = 32;     // samples per parameter update
+
+    private:
+        circuit_t circuit;
+        float xBuffer[SubBlockSize];
+        float yBuffer[SubBlockSize];
+
+        float smoothingSeconds = 0.02f;
+        float alphaSampleRateHz = 0.0f;         // the sample rate `alpha` was calculated for
+        float alpha = 1.0f;                     // smoothing fraction per full sub-block
+
+    public:
+        // The user interface and the audio thread share these slots.
+        SlothParameter knob{0.0f};
+        SlothParameter controlVoltage{0.0f};
+        SlothParameter volume{1.0f / 12.0f};    // output units per volt; the circuit swings about +/- 12 V
+
+        circuit_t& internalCircuit()
+        {
+            // Allows the caller to configure the circuit, for example setIntegrator, before playback starts.
+            return circuit;
+        }
+
+        void setSmoothingTime(float seconds)
+        {
+            // The time constant for following parameter changes. Call before playback starts.
+            smoothingSeconds = std::max(0.0f, seconds);
+            alphaSampleRateHz = 0.0f;
+        }
+
+        void snapParameters()
+        {
+            // Jump straight to the requested parameter values.
+            // Call before playback starts, or from the audio thread.
+            knob.snap();
+            controlVoltage.snap();
+            volume.snap();
+            circuit.setKnobPosition(knob.value());
+            circuit.setControlVoltage(controlVoltage.value());
+        }
+
+        void render(float sampleRateHz, float *stereo, int nFrames)
+        {
+            // Audio thread only: fills `stereo` with `nFrames` interleaved (left, right) frames.
+
+            if (sampleRateHz != alphaSampleRateHz)
+            {
+                const float tau = smoothingSeconds * sampleRateHz;      // in samples
+                alpha = (tau > 0.0f) ? (1.0f - std::exp(-SubBlockSize / tau)) : 1.0f;
+                alphaSampleRateHz = sampleRateHz;
+            }
+
+            while (nFrames > 0)
+            {
+                const int n = std::min(nFrames, static_cast<int>(SubBlockSize));
+                const float a = (n == SubBlockSize) ? alpha : (1.0f - std::pow(1.0f - alpha, static_cast<float>(n) / SubBlockSize));
+                circuit.setKnobPosition(knob.next(a));
+                circuit.setControlVoltage(controlVoltage.next(a));
+                circuit.process(sampleRateHz, n, xBuffer, yBuffer, nullptr);
+
+                // Ramp the volume across the sub-block, so volume changes do not click.
+                const float g1 = volume.value();
+                const float g2 = volume.next(a);
+                const float dg = (g2 - g1) / n;
+                for (int i = 0; i < n; ++i)
+                {
+                    const float g = g1 + (i + 1) * dg;
+                    stereo[2*i]     = g * xBuffer[i];
+                    stereo[2*i + 1] = g * yBuffer[i];
+                }
+
+                stereo += 2*n;
+                nFrames -= n;
+            }
+        }
+    };
+}
@@ -0,0 +1,380 @@
+/*
+    SlothBank.hpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Simulates N independent Sloth circuits side by side.
+    The circuit state is stored as a structure of arrays, one array
+    element ("lane") per voice. The solver evaluates SlothVec::width
+    lanes per instruction using the SIMD wrapper in SlothSimd.hpp.
+
+    Each lane produces exactly the same voltages as a scalar
+    SlothCircuit with the same variant, knob, and CV settings,
+    provided FMA contraction is off (see SlothSimd.hpp).
+*/
+#pragma once
+
+#include "SlothCircuit.hpp"
+#include "SlothSimd.hpp"
+
+namespace Analog
+{
+    template <int N>
+    class SlothBank : protected SlothComponents
+    {
+        static_assert(N > 0, "A SlothBank must contain at least one voice.");
+
+    private:
+        // Round the number of lanes up to a whole number of SIMD vectors.
+        // The padding lanes are simulated but never converge or become visible.
+        static constexpr int W = SlothVec::width;
+        static constexpr int P = W * ((N + W - 1) / W);
+
+        // Variant parameters
+        alignas(64) double timeDilation[P];
+        alignas(64) double w0[P];
+
+        // Inputs
+        alignas(64) double K[P];
+        alignas(64) double U[P];
+
+        // Node voltages
+        alignas(64) double x1[P];
+        alignas(64) double w1[P];
+        alignas(64) double y1[P];
+        alignas(64) double z1[P];
+
+        // 1.0 for padding lanes, 0.0 for real voices.
+        alignas(64) double padding[P];
+
+        // Component values, and the comparator levels and z gain that depend on them.
+        SlothComponentValues parts[P];
+        alignas(64) double qneg[P];
+        alignas(64) double qpos[P];
+        alignas(64) double zy[P];
+
+        // Cached solver coefficients for each lane (see SlothCoefficients),
+        // valid for the sample rate `coefSampleRateHz`, or invalid if it is zero.
+        alignas(64) double xz[P];
+        alignas(64) double xq[P];
+        alignas(64) double xw[P];
+        alignas(64) double wx[P];
+        alignas(64) double ww[P];
+        alignas(64) double yw[P];
+        alignas(64) double z0[P];
+        float coefSampleRateHz = 0.0f;
+
+        void refreshCoefficients(int lane)
+        {
+            SlothCoefficients c;
+            c.calculate(timeDilation[lane] / coefSampleRateHz, K[lane], U[lane], parts[lane]);
+            xz[lane] = c.xz;
+            xq[lane] = c.xq;
+            xw[lane] = c.xw;
+            wx[lane] = c.wx;
+            ww[lane] = c.ww;
+            yw[lane] = c.yw;
+            z0[lane] = c.z0;
+        }
+
+        void refreshCoefficients(float sampleRateHz)
+        {
+            coefSampleRateHz = sampleRateHz;
+            for (int i = 0; i < P; ++i)
+                refreshCoefficients(i);
+        }
+
+        void laneChanged(int lane)
+        {
+            // Keep the lane's coefficients current, if we know the sample rate yet.
+            if (coefSampleRateHz != 0.0f)
+                refreshCoefficients(lane);
+        }
+
+        static SlothVec Q(SlothVec z, SlothVec pos, SlothVec neg)
+        {
+            // The comparator U1 output responds immediately to the voltage z.
+            // It is an inverting amplifier whose output is saturated.
+            return select(z < SlothVec::broadcast(0.0), pos, neg);
+        }
+
+        template <bool countIterations>
+        int solve(int base, int *laneIterations)
+        {
+            // This is the same algorithm as SlothCircuit::solve, applied to the
+            // SlothVec::width lanes starting at index `base`. Every arithmetic operation
+            // is performed in the same order as the scalar code, so the results match
+            // bit for bit. Branches are replaced by masked blends. A lane that has
+            // converged latches its result, but keeps riding along with the lanes
+            // that have not, until every lane has converged or the iteration limit is reached.
+
+            const SlothVec zero = SlothVec::broadcast(0.0);
+            const SlothVec half = SlothVec::broadcast(0.5);
+            const SlothVec one  = SlothVec::broadcast(1.0);
+
+            const SlothVec x = SlothVec::load(x1 + base);
+            const SlothVec w = SlothVec::load(w1 + base);
+            const SlothVec y = SlothVec::load(y1 + base);
+            const SlothVec z = SlothVec::load(z1 + base);
+
+            const SlothVec cxz = SlothVec::load(xz + base);
+            const SlothVec cxq = SlothVec::load(xq + base);
+            const SlothVec cxw = SlothVec::load(xw + base);
+            const SlothVec cwx = SlothVec::load(wx + base);
+            const SlothVec cww = SlothVec::load(ww + base);
+            const SlothVec cyw = SlothVec::load(yw + base);
+            const SlothVec czy = SlothVec::load(zy + base);
+            const SlothVec cz0 = SlothVec::load(z0 + base);
+            const SlothVec qp = SlothVec::load(qpos + base);
+            const SlothVec qn = SlothVec::load(qneg + base);
+            const SlothVec Qz = Q(z, qp, qn);
+
+            // Start with crude estimates that the voltage variables remain constant over the time interval.
+            SlothVec xm = x;
+            SlothVec wm = w;
+            SlothVec zm = z;
+            SlothVec Qm = Qz;
+
+            SlothVec ex = zero;
+            SlothVec ew = zero;
+            SlothVec ey = zero;
+
+            SlothVec x2 = x;
+            SlothVec w2 = w;
+            SlothVec y2 = y;
+            SlothVec z2 = z;
+
+            // Padding lanes start out converged, so they never hold up the real voices.
+            SlothMask done = zero < SlothVec::load(padding + base);
+
+            // The iteration count at which each lane converged, if the caller wants to know.
+            SlothVec laneIter = zero;
+
+            // Iterate until convergence.
+            const double tolerance = 1.0e-12;        // one picovolt
+            const SlothVec toleranceSquared = SlothVec::broadcast(tolerance * tolerance);
+
+            for (int iter = 1; true; ++iter)
+            {
+                // Update the finite changes of the voltage variables after the time interval.
+                SlothVec dx = (cxz*zm + cxq*Qm) + cxw*wm;
+                SlothVec dw = cwx*xm + cww*wm;
+                SlothVec dy = cyw*wm;
+
+                SlothVec xn = x + dx;
+                SlothVec wn = w + dw;
+                SlothVec yn = y + dy;
+
+                // Assume z changes instantaneously because there is no capacitor the U2 feedback loop.
+                SlothVec zn = czy*yn + cz0;
+
+                if (iter > 1)
+                {
+                    // Which lanes have converged on this iteration?
+                    SlothVec ddx = dx - ex;
+                    SlothVec ddw = dw - ew;
+                    SlothVec ddy = dy - ey;
+                    SlothVec variance = (ddx*ddx + ddw*ddw) + ddy*ddy;
+                    SlothMask converged = (variance < toleranceSquared) | SlothMask::broadcast(iter >= iterationLimit);
+                    SlothMask latch = andNot(converged, done);
+                    x2 = select(latch, xn, x2);
+                    w2 = select(latch, wn, w2);
+                    y2 = select(latch, yn, y2);
+                    z2 = select(latch, zn, z2);
+                    if constexpr (countIterations)
+                        laneIter = select(latch, SlothVec::broadcast(iter), laneIter);
+                    done = done | converged;
+
+                    if (!andNot(SlothMask::broadcast(true), done).any())
+                    {
+                        // Every lane has converged, or we have hit the iteration safety limit.
+                        // Update the circuit state voltages and return.
+                        x2.store(x1 + base);
+                        w2.store(w1 + base);
+                        y2.store(y1 + base);
+                        z2.store(z1 + base);
+                        if constexpr (countIterations)
+                        {
+                            alignas(64) double count[W];
+                            laneIter.store(count);
+                            for (int i = 0; i < W && base + i < N; ++i)
+                                laneIterations[base + i] = static_cast<int>(count[i]);
+                        }
+                        return iter;
+                    }
+                }
+
+                // We approximate the mean value over the time interval as the average
+                // of the starting value with the estimated next value.
+                xm = x + dx*half;
+                wm = w + dw*half;
+                zm = (z + zn)*half;
+
+                // Usually Q remains constant, but it toggles when z changes polarity.
+                // alpha = the fraction into the time step at which z(t) = 0.
+                SlothMask crossing = (z * zn) < zero;
+                SlothVec alpha = z / select(crossing, z - zn, one);
+                SlothVec Qcross = alpha*Qz + (one - alpha)*Q(zn, qp, qn);
+                Qm = select(crossing, Qcross, Q(zm, qp, qn));
+
+                // Remember the previous delta voltages, so we can tell whether we have converged next time.
+                ex = dx;
+                ew = dw;
+                ey = dy;
+            }
+        }
+
+    public:
+        // The iteration safety limit for the convergence solver.
+        const int iterationLimit = 5;
+
+        static constexpr int size()
+        {
+            return N;
+        }
+
+        SlothBank()
+        {
+            // Every voice starts out as Torpor with its inputs at zero.
+            for (int i = 0; i < P; ++i)
+            {
+                padding[i] = (i < N) ? 0.0 : 1.0;
+                timeDilation[i] = 1.0;
+                w0[i] = 0.0;
+                setComponents(i, SlothComponentValues());
+                initialize(i);
+                setKnobPosition(i, 0.0);
+                setControlVoltage(i, 0.0);
+            }
+        }
+
+        void setVoice(int lane, const SlothCircuit& circuit)
+        {
+            // Copy the variant, inputs, and current state of a scalar circuit into a lane.
+            timeDilation[lane] = circuit.timeDilationFactor();
+            w0[lane] = circuit.initialChargeVoltage();
+            K[lane] = circuit.variableResistance();
+            U[lane] = circuit.controlVoltage();
+            x1[lane] = circuit.xVoltage();
+            w1[lane] = circuit.wVoltage();
+            y1[lane] = circuit.yVoltage();
+            z1[lane] = circuit.zVoltage();
+            laneChanged(lane);
+        }
+
+        void setComponents(int lane, const SlothComponentValues& values)
+        {
+            // Simulate a lane with nonstandard component values or comparator levels.
+            // setVoice does not change them.
+            parts[lane] = values;
+            qneg[lane] = values.QNEG;
+            qpos[lane] = values.QPOS;
+            zy[lane] = -values.R4 / values.R5;
+            laneChanged(lane);
+        }
+
+        const SlothComponentValues& components(int lane) const
+        {
+            return parts[lane];
+        }
+
+        void initialize(int lane)
+        {
+            w1[lane] = w0[lane];
+            x1[lane] = 0.0;
+            y1[lane] = 0.0;
+            z1[lane] = 0.0;
+        }
+
+        void initialize()
+        {
+            for (int i = 0; i < N; ++i)
+                initialize(i);
+        }
+
+        SlothState saveState(int lane) const
+        {
+            return SlothState{x1[lane], w1[lane], y1[lane], z1[lane]};
+        }
+
+        void restoreState(int lane, const SlothState& state)
+        {
+            x1[lane] = state.x;
+            w1[lane] = state.w;
+            y1[lane] = state.y;
+            z1[lane] = state.z;
+        }
+
+        void setKnobPosition(int lane, double fraction)
+        {
+            K[lane] = knobResistance(fraction);
+            laneChanged(lane);
+        }
+
+        void setControlVoltage(int lane, double cv)
+        {
+            // Only the z0 coefficient depends on the control voltage, so this
+            // is cheap enough to call on every sample. The expression is the
+            // same one SlothCoefficients uses, so the result is identical.
+            U[lane] = clampControlVoltage(cv);
+            if (coefSampleRateHz != 0.0f)
+                z0[lane] = (-parts[lane].R4/parts[lane].R8) * U[lane];
+        }
+
+        double xVoltage(int lane) const
+        {
+            return x1[lane];
+        }
+
+        double wVoltage(int lane) const
+        {
+            return w1[lane];
+        }
+
+        double yVoltage(int lane) const
+        {
+            return y1[lane];
+        }
+
+        double zVoltage(int lane) const
+        {
+            return z1[lane];
+        }
+
+        int update(float sampleRateHz)      // returns the largest iteration count needed by any lane [1..iterationLimit]
+        {
+            if (sampleRateHz != coefSampleRateHz)
+                refreshCoefficients(sampleRateHz);
+
+            int maxIter = 0;
+            for (int base = 0; base < P; base += W)
+                maxIter = std::max(maxIter, solve<false>(base, nullptr));
+            return maxIter;
+        }
+
+        int updateLanes(float sampleRateHz, int laneCount)
+        {
+            // Same as update(sampleRateHz), but only advances the SIMD vectors
+            // that contain lanes 0..laneCount-1. The other lanes keep their state.
+            if (sampleRateHz != coefSampleRateHz)
+                refreshCoefficients(sampleRateHz);
+
+            const int end = std::min(P, W * ((std::max(0, laneCount) + W - 1) / W));
+            int maxIter = 0;
+            for (int base = 0; base < end; base += W)
+                maxIter = std::max(maxIter, solve<false>(base, nullptr));
+            return maxIter;
+        }
+
+        int update(float sampleRateHz, int *laneIterations)
+        {
+            // Same as update(sampleRateHz), but also stores the number of
+            // iterations each voice needed in laneIterations[0..N-1].
+            if (sampleRateHz != coefSampleRateHz)
+                refreshCoefficients(sampleRateHz);
+
+            int maxIter = 0;
+            for (int base = 0; base < P; base += W)
+                maxIter = std::max(maxIter, solve<true>(base, laneIterations));
+            return maxIter;
+        }
+    };
+}
@@ -20,169 +20,531 @@ namespace Analog
     const double QNEG = -10.64;
     const double QPOS = +11.38;
 
-    class SlothCircuit
+    // Component values shared by all Sloth variants.
+    struct SlothComponents
     {
-    private:
-        const double timeDilation;      // The time dilation factor creates variants that run at different speeds.
-        const double w0;                // Initial charge voltage of C3, which affects initial trajectory.
-
-        // Inputs
-        double K{};     // the total resistance R3 (fixed) + R9 (variable)
-        double U{};     // control voltage fed into the circuit via R8
-
-        // Node voltages
-        double x1{};    // voltage at the output of op-amp U3
-        double w1{};    // voltage at the top of capacitor C3
-        double y1{};    // voltage at the output of op-amp U4
-        double z1{};    // voltage at the output of op-amp U2
-
         // Capacitor values in farads.
-        const double C1 = 2.0e-6;
-        const double C2 = 1.42e-6;    // schematic says 1uF, but this value acts more "slothy"
-        const double C3 = 50.0e-6;
+        static constexpr double C1 = 2.0e-6;
+        static constexpr double C2 = 1.42e-6;    // schematic says 1uF, but this value acts more "slothy"
+        static constexpr double C3 = 50.0e-6;
 
         // Resistor values in ohms.
         // R3 + R9 = K, so R3 and R9 are not listed here.
-        const double R1 = 1.0e+6;
-        const double R2 = 4.7e+6;
-        const double R4 = 100.0e+3;
-        const double R5 = 100.0e+3;
-        const double R6 = 100.0e+3;
-        const double R7 = 100.0e+3;
-        const double R8 = 470.0e+3;
+        static constexpr double R1 = 1.0e+6;
+        static constexpr double R2 = 4.7e+6;
+        static constexpr double R4 = 100.0e+3;
+        static constexpr double R5 = 100.0e+3;
+        static constexpr double R6 = 100.0e+3;
+        static constexpr double R7 = 100.0e+3;
+        static constexpr double R8 = 470.0e+3;
 
         // Power supply rail voltages.
-        const double VNEG = -12.0;
-        const double VPOS = +12.0;
+        static constexpr double VNEG = -12.0;
+        static constexpr double VPOS = +12.0;
 
-        double Q(double z)
+        template <typename real_t>
+        static real_t Q(real_t z)
         {
             // The comparator U1 output responds immediately to the voltage z.
             // It is an inverting amplifier whose output is saturated.
-            return (z < 0.0) ? QPOS : QNEG;
+            return (z < 0) ? static_cast<real_t>(QPOS) : static_cast<real_t>(QNEG);
         }
 
-    protected:
-        SlothCircuit(double _timeDilation, double _w0)
-            : timeDilation(_timeDilation)
-            , w0(_w0)
+        static double knobResistance(double fraction)
         {
-            initialize();
-            setKnobPosition(0.0);
-            setControlVoltage(0.0);
+            // Clamp the fraction to the range [0, 1].
+            double clamped = std::max(0.0, std::min(1.0, fraction));
+
+            // The maximum value of the variable resistor is 10K.
+            // This is in series with a fixed resistance of 100K.
+            return 100.0e+3 + (clamped * 10.0e+3);
         }
 
-    public:
-        // The iteration safety limit for the convergence solver.
-        const int iterationLimit = 5;
+        static double clampControlVoltage(double cv)
+        {
+            // Clamp the control voltage to the circuit's supply rails.
+            return std::max(VNEG, std::min(VPOS, cv));
+        }
+    };
 
-        void initialize()
+
+    // Component values and comparator output levels that can be chosen at run time,
+    // for example by a tool that fits the simulation to measurements of the hardware.
+    // The defaults are the standard values in SlothComponents.
+    struct SlothComponentValues
+    {
+        double C1 = SlothComponents::C1;
+        double C2 = SlothComponents::C2;
+        double C3 = SlothComponents::C3;
+        double R1 = SlothComponents::R1;
+        double R2 = SlothComponents::R2;
+        double R4 = SlothComponents::R4;
+        double R5 = SlothComponents::R5;
+        double R6 = SlothComponents::R6;
+        double R7 = SlothComponents::R7;
+        double R8 = SlothComponents::R8;
+        double QNEG = Analog::QNEG;
+        double QPOS = Analog::QPOS;
+
+        template <typename parts_t>
+        static SlothComponentValues from()
         {
-            w1 = w0;
-            x1 = 0.0;
-            y1 = 0.0;
-            z1 = 0.0;
+            SlothComponentValues v;
+            v.C1 = parts_t::C1;
+            v.C2 = parts_t::C2;
+            v.C3 = parts_t::C3;
+            v.R1 = parts_t::R1;
+            v.R2 = parts_t::R2;
+            v.R4 = parts_t::R4;
+            v.R5 = parts_t::R5;
+            v.R6 = parts_t::R6;
+            v.R7 = parts_t::R7;
+            v.R8 = parts_t::R8;
+            return v;
         }
+    };
 
-        void setKnobPosition(double fraction)
+
+    // The solver's update equations, reduced to multiply-add form.
+    // These constants depend only on the time step and the circuit inputs,
+    // so they only need to be recalculated when one of those changes.
+    // They are always calculated in double precision, then stored as `real_t`.
+    template <typename real_t>
+    struct SlothCoefficientsT
+    {
+        real_t xz{}, xq{}, xw{};    // dx = xz*z + xq*Q + xw*w
+        real_t wx{}, ww{};          // dw = wx*x + ww*w
+        real_t yw{};                // dy = yw*w
+        real_t zy{}, z0{};          // z = zy*y + z0
+
+        // For the predictive solver: the square of rho/(1 - rho), where rho bounds how much
+        // each midpoint iteration shrinks the error in the deltas while Q stays the same.
+        // The error remaining after an iteration is then at most sqrt(predictorGain)
+        // times the change that iteration made.
+        real_t predictorGain{};
+
+        template <typename parts_t = SlothComponents>
+        void calculate(double dt, double k, double u)
         {
-            // Clamp the fraction to the range [0, 1].
-            double clamped = std::max(0.0, std::min(1.0, fraction));
+            // Calculate the coefficients for time step `dt`, variable resistance `k`,
+            // and control voltage `u`, using the component values in `parts_t`.
+            // The parenthesized component expressions fold into compile-time constants,
+            // leaving a single division by `k`.
+            constexpr double C1 = parts_t::C1, C2 = parts_t::C2, C3 = parts_t::C3;
+            constexpr double R1 = parts_t::R1, R2 = parts_t::R2, R4 = parts_t::R4, R5 = parts_t::R5;
+            constexpr double R6 = parts_t::R6, R7 = parts_t::R7, R8 = parts_t::R8;
+            assign(dt, 1/k, u, C1, C2, C3, R1, R2, R4, R5, R6, R7, R8);
+        }
 
-            // The maximum value of the variable resistor is 10K.
-            // This is in series with a fixed resistance of 100K.
-            K = 100.0e+3 + (clamped * 10.0e+3);
+        template <typename parts_t = SlothComponents>
+        static constexpr double controlVoltageGain()
+        {
+            // Only z0 depends on the control voltage u: z0 = controlVoltageGain() * u.
+            return -parts_t::R4/parts_t::R8;
         }
 
-        void setControlVoltage(double cv)
+        void calculate(double dt, double k, double u, const SlothComponentValues& parts)
         {
-            // Clamp the control voltage to the circuit's supply rails.
-            U = std::max(VNEG, std::min(VPOS, cv));
+            // Calculate the coefficients using component values chosen at run time.
+            assign(dt, 1/k, u, parts.C1, parts.C2, parts.C3, parts.R1, parts.R2, parts.R4, parts.R5, parts.R6, parts.R7, parts.R8);
         }
 
-        double xVoltage() const
+    private:
+        void assign(
+            double dt, double g, double u,
+            double C1, double C2, double C3,
+            double R1, double R2, double R4, double R5, double R6, double R7, double R8)
         {
-            return x1;
+            xz = static_cast<real_t>(dt * (-1/(C1*R1)));
+            xq = static_cast<real_t>(dt * (-1/(C1*R2)));
+            xw = static_cast<real_t>((dt * (-1/C1)) * g);
+            wx = static_cast<real_t>(dt * (1/(C3*R6)));
+            ww = static_cast<real_t>((dt * (-1/C3)) * ((1/R6 + 1/R7) + g));
+            yw = static_cast<real_t>(dt * (-1/(R7*C2)));
+            zy = static_cast<real_t>(-R4/R5);
+            z0 = static_cast<real_t>((-R4/R8) * u);
+
+            // While Q is constant, each iteration is the affine map d' = J d + b on the
+            // deltas d = (dx, dw, dy), whose Jacobian J has the nonzero entries
+            // xw/2 and xz*zy/2 (row dx), wx/2 and ww/2 (row dw), and yw/2 (row dy).
+            // Its Frobenius norm bounds its 2-norm, which is the contraction factor rho.
+            const double jxw = (dt * (-1/C1)) * g;
+            const double jxy = (dt * (-1/(C1*R1))) * (-R4/R5);
+            const double jwx = dt * (1/(C3*R6));
+            const double jww = (dt * (-1/C3)) * ((1/R6 + 1/R7) + g);
+            const double jyw = dt * (-1/(R7*C2));
+            const double rho = 0.5 * std::sqrt(jxw*jxw + jxy*jxy + jwx*jwx + jww*jww + jyw*jyw);
+            const double ratio = (rho < 0.5) ? rho / (1 - rho) : 1.0;
+            predictorGain = static_cast<real_t>(ratio * ratio);
         }
+    };
 
-        double yVoltage() const
+
+    using SlothCoefficients = SlothCoefficientsT<double>;
+
+
+    // The exact solution of the linear system for (x, w, y) over one time step,
+    // valid whenever the comparator output Q stays constant during the step.
+    // The state after the step is
+    //
+    //     (x2, w2, y2) = (x1, w1, y1) + delta * (x1, w1, y1) + gamma * (xz*z0 + xq*Q)
+    //
+    // where delta = exp(A dt) - I is the state-transition matrix minus the identity,
+    // and gamma is the response to the constant forcing term in dx/dt.
+    // Keeping the identity separate means the change in each voltage is calculated
+    // without first rounding matrix entries that are very close to 1.
+    // The matrices are calculated in double precision, then stored as `real_t`.
+    template <typename real_t>
+    struct SlothTransitionT
+    {
+        real_t delta[3][3]{};
+        real_t gamma[3]{};
+
+        void calculate(const SlothCoefficients& c)
         {
-            return y1;
+            // Build the augmented 4x4 matrix [A dt, e1; 0, 0]. Its exponential contains
+            // I + delta in the upper left 3x3 block and gamma in the upper right column.
+            // The last row is all zeroes, so we only need to keep the first 3 rows.
+            double m[3][4] =
+            {
+                { 0.0,  c.xw, c.xz*c.zy, 1.0 },
+                { c.wx, c.ww, 0.0,       0.0 },
+                { 0.0,  c.yw, 0.0,       0.0 },
+            };
+
+            // Scaling and squaring: reduce the norm of the matrix below 1/2,
+            // where the Taylor series converges quickly.
+            double norm = 0.0;
+            for (int r = 0; r < 3; ++r)
+                norm = std::max(norm, std::abs(m[r][0]) + std::abs(m[r][1]) + std::abs(m[r][2]) + std::abs(m[r][3]));
+
+            int squarings = 0;
+            while (norm > 0.5)
+            {
+                norm /= 2;
+                ++squarings;
+            }
+
+            for (int r = 0; r < 3; ++r)
+                for (int k = 0; k < 4; ++k)
+                    m[r][k] = std::ldexp(m[r][k], -squarings);
+
+            // Sum the Taylor series exp(m) - I = m + m^2/2! + m^3/3! + ...
+            // 18 terms are plenty for the norm to fall below double precision.
+            double sum[3][4];
+            double term[3][4];
+            for (int r = 0; r < 3; ++r)
+            {
+                for (int k = 0; k < 4; ++k)
+                {
+                    term[r][k] = m[r][k];
+                    sum[r][k] = m[r][k];
+                }
+            }
+
+            for (int n = 2; n <= 18; ++n)
+            {
+                double next[3][4];
+                multiply(next, term, m);
+                for (int r = 0; r < 3; ++r)
+                {
+                    for (int k = 0; k < 4; ++k)
+                    {
+                        term[r][k] = next[r][k] / n;
+                        sum[r][k] += term[r][k];
+                    }
+                }
+            }
+
+            // Undo the scaling by squaring the result. Squaring [I + D, g; 0, 1]
+            // gives [I + 2D + D*D, 2g + D*g; 0, 1], so the identity never has to be added in.
+            for (int i = 0; i < squarings; ++i)
+            {
+                double square[3][4];
+                multiply(square, sum, sum);
+                for (int r = 0; r < 3; ++r)
+                    for (int k = 0; k < 4; ++k)
+                        sum[r][k] = 2*sum[r][k] + square[r][k];
+            }
+
+            for (int r = 0; r < 3; ++r)
+            {
+                for (int k = 0; k < 3; ++k)
+                    delta[r][k] = static_cast<real_t>(sum[r][k]);
+                gamma[r] = static_cast<real_t>(sum[r][3]);
+            }
         }
 
-        double zVoltage() const
+    private:
+        static void multiply(double p[3][4], const double a[3][4], const double b[3][4])
         {
-            return z1;
+            // Multiply the first 3 rows of two augmented matrices,
+            // treating the implied 4th row of `b` as all zeroes.
+            for (int r = 0; r < 3; ++r)
+                for (int k = 0; k < 4; ++k)
+                    p[r][k] = a[r][0]*b[0][k] + a[r][1]*b[1][k] + a[r][2]*b[2][k];
         }
+    };
 
-        int update(float sampleRateHz)      // returns the number of iterations needed for convergence [1..iterationLimit]
+    using SlothTransition = SlothTransitionT<double>;
+
+
+    // A snapshot of the four node voltages, for saving and restoring a circuit's state.
+    struct SlothState
+    {
+        double x{};
+        double w{};
+        double y{};
+        double z{};
+    };
+
+
+    // The numerical integration method used by SlothCircuit.
+    enum class SlothIntegrator
+    {
+        Midpoint,   // iterate toward the mean values over each time step (see README)
+        Exact,      // exact linear solution, with Midpoint as a fallback when Q toggles
+        Predictive, // Midpoint, stopping as soon as the remaining error is provably within tolerance
+    };
+
+
+    // Solver statistics. SlothNoStats, the default, records nothing and compiles away.
+    // SlothSolverStats counts how hard the solver works, for finding the knob and
+    // CV settings that cost the most CPU time. Use it by naming it as a circuit's
+    // second template parameter, for example TorporSlothCircuitT<double, SlothSolverStats>.
+    struct SlothNoStats
+    {
+        static constexpr bool enabled = false;
+
+        void recordExactStep() {}
+        void recordSolve(int, bool, bool, bool, double) {}
+    };
+
+
+    struct SlothSolverStats
+    {
+        static constexpr bool enabled = true;
+        static constexpr int maxHistogramIterations = 15;
+
+        long long steps = 0;            // time steps taken
+        long long exactSteps = 0;       // steps taken by the exact integrator without iterating
+        long long limitHits = 0;        // steps that stopped at the iteration limit without converging
+        long long crossings = 0;        // steps whose final estimate interpolated Q across a zero crossing of z
+        long long toggles = 0;          // steps after which Q had a different value
+        double residualSum = 0.0;       // sum of the final residuals of the iterative steps, in volts
+        double residualMax = 0.0;       // the largest final residual of any iterative step, in volts
+
+        // iterations[n] = how many steps needed n iterations, with the last bucket counting n or more.
+        long long iterations[maxHistogramIterations + 1]{};
+
+        void reset()
         {
-            // Start with crude estimates that the voltage variables remain constant over the time interval.
-            double xm = x1;
-            double wm = w1;
-            double zm = z1;
-            double Qm = Q(zm);
+            *this = SlothSolverStats();
+        }
 
-            double dt = timeDilation / sampleRateHz;
+        void recordExactStep()
+        {
+            ++steps;
+            ++exactSteps;
+            ++iterations[1];
+        }
 
-            double ex = 0.0;
-            double ew = 0.0;
-            double ey = 0.0;
+        void recordSolve(int iter, bool converged, bool crossed, bool toggled, double residual)
+        {
+            ++steps;
+            ++iterations[std::min(iter, maxHistogramIterations)];
+            if (!converged)
+                ++limitHits;
+            if (crossed)
+                ++crossings;
+            if (toggled)
+                ++toggles;
+            residualSum += residual;
+            residualMax = std::max(residualMax, residual);
+        }
+
+        long long iterativeSteps() const
+        {
+            return steps - exactSteps;
+        }
+
+        double meanIterations() const
+        {
+            long long total = 0;
+            for (int n = 1; n <= maxHistogramIterations; ++n)
+                total += n * iterations[n];
+            return (steps > 0) ? static_cast<double>(total) / steps : 0.0;
+        }
+
+        double meanResidual() const
+        {
+            return (iterativeSteps() > 0) ? residualSum / iterativeSteps() : 0.0;
+        }
+    };
+
+
+    // The numerical methods shared by the scalar Sloth circuit classes.
+    template <typename real_t>
+    struct SlothSolverT : protected SlothComponents
+    {
+        // The solver's convergence tolerance in volts: one picovolt in double precision.
+        // A float can't resolve changes that small, so it uses roughly its own precision.
+        static constexpr double tolerance = (sizeof(real_t) < sizeof(double)) ? 1.0e-7 : 1.0e-12;
+
+        // In single precision, the change in a voltage over one sample can be smaller
+        // than the precision of the voltage itself, especially in the slower variants.
+        // The rounding error of each update is then carried into the next one
+        // (Kahan summation), so those small changes are not lost.
+        static constexpr bool compensated = (sizeof(real_t) < sizeof(double));
+
+        struct Roundoff
+        {
+            real_t x{}, w{}, y{};
+        };
+
+
+        static void accumulate(real_t& v, real_t& carry, real_t change)
+        {
+            if constexpr (compensated)
+            {
+                const real_t d = change + carry;
+                const real_t sum = v + d;
+                carry = d - (sum - v);
+                v = sum;
+            }
+            else
+            {
+                v += change;
+            }
+        }
+
+        static void apply(const SlothCoefficientsT<real_t>& c, real_t dx, real_t dw, real_t dy, real_t& x, real_t& w, real_t& y, real_t& z, Roundoff& r)
+        {
+            // Add the changes over one time step to the node voltages.
+            accumulate(x, r.x, dx);
+            accumulate(w, r.w, dw);
+            accumulate(y, r.y, dy);
+            z = c.zy*y + c.z0;
+        }
+
+        static bool exactStep(const SlothCoefficientsT<real_t>& c, const SlothTransitionT<real_t>& t, real_t& x, real_t& w, real_t& y, real_t& z, Roundoff& r)
+        {
+            // Assume Q remains constant over the time step, and use the exact linear solution.
+            // Returns false, leaving the voltages unchanged, if the comparator toggles
+            // inside the time step, because then the exact linear solution does not apply.
+            const real_t Qz = Q(z);
+            const real_t f = c.xz*c.z0 + c.xq*Qz;
+            real_t dx = t.delta[0][0]*x + t.delta[0][1]*w + t.delta[0][2]*y + t.gamma[0]*f;
+            real_t dw = t.delta[1][0]*x + t.delta[1][1]*w + t.delta[1][2]*y + t.gamma[1]*f;
+            real_t dy = t.delta[2][0]*x + t.delta[2][1]*w + t.delta[2][2]*y + t.gamma[2]*f;
+            real_t z2 = c.zy*(y + dy) + c.z0;
+            if (Q(z2) != Qz)
+                return false;
+
+            apply(c, dx, dw, dy, x, w, y, z, r);
+            return true;
+        }
+
+        static int solve(int iterationLimit, const SlothCoefficientsT<real_t>& c, real_t& x, real_t& w, real_t& y, real_t& z, Roundoff& r)
+        {
+            SlothNoStats none;
+            return solve(iterationLimit, c, x, w, y, z, r, none);
+        }
+
+        template <bool predictive = false, typename stats_t = SlothNoStats>
+        static int solve(int iterationLimit, const SlothCoefficientsT<real_t>& c, real_t& x, real_t& w, real_t& y, real_t& z, Roundoff& r, stats_t& stats)
+        {
+            // Advances the node voltages (x, w, y, z) by one time step,
+            // using the equations reduced to the coefficients `c`.
+            // Returns the number of iterations needed for convergence [1..iterationLimit].
+            //
+            // Normally the solver stops when an iteration changes the deltas by less than
+            // the tolerance, which proves the previous iteration was already good enough.
+            // The predictive solver instead stops as soon as the error bound
+            // (see SlothCoefficientsT::predictorGain) shows that the current estimate
+            // is within tolerance. That bound only holds while Q is the same in both
+            // of the last two iterations and z does not cross zero within the step,
+            // so near comparator switches it falls back to the normal test.
+            // The first iteration only equals the map applied to zero deltas
+            // if z = zy*y + z0. That is not true on the first step after z0 changes,
+            // for example by setControlVoltage, so then the first iteration is not trusted.
+
+            // Start with crude estimates that the voltage variables remain constant over the time interval.
+            real_t xm = x;
+            real_t wm = w;
+            real_t zm = z;
+            real_t Qm = Q(zm);
+            real_t Qp = Qm;     // the Qm that produced the previous deltas
+
+            real_t ex = 0;
+            real_t ew = 0;
+            real_t ey = 0;
+            bool crossed = false;
+            const bool consistent = predictive && (z == c.zy*y + c.z0);
 
             // Iterate until convergence.
-            const double tolerance = 1.0e-12;        // one picovolt
-            const double toleranceSquared = tolerance * tolerance;
+            const real_t toleranceSquared = static_cast<real_t>(tolerance * tolerance);
 
             for (int iter = 1; true; ++iter)
             {
                 // Update the finite changes of the voltage variables after the time interval.
-                double dx = -dt/C1 * (zm/R1 + Qm/R2 + wm/K);
-                double dw = dt/C3*(xm/R6-(1/R6 + 1/K + 1/R7)*wm);
-                double dy = (-dt/(R7*C2)) * wm;
-
-                double x2 = x1 + dx;
-                double w2 = w1 + dw;
-                double y2 = y1 + dy;
+                real_t dx = c.xz*zm + c.xq*Qm + c.xw*wm;
+                real_t dw = c.wx*xm + c.ww*wm;
+                real_t dy = c.yw*wm;
 
                 // Assume z changes instantaneously because there is no capacitor the U2 feedback loop.
-                double z2 = -R4*(y2/R5 + U/R8);
+                real_t z2 = c.zy*(y + dy) + c.z0;
 
-                if (iter > 1)
+                if (iter > 1 || predictive)
                 {
                     // Has the solver converged?
                     // Calculate how much the deltas have changed since last time.
-                    double ddx = dx - ex;
-                    double ddw = dw - ew;
-                    double ddy = dy - ey;
-                    double variance = ddx*ddx + ddw*ddw + ddy*ddy;
-                    if (variance < toleranceSquared || iter >= iterationLimit)
+                    // The predictive solver also checks the first iteration,
+                    // whose deltas are a change from the implied initial deltas of zero.
+                    real_t ddx = dx - ex;
+                    real_t ddw = dw - ew;
+                    real_t ddy = dy - ey;
+                    real_t variance = ddx*ddx + ddw*ddw + ddy*ddy;
+                    bool predicted = false;
+                    if constexpr (predictive)
+                        predicted = (iter > 1 || consistent) && (Qm == Qp) && (z * z2 > 0) && (variance * c.predictorGain < toleranceSquared);
+                    if ((iter > 1 && variance < toleranceSquared) || predicted || iter >= iterationLimit)
                     {
                         // The solution has converged, or we have hit the iteration safety limit.
                         // Update the circuit state voltages and return.
-                        x1 = x2;
-                        w1 = w2;
-                        y1 = y2;
-                        z1 = z2;
+                        if constexpr (stats_t::enabled)
+                        {
+                            const real_t q1 = Q(z);
+                            apply(c, dx, dw, dy, x, w, y, z, r);
+                            stats.recordSolve(iter, (iter > 1 && variance < toleranceSquared) || predicted, crossed, Q(z) != q1, std::sqrt(static_cast<double>(variance)));
+                        }
+                        else
+                        {
+                            apply(c, dx, dw, dy, x, w, y, z, r);
+                        }
                         return iter;
                     }
                 }
 
                 // We approximate the mean value over the time interval as the average
                 // of the starting value with the estimated next value.
-                xm = x1 + dx/2;
-                wm = w1 + dw/2;
-                zm = (z1 + z2)/2;
+                Qp = Qm;
+                xm = x + dx/2;
+                wm = w + dw/2;
+                zm = (z + z2)/2;
 
                 // Usually Q remains constant, but it toggles when z changes polarity.
-                if (z1 * z2 >= 0)
+                if (z * z2 >= 0)
                 {
                     Qm = Q(zm);
+                    crossed = false;
                 }
                 else
                 {
                     // alpha = the fraction into the time step at which z(t) = 0.
-                    double alpha = z1 / (z1 - z2);
-                    Qm = alpha*Q(z1) + (1-alpha)*Q(z2);
+                    real_t alpha = z / (z - z2);
+                    Qm = alpha*Q(z) + (1-alpha)*Q(z2);
+                    crossed = true;
                 }
 
                 // Remember the previous delta voltages, so we can tell whether we have converged next time.
@@ -194,29 +556,415 @@ namespace Analog
     };
 
 
-    class TorporSlothCircuit : public SlothCircuit
+    // The Sloth circuit simulation, using the floating point type `real_t`
+    // for the node voltages and the solver arithmetic. Use `double` (SlothCircuit)
+    // unless profiling shows that `float` is needed; see the FloatPrecision test.
+    // The optional `stats_t` collects solver statistics (see SlothSolverStats).
+    template <typename real_t, typename stats_t = SlothNoStats>
+    class SlothCircuitT : protected SlothComponents
+    {
+    private:
+        const double timeDilation;      // The time dilation factor creates variants that run at different speeds.
+        const double w0;                // Initial charge voltage of C3, which affects initial trajectory.
+
+        // Inputs
+        double K{};     // the total resistance R3 (fixed) + R9 (variable)
+        double U{};     // control voltage fed into the circuit via R8
+
+        // Node voltages
+        real_t x1{};    // voltage at the output of op-amp U3
+        real_t w1{};    // voltage at the top of capacitor C3
+        real_t y1{};    // voltage at the output of op-amp U4
+        real_t z1{};    // voltage at the output of op-amp U2
+
+        // Cached solver coefficients, valid for the sample rate `coefSampleRateHz`.
+        // A sample rate of zero means they need to be recalculated.
+        SlothCoefficientsT<real_t> coef;
+        float coefSampleRateHz = 0.0f;
+
+        // The exact integrator's transition matrix depends only on the time step and K,
+        // so it is only recalculated when one of those changes.
+        SlothIntegrator integrator = SlothIntegrator::Midpoint;
+        SlothTransitionT<real_t> trans;
+        double transDt = 0.0;
+        double transK = 0.0;
+
+        static void calculateTransition(SlothTransitionT<real_t>& t, double dt, double k)
+        {
+            // The transition matrix does not depend on the control voltage.
+            SlothCoefficients c;
+            c.calculate(dt, k, 0.0);
+            t.calculate(c);
+        }
+
+        void refreshTransition(double dt, double k)
+        {
+            if (integrator == SlothIntegrator::Exact && (dt != transDt || k != transK))
+            {
+                calculateTransition(trans, dt, k);
+                transDt = dt;
+                transK = k;
+            }
+        }
+
+        void refreshCoefficients(float sampleRateHz)
+        {
+            double dt = timeDilation / sampleRateHz;
+            coef.calculate(dt, K, U);
+            coefSampleRateHz = sampleRateHz;
+            refreshTransition(dt, K);
+        }
+
+        using Solver = SlothSolverT<real_t>;
+        using Roundoff = typename Solver::Roundoff;
+        Roundoff roundoff;
+
+        stats_t solverStats;
+
+        int step(const SlothCoefficientsT<real_t>& c, real_t& x, real_t& w, real_t& y, real_t& z, Roundoff& r)
+        {
+            // Advances the node voltages by one time step using the selected integrator.
+            // Returns the number of iterations needed for convergence [1..iterationLimit].
+            // When the exact integrator finds that the comparator toggles, it falls back
+            // to the iterative solver, which handles the crossing.
+
+            if (integrator == SlothIntegrator::Exact && Solver::exactStep(c, trans, x, w, y, z, r))
+            {
+                solverStats.recordExactStep();
+                return 1;
+            }
+
+            if (integrator == SlothIntegrator::Predictive)
+                return Solver::template solve<true>(iterationLimit, c, x, w, y, z, r, solverStats);
+
+            return Solver::solve(iterationLimit, c, x, w, y, z, r, solverStats);
+        }
+
+    protected:
+        SlothCircuitT(double _timeDilation, double _w0)
+            : timeDilation(_timeDilation)
+            , w0(_w0)
+        {
+            initialize();
+            setKnobPosition(0.0);
+            setControlVoltage(0.0);
+        }
+
+    public:
+        // The iteration safety limit for the convergence solver.
+        const int iterationLimit = 5;
+
+        void initialize()
+        {
+            w1 = static_cast<real_t>(w0);
+            x1 = 0;
+            y1 = 0;
+            z1 = 0;
+            roundoff = Roundoff();
+        }
+
+        SlothState saveState() const
+        {
+            return SlothState{x1, w1, y1, z1};
+        }
+
+        void restoreState(const SlothState& state)
+        {
+            // Replace the node voltages with a previously saved state.
+            // The inputs, integrator, and sample rate are not affected.
+            x1 = static_cast<real_t>(state.x);
+            w1 = static_cast<real_t>(state.w);
+            y1 = static_cast<real_t>(state.y);
+            z1 = static_cast<real_t>(state.z);
+            roundoff = Roundoff();
+        }
+
+        void setIntegrator(SlothIntegrator method)
+        {
+            // Select the numerical integration method used by `update` and `process`.
+            // The exact integrator recalculates a matrix exponential whenever K changes,
+            // so it works best when the knob position changes only occasionally.
+            integrator = method;
+            coefSampleRateHz = 0.0f;
+            transDt = 0.0;
+        }
+
+        SlothIntegrator getIntegrator() const
+        {
+            return integrator;
+        }
+
+        const stats_t& stats() const
+        {
+            // The solver statistics collected by `update` and `process` since the last reset.
+            // `advance` is not included, because it does not use the solver for every step.
+            return solverStats;
+        }
+
+        void resetStats()
+        {
+            solverStats = stats_t();
+        }
+
+        void setKnobPosition(double fraction)
+        {
+            double k = knobResistance(fraction);
+            if (k != K)
+            {
+                K = k;
+                coefSampleRateHz = 0.0f;
+            }
+        }
+
+        void setControlVoltage(double cv)
+        {
+            double u = clampControlVoltage(cv);
+            if (u != U)
+            {
+                U = u;
+                coefSampleRateHz = 0.0f;
+            }
+        }
+
+        double timeDilationFactor() const
+        {
+            return timeDilation;
+        }
+
+        double initialChargeVoltage() const
+        {
+            return w0;
+        }
+
+        double variableResistance() const
+        {
+            return K;
+        }
+
+        double controlVoltage() const
+        {
+            return U;
+        }
+
+        double xVoltage() const
+        {
+            return x1;
+        }
+
+        double wVoltage() const
+        {
+            return w1;
+        }
+
+        double yVoltage() const
+        {
+            return y1;
+        }
+
+        double zVoltage() const
+        {
+            return z1;
+        }
+
+        int update(float sampleRateHz)      // returns the number of iterations needed for convergence [1..iterationLimit]
+        {
+            if (sampleRateHz != coefSampleRateHz)
+                refreshCoefficients(sampleRateHz);
+
+            return step(coef, x1, w1, y1, z1, roundoff);
+        }
+
+        void advance(double seconds, double maxStep = 1.0e-3)
+        {
+            // Moves the circuit forward by `seconds` of real time without producing
+            // any samples, for example to start a voice at a mature point on its
+            // attractor instead of at rest. This takes equal time steps of at most
+            // `maxStep` circuit seconds using the exact linear solution, so it is much
+            // cheaper than calling `update` once per sample. The slower variants benefit
+            // the most, because they cover less circuit time per second.
+            // The result is close to, but not identical to, calling `update` repeatedly.
+
+            const double circuitSeconds = seconds * timeDilation;
+            if (!(circuitSeconds > 0.0))
+                return;
+
+            const double n = std::ceil(circuitSeconds / maxStep);
+            const double dt = circuitSeconds / n;
+            SlothCoefficientsT<real_t> c;
+            c.calculate(dt, K, U);
+            SlothTransitionT<real_t> t;
+            calculateTransition(t, dt, K);
+
+            real_t x = x1;
+            real_t w = w1;
+            real_t y = y1;
+            real_t z = z1;
+            Roundoff r = roundoff;
+            for (double i = 0.0; i < n; i += 1.0)
+                if (!Solver::exactStep(c, t, x, w, y, z, r))
+                    Solver::solve(iterationLimit, c, x, w, y, z, r);
+
+            x1 = x;
+            w1 = w;
+            y1 = y;
+            z1 = z;
+            roundoff = r;
+        }
+
+        int process(
+            float sampleRateHz,
+            int nSamples,
+            float *xOutput,
+            float *yOutput,
+            float *zOutput,
+            const float *cvInput = nullptr,
+            const float *knobInput = nullptr)
+        {
+            // Generates a block of `nSamples` consecutive samples, exactly as if
+            // `update` had been called once per sample. Any of the output buffers
+            // may be null if the caller does not need that voltage.
+            // The optional input buffers supply one control voltage and/or one knob
+            // position per sample, overriding setControlVoltage/setKnobPosition.
+            // The last input values remain in effect after the block is finished.
+            // Returns the largest iteration count needed by any sample in the block.
+
+            if (sampleRateHz != coefSampleRateHz)
+                refreshCoefficients(sampleRateHz);
+
+            const double dt = timeDilation / sampleRateHz;
+
+            // Copy the circuit state into local variables, so the compiler
+            // can keep them in registers for the duration of the block.
+            SlothCoefficientsT<real_t> c = coef;
+            real_t x = x1;
+            real_t w = w1;
+            real_t y = y1;
+            real_t z = z1;
+            Roundoff r = roundoff;
+            double k = K;
+            double u = U;
+            int maxIter = 0;
+
+            // Only z0 depends on the control voltage, so a sample whose CV
+            // changes but whose knob resistance does not needs just that one
+            // coefficient, not a full recalculation and transition refresh.
+            const double cvGain = SlothCoefficientsT<real_t>::controlVoltageGain();
+            for (int s = 0; s < nSamples; ++s)
+            {
+                if (cvInput) u = clampControlVoltage(cvInput[s]);
+                const double kNext = knobInput ? knobResistance(knobInput[s]) : k;
+                if (kNext != k)
+                {
+                    k = kNext;
+                    c.calculate(dt, k, u);
+                    refreshTransition(dt, k);
+                }
+                else if (cvInput)
+                {
+                    c.z0 = static_cast<real_t>(cvGain * u);
+                }
+
+                int iter = step(c, x, w, y, z, r);
+                maxIter = std::max(maxIter, iter);
+
+                if (xOutput) xOutput[s] = static_cast<float>(x);
+                if (yOutput) yOutput[s] = static_cast<float>(y);
+                if (zOutput) zOutput[s] = static_cast<float>(z);
+            }
+
+            x1 = x;
+            w1 = w;
+            y1 = y;
+            z1 = z;
+            roundoff = r;
+            if (k != K || u != U)
+            {
+                K = k;
+                U = u;
+                coef = c;
+            }
+            return maxIter;
+        }
+    };
+
+
+    using SlothCircuit = SlothCircuitT<double>;
+
+
+    enum class SlothVariant
+    {
+        Torpor,
+        Apathy,
+        Inertia,
+    };
+
+    const int SlothVariantCount = 3;
+
+    inline const char *SlothVariantName(SlothVariant variant)
+    {
+        switch (variant)
+        {
+        case SlothVariant::Torpor:  return "Torpor";
+        case SlothVariant::Apathy:  return "Apathy";
+        case SlothVariant::Inertia: return "Inertia";
+        default:                    return "Unknown";
+        }
+    }
+
+
+    // The parameters that distinguish the Sloth variants, as compile-time constants.
+    // These also carry the component values, so a custom variant can derive
+    // from one of these and override any of them (see SlothStatic.hpp).
+    struct TorporParameters : SlothComponents
+    {
+        static constexpr double timeDilation = 1.0;
+        static constexpr double w0 = 0.0;
+    };
+
+    struct ApathyParameters : SlothComponents
+    {
+        static constexpr double timeDilation = 0.27391343022607395;
+        static constexpr double w0 = +0.017;
+    };
+
+    struct InertiaParameters : SlothComponents
+    {
+        static constexpr double timeDilation = 0.009697118406631193;
+        static constexpr double w0 = -0.023;
+    };
+
+
+    template <typename real_t, typename stats_t = SlothNoStats>
+    class TorporSlothCircuitT : public SlothCircuitT<real_t, stats_t>
     {
     public:
-        TorporSlothCircuit()
-            : SlothCircuit(1.0, 0.0)
+        TorporSlothCircuitT()
+            : SlothCircuitT<real_t, stats_t>(TorporParameters::timeDilation, TorporParameters::w0)
             {}
     };
 
 
-    class ApathySlothCircuit : public SlothCircuit
+    template <typename real_t, typename stats_t = SlothNoStats>
+    class ApathySlothCircuitT : public SlothCircuitT<real_t, stats_t>
     {
     public:
-        ApathySlothCircuit()
-            : SlothCircuit(0.27391343022607395, +0.017)
+        ApathySlothCircuitT()
+            : SlothCircuitT<real_t, stats_t>(ApathyParameters::timeDilation, ApathyParameters::w0)
             {}
     };
 
 
-    class InertiaSlothCircuit : public SlothCircuit
+    template <typename real_t, typename stats_t = SlothNoStats>
+    class InertiaSlothCircuitT : public SlothCircuitT<real_t, stats_t>
     {
     public:
-        InertiaSlothCircuit()
-            : SlothCircuit(0.009697118406631193, -0.023)
+        InertiaSlothCircuitT()
+            : SlothCircuitT<real_t, stats_t>(InertiaParameters::timeDilation, InertiaParameters::w0)
             {}
     };
+
+
+    using TorporSlothCircuit  = TorporSlothCircuitT<double>;
+    using ApathySlothCircuit  = ApathySlothCircuitT<double>;
+    using InertiaSlothCircuit = InertiaSlothCircuitT<double>;
 }
@@ -0,0 +1,244 @@
+/*
+    SlothControlRate.hpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Runs a Sloth circuit at a reduced internal "control rate",
+    stepping the simulation once every `ratio` audio samples,
+    and reconstructs audio-rate output by interpolation.
+
+    The slower variants (Apathy and especially Inertia) change so little
+    from one audio sample to the next that this saves most of the CPU time
+    with no audible difference, which makes them cheap modulation sources.
+*/
+#pragma once
+
+#include "SlothCircuit.hpp"
+
+namespace Analog
+{
+    enum class SlothInterpolation
+    {
+        Linear,     // straight lines between internal samples
+        Cubic,      // Catmull-Rom spline through internal samples; output lags by one internal step
+    };
+
+
+    template <typename circuit_t>
+    class ControlRateSlothCircuit : protected SlothComponents
+    {
+    private:
+        circuit_t circuit;
+
+        bool automaticRatio = true;
+        int ratio = 1;                      // audio samples per internal step
+        int maxRatio = 64;                  // upper limit for the automatic ratio
+        double maxError = 0.001;            // error bound in volts for the automatic ratio
+        float ratioSampleRateHz = 0.0f;     // the sample rate the automatic ratio was chosen for
+        SlothInterpolation interpolation = SlothInterpolation::Linear;
+
+        // The most recent internal samples of (x, y, z): history[0] is the newest.
+        double history[4][3]{};
+        int phase = 0;                      // audio samples elapsed since the newest internal sample
+
+        double xOut{};
+        double yOut{};
+        double zOut{};
+
+        void resetHistory()
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                history[i][0] = circuit.xVoltage();
+                history[i][1] = circuit.yVoltage();
+                history[i][2] = circuit.zVoltage();
+            }
+            phase = 0;
+            xOut = circuit.xVoltage();
+            yOut = circuit.yVoltage();
+            zOut = circuit.zVoltage();
+        }
+
+        static double catmullRom(double p0, double p1, double p2, double p3, double t)
+        {
+            // Interpolate between p1 and p2, using p0 and p3 to estimate the slopes.
+            return p1 + 0.5*t*((p2 - p0) + t*((2*p0 - 5*p1 + 4*p2 - p3) + t*(3*(p1 - p2) + p3 - p0)));
+        }
+
+    public:
+        ControlRateSlothCircuit()
+        {
+            resetHistory();
+        }
+
+        static double estimatedError(double timeDilation, double sampleRateHz, int ratio)
+        {
+            // Estimates the worst-case interpolation error in volts, for a variant
+            // with the given time dilation stepped once every `ratio` audio samples.
+            // The state changes fastest, relative to itself, at a rate bounded by the
+            // largest row sum of the linear system's matrix A (see README), using the
+            // smallest possible K. Linear interpolation of a smooth curve then has an
+            // error of about (rate*h)^2/8 of the full voltage range.
+            // When Q toggles, dx/dt jumps by (QPOS-QNEG)/(R2*C1), putting a kink in x.
+            // Interpolating across the kink leaves an error of about a quarter of the
+            // slope change times the step. The kink usually dominates, so this bound
+            // is also a reasonable one for cubic interpolation.
+            const double Kmin = 100.0e+3;
+            const double rate = std::max({
+                1/(C1*Kmin) + R4/(C1*R1*R5),
+                (1/C3)*(1/R6 + (1/R6 + 1/Kmin + 1/R7)),
+                1/(R7*C2)
+            });
+            const double h = ratio * timeDilation / sampleRateHz;     // circuit time per internal step
+            const double smooth = (VPOS - VNEG) * (rate*h) * (rate*h) / 8;
+            const double kink = ((QPOS - QNEG) / (R2*C1)) * h / 4;
+            return std::max(smooth, kink);
+        }
+
+        static int chooseRatio(double timeDilation, double sampleRateHz, double maxError, int maxRatio)
+        {
+            // Choose the largest power of two, up to maxRatio, whose estimated error is within maxError.
+            int r = 1;
+            while (2*r <= maxRatio && estimatedError(timeDilation, sampleRateHz, 2*r) <= maxError)
+                r *= 2;
+            return r;
+        }
+
+        circuit_t& internalCircuit()
+        {
+            // Allows the caller to configure the internal circuit, for example setIntegrator.
+            return circuit;
+        }
+
+        void initialize()
+        {
+            circuit.initialize();
+            resetHistory();
+        }
+
+        void setAutomaticRatio(double errorVolts, int maximumRatio = 64)
+        {
+            // Choose the ratio automatically from the variant's time dilation,
+            // the sample rate, and an interpolation error bound in volts.
+            automaticRatio = true;
+            maxError = errorVolts;
+            maxRatio = std::max(1, maximumRatio);
+            ratioSampleRateHz = 0.0f;
+        }
+
+        void setRatio(int audioSamplesPerStep)
+        {
+            // Use a fixed number of audio samples per internal step.
+            automaticRatio = false;
+            ratio = std::max(1, audioSamplesPerStep);
+            phase = 0;
+        }
+
+        int getRatio() const
+        {
+            return ratio;
+        }
+
+        void setInterpolation(SlothInterpolation method)
+        {
+            interpolation = method;
+        }
+
+        void setKnobPosition(double fraction)
+        {
+            // Knob and CV changes take effect at the next internal step.
+            circuit.setKnobPosition(fraction);
+        }
+
+        void setControlVoltage(double cv)
+        {
+            circuit.setControlVoltage(cv);
+        }
+
+        double xVoltage() const
+        {
+            return xOut;
+        }
+
+        double yVoltage() const
+        {
+            return yOut;
+        }
+
+        double zVoltage() const
+        {
+            return zOut;
+        }
+
+        int update(float sampleRateHz)
+        {
+            // Generates one audio sample. Returns the number of iterations the internal
+            // circuit needed, or 0 if this sample was interpolated without a circuit step.
+            // Each internal step advances the circuit to the end of the next `ratio` audio
+            // samples, so linear interpolation tracks the circuit without any delay.
+
+            if (automaticRatio && sampleRateHz != ratioSampleRateHz)
+            {
+                ratio = chooseRatio(circuit.timeDilationFactor(), sampleRateHz, maxError, maxRatio);
+                ratioSampleRateHz = sampleRateHz;
+                phase = 0;
+            }
+
+            int iter = 0;
+            if (phase == 0)
+            {
+                iter = circuit.update(sampleRateHz / ratio);
+                for (int i = 3; i > 0; --i)
+                    for (int k = 0; k < 3; ++k)
+                        history[i][k] = history[i-1][k];
+                history[0][0] = circuit.xVoltage();
+                history[0][1] = circuit.yVoltage();
+                history[0][2] = circuit.zVoltage();
+            }
+
+            ++phase;
+            const double t = static_cast<double>(phase) / ratio;
+            double out[3];
+            for (int k = 0; k < 3; ++k)
+            {
+                if (interpolation == SlothInterpolation::Cubic)
+                    out[k] = catmullRom(history[3][k], history[2][k], history[1][k], history[0][k], t);
+                else
+                    out[k] = history[1][k] + t*(history[0][k] - history[1][k]);
+            }
+            xOut = out[0];
+            yOut = out[1];
+            zOut = out[2];
+
+            if (phase == ratio)
+                phase = 0;
+
+            return iter;
+        }
+
+        void process(
+            float sampleRateHz,
+            int nSamples,
+            float *xOutput,
+            float *yOutput,
+            float *zOutput,
+            const float *cvInput = nullptr,
+            const float *knobInput = nullptr)
+        {
+            // Generates a block of samples, like SlothCircuit::process.
+            // The CV and knob buffers are sampled at the control rate.
+            for (int s = 0; s < nSamples; ++s)
+            {
+                if (phase == 0)
+                {
+                    if (cvInput) circuit.setControlVoltage(cvInput[s]);
+                    if (knobInput) circuit.setKnobPosition(knobInput[s]);
+                }
+
+                update(sampleRateHz);
+
+                if (xOutput) xOutput[s] = static_cast<float>(xOut);
+                if (yOutput) yOutput[s] = static_cast<float>(yOut);
+                if (zOutput) zOutput[s] = static_cast<float>(zOut);
+            }
+        }
+    };
+}
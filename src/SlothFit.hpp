@@ -0,0 +1,397 @@
+/*
+    SlothFit.hpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Fits the simulation's component values to voltage logs captured
+    from the Sloth hardware (see SlothLog.hpp).
+
+    The circuit is chaotic, so a simulation can never follow a hardware
+    log point by point, no matter how accurate the component values are.
+    Instead we compare statistical signatures of the two trajectories:
+
+    - histograms of the x, y, and z voltages,
+    - the normalized power spectrum of x,
+    - the rate at which z changes polarity.
+
+    The fitter searches for component values that minimize the distance
+    between the signatures of the simulation and the hardware logs, using
+    the cross-entropy method: each generation samples a population of
+    candidates around the current estimate, simulates all of them,
+    and moves the estimate toward the best few. Every candidate/log pair
+    is a lane in a SlothBank, and the banks are spread across the threads
+    of a SlothThreadPool, so a whole generation is one batched run.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "SlothBank.hpp"
+#include "SlothLog.hpp"
+#include "SlothPool.hpp"
+
+namespace Analog
+{
+    struct SlothSignature
+    {
+        static constexpr int HistogramBins = 48;        // covering [-12 V, +12 V]
+        static constexpr int SegmentLength = 256;       // samples per spectrum segment
+        static constexpr int SpectrumBins = 32;         // groups of SegmentLength/2/SpectrumBins frequencies
+
+        double histogram[3][HistogramBins]{};           // fractions of samples; x, y, z
+        double spectrum[SpectrumBins]{};                // fractions of total power
+        double crossingsPerSecond = 0.0;
+    };
+
+
+    class SlothSignatureBuilder
+    {
+    private:
+        static constexpr int B = SlothSignature::HistogramBins;
+        static constexpr int L = SlothSignature::SegmentLength;
+        static constexpr int S = SlothSignature::SpectrumBins;
+        static constexpr double hysteresis = 0.1;       // volts; keeps measurement noise from counting as crossings
+
+        const double intervalSeconds;
+        long count[3][B]{};
+        long samples = 0;
+
+        double segment[L]{};
+        int segmentIndex = 0;
+        double power[S]{};
+
+        long crossings = 0;
+        int polarity = 0;
+
+        struct Tables
+        {
+            double window[L];       // Hann window
+            double cosine[L];       // cos(2*pi*n/L)
+            double sine[L];         // sin(2*pi*n/L)
+
+            Tables()
+            {
+                const double pi = 3.14159265358979323846;
+                for (int n = 0; n < L; ++n)
+                {
+                    window[n] = 0.5 - 0.5*std::cos((2*pi*n)/L);
+                    cosine[n] = std::cos((2*pi*n)/L);
+                    sine[n] = std::sin((2*pi*n)/L);
+                }
+            }
+        };
+
+        static const Tables& tables()
+        {
+            static const Tables t;
+            return t;
+        }
+
+        void addSegment()
+        {
+            // Accumulate the Hann-windowed power spectrum of a completed segment.
+            const Tables& t = tables();
+            double mean = 0.0;
+            for (int n = 0; n < L; ++n)
+                mean += segment[n];
+            mean /= L;
+
+            double v[L];
+            for (int n = 0; n < L; ++n)
+                v[n] = t.window[n] * (segment[n] - mean);
+
+            for (int k = 1; k <= L/2; ++k)
+            {
+                double re = 0.0;
+                double im = 0.0;
+                for (int n = 0; n < L; ++n)
+                {
+                    int a = (k*n) % L;
+                    re += v[n] * t.cosine[a];
+                    im -= v[n] * t.sine[a];
+                }
+                power[(k-1) * S / (L/2)] += re*re + im*im;
+            }
+        }
+
+    public:
+        explicit SlothSignatureBuilder(double _intervalSeconds)
+            : intervalSeconds(_intervalSeconds)
+            {}
+
+        void add(double x, double y, double z)
+        {
+            // Add one sample, taken `intervalSeconds` after the previous one.
+            const double v[3] = {x, y, z};
+            for (int i = 0; i < 3; ++i)
+            {
+                int bin = static_cast<int>(std::floor((v[i] + 12.0) * (B / 24.0)));
+                ++count[i][std::max(0, std::min(B-1, bin))];
+            }
+            ++samples;
+
+            segment[segmentIndex] = x;
+            if (++segmentIndex == L)
+            {
+                addSegment();
+                segmentIndex = 0;
+            }
+
+            int p = (z > +hysteresis) ? +1 : ((z < -hysteresis) ? -1 : polarity);
+            if (polarity != 0 && p != polarity)
+                ++crossings;
+            polarity = p;
+        }
+
+        SlothSignature signature() const
+        {
+            SlothSignature sig;
+            if (samples > 0)
+            {
+                for (int i = 0; i < 3; ++i)
+                    for (int b = 0; b < B; ++b)
+                        sig.histogram[i][b] = static_cast<double>(count[i][b]) / samples;
+                sig.crossingsPerSecond = crossings / (samples * intervalSeconds);
+            }
+
+            double total = 0.0;
+            for (int s = 0; s < S; ++s)
+                total += power[s];
+            if (total > 0.0)
+                for (int s = 0; s < S; ++s)
+                    sig.spectrum[s] = power[s] / total;
+
+            return sig;
+        }
+    };
+
+
+    inline double SignatureDistance(const SlothSignature& a, const SlothSignature& b)
+    {
+        // Each histogram and spectrum term is a total variation distance in [0, 1].
+        // The crossing rates are compared by the logarithm of their ratio.
+        double hist = 0.0;
+        for (int i = 0; i < 3; ++i)
+            for (int k = 0; k < SlothSignature::HistogramBins; ++k)
+                hist += std::abs(a.histogram[i][k] - b.histogram[i][k]);
+
+        double spec = 0.0;
+        for (int k = 0; k < SlothSignature::SpectrumBins; ++k)
+            spec += std::abs(a.spectrum[k] - b.spectrum[k]);
+
+        const double eps = 1.0e-3;
+        double rate = std::abs(std::log((a.crossingsPerSecond + eps) / (b.crossingsPerSecond + eps)));
+
+        return hist/6 + spec/2 + rate/2;
+    }
+
+
+    inline SlothSignature LogSignature(const SlothLog& log, double skipSeconds, int rowLimit = -1)
+    {
+        // Returns the signature of a hardware log, ignoring its first `skipSeconds`
+        // and, if `rowLimit` is not negative, all rows from `rowLimit` onward.
+        // If the log's sample interval is irregular, its mean interval is used.
+        double interval = log.intervalMillis();
+        if (interval <= 0.0 && log.rowCount() > 1)
+            interval = static_cast<double>(log.millis()[log.rowCount()-1] - log.millis()[0]) / (log.rowCount() - 1);
+        interval = std::max(1.0, interval);
+        SlothSignatureBuilder builder(interval / 1000.0);
+        const int first = static_cast<int>(std::ceil(skipSeconds * 1000.0 / interval));
+        const int last = (rowLimit < 0) ? log.rowCount() : std::min(rowLimit, log.rowCount());
+        for (int r = std::max(0, first); r < last; ++r)
+            builder.add(log.xVoltage(r), log.yVoltage(r), log.zVoltage(r));
+        return builder.signature();
+    }
+
+
+    // A measurement to fit: the signature of a hardware log and the settings it was recorded with.
+    struct SlothFitTarget
+    {
+        SlothSignature signature;
+        double knob = 0.0;
+        double cv = 0.0;
+        double seconds = 0.0;               // duration of the log after its skipped beginning
+        double intervalSeconds = 0.2;       // time between log rows
+    };
+
+
+    struct SlothFitSpec
+    {
+        // The component values to fit. All others keep their values in `initial`.
+        std::vector<double SlothComponentValues::*> variables {&SlothComponentValues::C2};
+        SlothComponentValues initial;
+        double initialSpread = 0.2;         // standard deviation of the log of each variable
+        double minimumSpread = 0.002;       // stop when the spread of every variable falls below this
+        int population = 32;
+        int elite = 6;
+        int generations = 20;
+        float sampleRateHz = 4000.0f;       // simulation rate; far lower than audio suffices for statistics
+        double skipSeconds = 60.0;          // settling time simulated before measuring
+        unsigned seed = 1;
+    };
+
+
+    struct SlothFitResult
+    {
+        SlothComponentValues best;
+        double distance = 0.0;
+        int generations = 0;
+    };
+
+
+    class SlothFitter
+    {
+    private:
+        static constexpr int LANES = 8;
+        using bank_t = SlothBank<LANES>;
+
+        SlothThreadPool& pool;
+        const std::vector<SlothFitTarget>& targets;
+        const SlothFitSpec& spec;
+
+        // The batch being evaluated: lane i of the whole batch simulates
+        // candidate i / targets.size() against target i % targets.size().
+        const std::vector<SlothComponentValues> *batch = nullptr;
+        std::vector<double> laneDistance;
+
+        int laneCount() const
+        {
+            return static_cast<int>(batch->size() * targets.size());
+        }
+
+    public:
+        SlothFitter(SlothThreadPool& _pool, const std::vector<SlothFitTarget>& _targets, const SlothFitSpec& _spec)
+            : pool(_pool)
+            , targets(_targets)
+            , spec(_spec)
+            {}
+
+        void operator() (int task)
+        {
+            // Simulate one bank of candidate/target pairs.
+            const int first = task * LANES;
+            const int count = std::min(LANES, laneCount() - first);
+            const int nt = static_cast<int>(targets.size());
+
+            bank_t bank;
+            double seconds = 0.0;
+            double interval = targets[0].intervalSeconds;
+            for (int i = 0; i < count; ++i)
+            {
+                const SlothFitTarget& t = targets[(first + i) % nt];
+                TorporSlothCircuit circuit;
+                circuit.setKnobPosition(t.knob);
+                circuit.setControlVoltage(t.cv);
+                bank.setVoice(i, circuit);
+                bank.setComponents(i, (*batch)[(first + i) / nt]);
+                seconds = std::max(seconds, t.seconds);
+                interval = t.intervalSeconds;
+            }
+
+            const long skip = static_cast<long>(spec.skipSeconds * spec.sampleRateHz);
+            for (long s = 0; s < skip; ++s)
+                bank.update(spec.sampleRateHz);
+
+            // The targets are assumed to share one log interval.
+            const long stride = std::max(1L, std::lround(interval * spec.sampleRateHz));
+            const long rows = static_cast<long>(seconds / interval);
+            std::vector<SlothSignatureBuilder> builders(count, SlothSignatureBuilder(interval));
+            for (long r = 0; r < rows; ++r)
+            {
+                for (long s = 0; s < stride; ++s)
+                    bank.update(spec.sampleRateHz);
+                for (int i = 0; i < count; ++i)
+                    builders[i].add(bank.xVoltage(i), bank.yVoltage(i), bank.zVoltage(i));
+            }
+
+            for (int i = 0; i < count; ++i)
+                laneDistance[first + i] = SignatureDistance(builders[i].signature(), targets[(first + i) % nt].signature);
+        }
+
+        std::vector<double> evaluate(const std::vector<SlothComponentValues>& candidates)
+        {
+            // Returns the mean signature distance over all targets for each candidate.
+            batch = &candidates;
+            laneDistance.assign(laneCount(), 0.0);
+            pool.run((laneCount() + LANES - 1) / LANES, *this);
+
+            std::vector<double> distance(candidates.size(), 0.0);
+            for (int i = 0; i < laneCount(); ++i)
+                distance[i / targets.size()] += laneDistance[i] / targets.size();
+            batch = nullptr;
+            return distance;
+        }
+
+        SlothFitResult fit(void (*progress)(int generation, const SlothFitResult& result, const std::vector<double>& spread) = nullptr)
+        {
+            const int nv = static_cast<int>(spec.variables.size());
+            std::vector<double> mean(nv), spread(nv, spec.initialSpread);
+            for (int v = 0; v < nv; ++v)
+                mean[v] = std::log(std::abs(spec.initial.*spec.variables[v]));
+
+            std::mt19937 rng(spec.seed);
+            std::normal_distribution<double> normal;
+            std::vector<SlothComponentValues> candidates(std::max(1, spec.population));
+            std::vector<std::vector<double>> logs(candidates.size(), std::vector<double>(nv));
+            const int elite = std::max(1, std::min(spec.elite, static_cast<int>(candidates.size())));
+
+            SlothFitResult result;
+            result.best = spec.initial;
+            result.distance = evaluate({spec.initial})[0];
+
+            for (int g = 0; g < spec.generations; ++g)
+            {
+                // Sample candidates around the current estimate. The first candidate is the estimate itself.
+                // Each variable is varied in proportion to its magnitude, keeping its sign.
+                for (std::size_t c = 0; c < candidates.size(); ++c)
+                {
+                    candidates[c] = spec.initial;
+                    for (int v = 0; v < nv; ++v)
+                    {
+                        double sign = (spec.initial.*spec.variables[v] < 0.0) ? -1.0 : +1.0;
+                        logs[c][v] = mean[v] + ((c == 0) ? 0.0 : spread[v] * normal(rng));
+                        candidates[c].*spec.variables[v] = sign * std::exp(logs[c][v]);
+                    }
+                }
+
+                std::vector<double> distance = evaluate(candidates);
+                std::vector<int> order(candidates.size());
+                for (std::size_t c = 0; c < order.size(); ++c)
+                    order[c] = static_cast<int>(c);
+                std::sort(order.begin(), order.end(), [&distance](int a, int b){ return distance[a] < distance[b]; });
+
+                if (distance[order[0]] < result.distance)
+                {
+                    result.distance = distance[order[0]];
+                    result.best = candidates[order[0]];
+                }
+                result.generations = g + 1;
+
+                // Move the estimate to the mean of the best candidates, and shrink
+                // the spread to theirs, which narrows the search as it converges.
+                bool converged = true;
+                for (int v = 0; v < nv; ++v)
+                {
+                    double sum = 0.0;
+                    for (int e = 0; e < elite; ++e)
+                        sum += logs[order[e]][v];
+                    mean[v] = sum / elite;
+
+                    double var = 0.0;
+                    for (int e = 0; e < elite; ++e)
+                        var += (logs[order[e]][v] - mean[v]) * (logs[order[e]][v] - mean[v]);
+                    spread[v] = std::sqrt(var / elite);
+                    if (spread[v] >= spec.minimumSpread)
+                        converged = false;
+                }
+
+                if (progress != nullptr)
+                    progress(g, result, spread);
+
+                if (converged)
+                    break;
+            }
+            return result;
+        }
+    };
+}
@@ -0,0 +1,494 @@
+/*
+    SlothKernels.hpp  -  generated by kernelgen.cpp. Do not edit.
+
+    Update kernels for the Sloth variants, derived from their netlists.
+    Run the script `kg` to regenerate this file.
+*/
+#pragma once
+
+#include <algorithm>
+
+namespace Analog
+{
+    // Generated from SlothNetlist<TorporParameters> with the knob at 0.
+    // State variables are capacitor voltages:
+    //     s0 = v[1] - v[2]
+    //     s1 = v[4] - v[5]
+    //     s2 = v[3] - v[0]
+    class TorporKernel
+    {
+    private:
+        // The state equations: ds/dt = D [s, u, q].
+        static constexpr double D0_1 = 0.5;
+        static constexpr double D0_2 = 5.0000000000000009;
+        static constexpr double D0_3 = -0.10638297872340427;
+        static constexpr double D0_4 = 0.10638297872340427;
+        static constexpr double D1_2 = 7.042253521126761;
+        static constexpr double D2_0 = -0.20000000000000001;
+        static constexpr double D2_2 = -0.60000000000000009;
+
+        float coefSampleRateHz = 0.0f;
+        double d0_1{};     // dt * D0_1
+        double d0_2{};     // dt * D0_2
+        double d0_3{};     // dt * D0_3
+        double d0_4{};     // dt * D0_4
+        double d1_2{};     // dt * D1_2
+        double d2_0{};     // dt * D2_0
+        double d2_2{};     // dt * D2_2
+        double s0{};
+        double s1{};
+        double s2{};
+        double u0{};
+
+        static double Q0(double v)
+        {
+            return (v < 0) ? 11.380000000000001 : -10.640000000000001;
+        }
+
+        double v0() const
+        {
+            return 0.99999999999999989*s1 - 0.21276595744680851*u0;
+        }
+
+        double q0() const
+        {
+            return Q0(v0());
+        }
+
+        void calculate(double dt)
+        {
+            d0_1 = dt * D0_1;
+            d0_2 = dt * D0_2;
+            d0_3 = dt * D0_3;
+            d0_4 = dt * D0_4;
+            d1_2 = dt * D1_2;
+            d2_0 = dt * D2_0;
+            d2_2 = dt * D2_2;
+        }
+
+    public:
+        static constexpr double tolerance = 1.0e-12;
+        int iterationLimit = 5;
+
+        TorporKernel()
+        {
+            initialize();
+        }
+
+        void initialize()
+        {
+            s0 = 0.0;
+            s1 = 0.0;
+            s2 = 0.0;
+            u0 = 0.0;
+        }
+
+        void setControlVoltage(double voltage)
+        {
+            u0 = std::max(-12.0, std::min(12.0, voltage));
+        }
+
+        double xVoltage() const
+        {
+            return -s0;
+        }
+
+        double wVoltage() const
+        {
+            return s2;
+        }
+
+        double yVoltage() const
+        {
+            return -s1;
+        }
+
+        double zVoltage() const
+        {
+            return 0.99999999999999989*s1 - 0.21276595744680851*u0;
+        }
+
+        int update(float sampleRateHz)
+        {
+            // Advances the circuit by one sample.
+            // Returns the number of iterations needed for convergence [2..iterationLimit].
+            if (sampleRateHz != coefSampleRateHz)
+            {
+                calculate(1.0 / sampleRateHz);
+                coefSampleRateHz = sampleRateHz;
+            }
+
+            // The inputs are constant over the time step.
+            const double f0 = d0_3*u0;
+            const double vs0 = v0();
+
+            // Start with crude estimates that the voltages remain constant over the time step.
+            double sm0 = s0;
+            double sm1 = s1;
+            double sm2 = s2;
+            double qm0 = Q0(vs0);
+            double e0 = 0.0;
+            double e1 = 0.0;
+            double e2 = 0.0;
+
+            const double toleranceSquared = tolerance * tolerance;
+            for (int iter = 1; true; ++iter)
+            {
+                const double ds0 = d0_1*sm1 + d0_2*sm2 + f0 + d0_4*qm0;
+                const double ds1 = d1_2*sm2;
+                const double ds2 = d2_0*sm0 + d2_2*sm2;
+                const double ve0 = 0.99999999999999989*(s1 + ds1) - 0.21276595744680851*u0;
+
+                if (iter > 1)
+                {
+                    const double variance = (ds0 - e0)*(ds0 - e0) + (ds1 - e1)*(ds1 - e1) + (ds2 - e2)*(ds2 - e2);
+                    if (variance < toleranceSquared || iter >= iterationLimit)
+                    {
+                        s0 += ds0;
+                        s1 += ds1;
+                        s2 += ds2;
+                        return iter;
+                    }
+                }
+
+                sm0 = s0 + ds0/2;
+                sm1 = s1 + ds1/2;
+                sm2 = s2 + ds2/2;
+                if (vs0 * ve0 >= 0)
+                {
+                    qm0 = Q0((vs0 + ve0)/2);
+                }
+                else
+                {
+                    const double alpha = vs0 / (vs0 - ve0);
+                    qm0 = alpha*Q0(vs0) + (1-alpha)*Q0(ve0);
+                }
+                e0 = ds0;
+                e1 = ds1;
+                e2 = ds2;
+            }
+        }
+    };
+
+
+    // Generated from SlothNetlist<ApathyParameters> with the knob at 0.
+    // State variables are capacitor voltages:
+    //     s0 = v[1] - v[2]
+    //     s1 = v[4] - v[5]
+    //     s2 = v[3] - v[0]
+    class ApathyKernel
+    {
+    private:
+        // The state equations: ds/dt = D [s, u, q].
+        static constexpr double D0_1 = 0.13695671511303698;
+        static constexpr double D0_2 = 1.36956715113037;
+        static constexpr double D0_3 = -0.029139726619795102;
+        static constexpr double D0_4 = 0.029139726619795102;
+        static constexpr double D1_2 = 1.9289678184934789;
+        static constexpr double D2_0 = -0.054782686045214794;
+        static constexpr double D2_2 = -0.16434805813564438;
+
+        float coefSampleRateHz = 0.0f;
+        double d0_1{};     // dt * D0_1
+        double d0_2{};     // dt * D0_2
+        double d0_3{};     // dt * D0_3
+        double d0_4{};     // dt * D0_4
+        double d1_2{};     // dt * D1_2
+        double d2_0{};     // dt * D2_0
+        double d2_2{};     // dt * D2_2
+        double s0{};
+        double s1{};
+        double s2{};
+        double u0{};
+
+        static double Q0(double v)
+        {
+            return (v < 0) ? 11.380000000000001 : -10.640000000000001;
+        }
+
+        double v0() const
+        {
+            return 0.99999999999999989*s1 - 0.21276595744680851*u0;
+        }
+
+        double q0() const
+        {
+            return Q0(v0());
+        }
+
+        void calculate(double dt)
+        {
+            d0_1 = dt * D0_1;
+            d0_2 = dt * D0_2;
+            d0_3 = dt * D0_3;
+            d0_4 = dt * D0_4;
+            d1_2 = dt * D1_2;
+            d2_0 = dt * D2_0;
+            d2_2 = dt * D2_2;
+        }
+
+    public:
+        static constexpr double tolerance = 1.0e-12;
+        int iterationLimit = 5;
+
+        ApathyKernel()
+        {
+            initialize();
+        }
+
+        void initialize()
+        {
+            s0 = 0.0;
+            s1 = 0.0;
+            s2 = 0.017000000000000001;
+            u0 = 0.0;
+        }
+
+        void setControlVoltage(double voltage)
+        {
+            u0 = std::max(-12.0, std::min(12.0, voltage));
+        }
+
+        double xVoltage() const
+        {
+            return -s0;
+        }
+
+        double wVoltage() const
+        {
+            return s2;
+        }
+
+        double yVoltage() const
+        {
+            return -s1;
+        }
+
+        double zVoltage() const
+        {
+            return 0.99999999999999989*s1 - 0.21276595744680851*u0;
+        }
+
+        int update(float sampleRateHz)
+        {
+            // Advances the circuit by one sample.
+            // Returns the number of iterations needed for convergence [2..iterationLimit].
+            if (sampleRateHz != coefSampleRateHz)
+            {
+                calculate(1.0 / sampleRateHz);
+                coefSampleRateHz = sampleRateHz;
+            }
+
+            // The inputs are constant over the time step.
+            const double f0 = d0_3*u0;
+            const double vs0 = v0();
+
+            // Start with crude estimates that the voltages remain constant over the time step.
+            double sm0 = s0;
+            double sm1 = s1;
+            double sm2 = s2;
+            double qm0 = Q0(vs0);
+            double e0 = 0.0;
+            double e1 = 0.0;
+            double e2 = 0.0;
+
+            const double toleranceSquared = tolerance * tolerance;
+            for (int iter = 1; true; ++iter)
+            {
+                const double ds0 = d0_1*sm1 + d0_2*sm2 + f0 + d0_4*qm0;
+                const double ds1 = d1_2*sm2;
+                const double ds2 = d2_0*sm0 + d2_2*sm2;
+                const double ve0 = 0.99999999999999989*(s1 + ds1) - 0.21276595744680851*u0;
+
+                if (iter > 1)
+                {
+                    const double variance = (ds0 - e0)*(ds0 - e0) + (ds1 - e1)*(ds1 - e1) + (ds2 - e2)*(ds2 - e2);
+                    if (variance < toleranceSquared || iter >= iterationLimit)
+                    {
+                        s0 += ds0;
+                        s1 += ds1;
+                        s2 += ds2;
+                        return iter;
+                    }
+                }
+
+                sm0 = s0 + ds0/2;
+                sm1 = s1 + ds1/2;
+                sm2 = s2 + ds2/2;
+                if (vs0 * ve0 >= 0)
+                {
+                    qm0 = Q0((vs0 + ve0)/2);
+                }
+                else
+                {
+                    const double alpha = vs0 / (vs0 - ve0);
+                    qm0 = alpha*Q0(vs0) + (1-alpha)*Q0(ve0);
+                }
+                e0 = ds0;
+                e1 = ds1;
+                e2 = ds2;
+            }
+        }
+    };
+
+
+    // Generated from SlothNetlist<InertiaParameters> with the knob at 0.
+    // State variables are capacitor voltages:
+    //     s0 = v[1] - v[2]
+    //     s1 = v[4] - v[5]
+    //     s2 = v[3] - v[0]
+    class InertiaKernel
+    {
+    private:
+        // The state equations: ds/dt = D [s, u, q].
+        static constexpr double D0_1 = 0.0048485592033155967;
+        static constexpr double D0_2 = 0.048485592033155972;
+        static constexpr double D0_3 = -0.0010316083411309781;
+        static constexpr double D0_4 = 0.0010316083411309781;
+        static constexpr double D1_2 = 0.068289566243881647;
+        static constexpr double D2_0 = -0.0019394236813262389;
+        static constexpr double D2_2 = -0.0058182710439787172;
+
+        float coefSampleRateHz = 0.0f;
+        double d0_1{};     // dt * D0_1
+        double d0_2{};     // dt * D0_2
+        double d0_3{};     // dt * D0_3
+        double d0_4{};     // dt * D0_4
+        double d1_2{};     // dt * D1_2
+        double d2_0{};     // dt * D2_0
+        double d2_2{};     // dt * D2_2
+        double s0{};
+        double s1{};
+        double s2{};
+        double u0{};
+
+        static double Q0(double v)
+        {
+            return (v < 0) ? 11.380000000000001 : -10.640000000000001;
+        }
+
+        double v0() const
+        {
+            return 0.99999999999999989*s1 - 0.21276595744680851*u0;
+        }
+
+        double q0() const
+        {
+            return Q0(v0());
+        }
+
+        void calculate(double dt)
+        {
+            d0_1 = dt * D0_1;
+            d0_2 = dt * D0_2;
+            d0_3 = dt * D0_3;
+            d0_4 = dt * D0_4;
+            d1_2 = dt * D1_2;
+            d2_0 = dt * D2_0;
+            d2_2 = dt * D2_2;
+        }
+
+    public:
+        static constexpr double tolerance = 1.0e-12;
+        int iterationLimit = 5;
+
+        InertiaKernel()
+        {
+            initialize();
+        }
+
+        void initialize()
+        {
+            s0 = 0.0;
+            s1 = 0.0;
+            s2 = -0.023;
+            u0 = 0.0;
+        }
+
+        void setControlVoltage(double voltage)
+        {
+            u0 = std::max(-12.0, std::min(12.0, voltage));
+        }
+
+        double xVoltage() const
+        {
+            return -s0;
+        }
+
+        double wVoltage() const
+        {
+            return s2;
+        }
+
+        double yVoltage() const
+        {
+            return -s1;
+        }
+
+        double zVoltage() const
+        {
+            return 0.99999999999999989*s1 - 0.21276595744680851*u0;
+        }
+
+        int update(float sampleRateHz)
+        {
+            // Advances the circuit by one sample.
+            // Returns the number of iterations needed for convergence [2..iterationLimit].
+            if (sampleRateHz != coefSampleRateHz)
+            {
+                calculate(1.0 / sampleRateHz);
+                coefSampleRateHz = sampleRateHz;
+            }
+
+            // The inputs are constant over the time step.
+            const double f0 = d0_3*u0;
+            const double vs0 = v0();
+
+            // Start with crude estimates that the voltages remain constant over the time step.
+            double sm0 = s0;
+            double sm1 = s1;
+            double sm2 = s2;
+            double qm0 = Q0(vs0);
+            double e0 = 0.0;
+            double e1 = 0.0;
+            double e2 = 0.0;
+
+            const double toleranceSquared = tolerance * tolerance;
+            for (int iter = 1; true; ++iter)
+            {
+                const double ds0 = d0_1*sm1 + d0_2*sm2 + f0 + d0_4*qm0;
+                const double ds1 = d1_2*sm2;
+                const double ds2 = d2_0*sm0 + d2_2*sm2;
+                const double ve0 = 0.99999999999999989*(s1 + ds1) - 0.21276595744680851*u0;
+
+                if (iter > 1)
+                {
+                    const double variance = (ds0 - e0)*(ds0 - e0) + (ds1 - e1)*(ds1 - e1) + (ds2 - e2)*(ds2 - e2);
+                    if (variance < toleranceSquared || iter >= iterationLimit)
+                    {
+                        s0 += ds0;
+                        s1 += ds1;
+                        s2 += ds2;
+                        return iter;
+                    }
+                }
+
+                sm0 = s0 + ds0/2;
+                sm1 = s1 + ds1/2;
+                sm2 = s2 + ds2/2;
+                if (vs0 * ve0 >= 0)
+                {
+                    qm0 = Q0((vs0 + ve0)/2);
+                }
+                else
+                {
+                    const double alpha = vs0 / (vs0 - ve0);
+                    qm0 = alpha*Q0(vs0) + (1-alpha)*Q0(ve0);
+                }
+                e0 = ds0;
+                e1 = ds1;
+                e2 = ds2;
+            }
+        }
+    };
+}
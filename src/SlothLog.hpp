@@ -0,0 +1,565 @@
+/*
+    SlothLog.hpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Loads the voltage logs captured from the Sloth hardware by the
+    Arduino sketch in hardware/VoltageReader. Each line of a log is
+
+        millis,x,y,z[,w]
+
+    where millis is the Arduino's clock in milliseconds, and the rest are
+    10-bit analogRead values. Older logs do not have the w column.
+
+    SlothLog memory-maps the file and parses it in a single pass with
+    a hand-rolled integer parser, storing each column in its own array.
+    The arrays are sized once from the number of lines in the file,
+    so parsing does not allocate any memory per row.
+
+    A log can also be saved in a compact binary format, which `load`
+    recognizes automatically. The file starts with a SlothLogHeader,
+    holding the sample interval and the coefficients that convert
+    analogRead values to volts. Then come the columns, one after another:
+
+        millis      int32[rowCount], only present if the sample interval is irregular
+        x, y, z, w  each is int16[rowCount] (Packed16 encoding),
+                    or an int16 first value followed by int8[rowCount-1]
+                    differences between consecutive values (Delta8 encoding)
+
+    The w column is only present in 5-column logs. The Delta8 encoding
+    takes about 4 bytes per row, compared to about 20 bytes per row of text.
+*/
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Analog
+{
+    // https://docs.google.com/spreadsheets/d/12UB6mihdSQhdCoypwO_CTBR4rIwEmjkxOjuWeSCxXrg/edit#gid=0
+    // The range a=[18, 1019] maps to circuit voltages [-12, +12].
+    const double ArduinoVoltageScale = 24.0 / (1019.0 - 18.0);
+    const double ArduinoVoltageOffset = -12.0 - 18.0*ArduinoVoltageScale;
+
+    inline double ArduinoVoltage(int a)
+    {
+        return a*ArduinoVoltageScale + ArduinoVoltageOffset;
+    }
+
+
+    // The conversion for the voltage `w`, which is explained in Node3Voltage.
+    const double Node3VoltageScale = (5.0 / 1023.0) / 5.079079079;
+    const double Node3VoltageOffset = -2.52 / 5.079079079;
+
+    inline double Node3Voltage(int a)
+    {
+        // https://docs.google.com/spreadsheets/d/12UB6mihdSQhdCoypwO_CTBR4rIwEmjkxOjuWeSCxXrg/edit#gid=1457893736
+        // I used a different op-amp circuit than the other voltages, because
+        // this node's voltage varies from about -0.25 V to +0.25 V.
+        // I assumed a safe range of -0.5 V to +0.5 V.
+        // Then I chose 4 resistors combined with the op-amp to produce
+        // the formula A = 5*w + 2.5, to convert to the range [0 V, +5 V].
+        // Based on direct measurements, I found the following:
+        // w = -0.499 V     ==>  A = -0.014 V   ==>     -2.96 arduino units
+        // w =  0 V         ==>  A =  2.52 V    ==>    515.59 arduino units
+        // w = +0.500 V     ==>  A = +5.06 V    ==>   1035.18 arduino units
+        // Using these as a reference, I came up with the following formula
+        // for the inferred value of the voltage `w` from the arduino units `a`:
+        // (a*(5.0 / 1023.0) - 2.52) / 5.079079079
+        return a*Node3VoltageScale + Node3VoltageOffset;
+    }
+
+
+    enum class SlothLogEncoding
+    {
+        Packed16,
+        Delta8,
+    };
+
+
+    struct SlothLogHeader
+    {
+        char magic[8];                  // "SLOTHLOG"
+        std::uint32_t version;          // SlothLogVersion
+        std::uint32_t byteOrder;        // SlothLogByteOrder, as written by the generating machine
+        std::uint32_t rowCount;
+        std::uint32_t columnCount;      // 4 or 5, including millis
+        std::uint32_t encoding;         // a SlothLogEncoding value
+        std::int32_t firstMillis;
+        std::uint32_t intervalMillis;   // 0 if irregular, in which case the millis column is stored
+        std::uint32_t reserved;
+        double voltageScale;            // volts = voltageScale*a + voltageOffset, for x, y, z
+        double voltageOffset;
+        double nodeScale;               // volts = nodeScale*a + nodeOffset, for w
+        double nodeOffset;
+    };
+
+    static_assert(sizeof(SlothLogHeader) == 72, "SlothLogHeader must not contain padding.");
+
+    const char SlothLogMagic[8] = {'S', 'L', 'O', 'T', 'H', 'L', 'O', 'G'};
+    const std::uint32_t SlothLogVersion = 1;
+    const std::uint32_t SlothLogByteOrder = 0x01020304;
+
+
+    class SlothLog
+    {
+    private:
+        std::vector<std::int32_t> millisColumn;
+        std::vector<std::int16_t> xColumn;
+        std::vector<std::int16_t> yColumn;
+        std::vector<std::int16_t> zColumn;
+        std::vector<std::int16_t> wColumn;      // empty if the log has no w column
+        int rows = 0;
+        int columns = 0;
+        int errorLine = 0;
+
+        // The conversions from analogRead values to volts.
+        double voltageScale = ArduinoVoltageScale;
+        double voltageOffset = ArduinoVoltageOffset;
+        double nodeScale = Node3VoltageScale;
+        double nodeOffset = Node3VoltageOffset;
+
+        void resize(std::size_t capacity)
+        {
+            millisColumn.resize(capacity);
+            xColumn.resize(capacity);
+            yColumn.resize(capacity);
+            zColumn.resize(capacity);
+            wColumn.resize(capacity);
+        }
+
+        std::int16_t *column(int index)
+        {
+            switch (index)
+            {
+            case 0:  return xColumn.data();
+            case 1:  return yColumn.data();
+            case 2:  return zColumn.data();
+            default: return wColumn.data();
+            }
+        }
+
+        const std::int16_t *column(int index) const
+        {
+            return const_cast<SlothLog *>(this)->column(index);
+        }
+
+        static std::size_t columnBytes(SlothLogEncoding encoding, std::size_t nrows)
+        {
+            if (nrows == 0)
+                return 0;
+            return (encoding == SlothLogEncoding::Delta8) ? (2 + (nrows - 1)) : (2 * nrows);
+        }
+
+    public:
+        bool load(const char *filename)
+        {
+            // Memory-maps and parses the log file, which may be text or binary.
+            // Returns false if the file cannot be read or is not a valid log;
+            // errorLineNumber() then tells which line could not be parsed,
+            // or is zero if the file itself could not be read.
+            errorLine = 0;
+            rows = 0;
+
+            int fd = open(filename, O_RDONLY);
+            if (fd < 0)
+                return false;
+
+            bool ok = false;
+            struct stat info;
+            if (fstat(fd, &info) == 0)
+            {
+                const std::size_t size = static_cast<std::size_t>(info.st_size);
+                if (size == 0)
+                {
+                    ok = parse("", 0);
+                }
+                else
+                {
+                    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (data != MAP_FAILED)
+                    {
+                        if (size >= sizeof(SlothLogMagic) && !std::memcmp(data, SlothLogMagic, sizeof(SlothLogMagic)))
+                            ok = decode(static_cast<const unsigned char *>(data), size);
+                        else
+                            ok = parse(static_cast<const char *>(data), size);
+                        munmap(data, size);
+                    }
+                }
+            }
+            close(fd);
+            return ok;
+        }
+
+        bool parse(const char *text, std::size_t size)
+        {
+            // Parses log text already in memory. Lines may end with "\n" or "\r\n",
+            // and blank lines are ignored. Every row must have the same number
+            // of columns as the first: either 4 or 5.
+            errorLine = 0;
+            rows = 0;
+            columns = 0;
+            voltageScale = ArduinoVoltageScale;
+            voltageOffset = ArduinoVoltageOffset;
+            nodeScale = Node3VoltageScale;
+            nodeOffset = Node3VoltageOffset;
+
+            // Size the arrays for the largest number of rows the text could contain.
+            const char *end = text + size;
+            std::size_t capacity = 1;
+            for (const char *p = text; (p = static_cast<const char *>(std::memchr(p, '\n', end - p))) != nullptr; ++p)
+                ++capacity;
+
+            resize(capacity);
+
+            int line = 0;
+            const char *p = text;
+            while (p < end)
+            {
+                ++line;
+                if (*p == '\r' || *p == '\n')
+                {
+                    // Skip a blank line.
+                    while (p < end && *p != '\n')
+                        ++p;
+                    ++p;
+                    continue;
+                }
+
+                int value[5];
+                int n = 0;
+                while (true)
+                {
+                    if (n == 5 || !parseInt(p, end, value[n]))
+                        return fail(line);
+                    ++n;
+                    if (p == end || *p != ',')
+                        break;
+                    ++p;
+                }
+
+                if (p < end && *p == '\r')
+                    ++p;
+                if (p < end && *p != '\n')
+                    return fail(line);
+                ++p;
+
+                if (columns == 0)
+                {
+                    if (n < 4)
+                        return fail(line);
+                    columns = n;
+                }
+                else if (n != columns)
+                {
+                    return fail(line);
+                }
+
+                // Every voltage must be a 10-bit analogRead value, so it also fits in 16 bits.
+                for (int c = 1; c < n; ++c)
+                    if (value[c] < 0 || value[c] > 1023)
+                        return fail(line);
+
+                millisColumn[rows] = value[0];
+                xColumn[rows] = static_cast<std::int16_t>(value[1]);
+                yColumn[rows] = static_cast<std::int16_t>(value[2]);
+                zColumn[rows] = static_cast<std::int16_t>(value[3]);
+                wColumn[rows] = (n < 5) ? 0 : static_cast<std::int16_t>(value[4]);
+                ++rows;
+            }
+
+            if (columns < 5)
+                wColumn.clear();
+
+            return true;
+        }
+
+        bool decode(const unsigned char *data, std::size_t size)
+        {
+            // Parses the contents of a binary log file already in memory.
+            errorLine = 0;
+            rows = 0;
+            columns = 0;
+
+            SlothLogHeader h;
+            if (size < sizeof(h))
+                return false;
+            std::memcpy(&h, data, sizeof(h));
+
+            if (std::memcmp(h.magic, SlothLogMagic, sizeof(h.magic)) || h.version != SlothLogVersion || h.byteOrder != SlothLogByteOrder)
+                return false;
+
+            if ((h.columnCount != 4 && h.columnCount != 5) || h.encoding > static_cast<std::uint32_t>(SlothLogEncoding::Delta8))
+                return false;
+
+            const SlothLogEncoding encoding = static_cast<SlothLogEncoding>(h.encoding);
+            const std::size_t nrows = h.rowCount;
+            const int nvoltages = static_cast<int>(h.columnCount) - 1;
+            std::size_t expected = sizeof(h) + nvoltages * columnBytes(encoding, nrows);
+            if (h.intervalMillis == 0)
+                expected += 4 * nrows;
+            if (size != expected)
+                return false;
+
+            // The rows are counted in an int, and the timestamps of a regular log
+            // are generated from the header, so all of them must fit in 32 bits.
+            if (nrows > INT32_MAX)
+                return false;
+            if (h.intervalMillis != 0 && nrows > 0)
+            {
+                const std::int64_t last = h.firstMillis + static_cast<std::int64_t>(nrows - 1) * h.intervalMillis;
+                if (last > INT32_MAX)
+                    return false;
+            }
+
+            resize(nrows);
+            const unsigned char *p = data + sizeof(h);
+            if (h.intervalMillis == 0)
+            {
+                std::memcpy(millisColumn.data(), p, 4 * nrows);
+                p += 4 * nrows;
+            }
+            else
+            {
+                for (std::size_t r = 0; r < nrows; ++r)
+                    millisColumn[r] = static_cast<std::int32_t>(h.firstMillis + static_cast<std::int64_t>(r) * h.intervalMillis);
+            }
+
+            for (int c = 0; c < nvoltages; ++c)
+            {
+                std::int16_t *v = column(c);
+                if (nrows == 0)
+                    continue;
+
+                if (encoding == SlothLogEncoding::Packed16)
+                {
+                    std::memcpy(v, p, 2 * nrows);
+                }
+                else
+                {
+                    std::memcpy(v, p, 2);
+                    for (std::size_t r = 1; r < nrows; ++r)
+                        v[r] = static_cast<std::int16_t>(v[r-1] + static_cast<std::int8_t>(p[r+1]));
+                }
+                p += columnBytes(encoding, nrows);
+
+                // As in parse(), every voltage must be a 10-bit analogRead value.
+                for (std::size_t r = 0; r < nrows; ++r)
+                    if (v[r] < 0 || v[r] > 1023)
+                        return false;
+            }
+
+            if (h.columnCount < 5)
+                wColumn.clear();
+
+            voltageScale = h.voltageScale;
+            voltageOffset = h.voltageOffset;
+            nodeScale = h.nodeScale;
+            nodeOffset = h.nodeOffset;
+            columns = static_cast<int>(h.columnCount);
+            rows = static_cast<int>(nrows);
+            return true;
+        }
+
+        static bool parseInt(const char *& p, const char *end, int& value)
+        {
+            // Parse an optionally negative decimal integer, leaving `p` just past its last digit.
+            // Returns false if the value does not fit in 32 bits.
+            bool negative = (p < end && *p == '-');
+            if (negative)
+                ++p;
+
+            if (p == end || *p < '0' || *p > '9')
+                return false;
+
+            const long long limit = negative ? 2147483648LL : 2147483647LL;
+            long long n = 0;
+            do
+            {
+                n = 10*n + (*p - '0');
+                if (n > limit)
+                    return false;
+                ++p;
+            }
+            while (p < end && *p >= '0' && *p <= '9');
+
+            value = static_cast<int>(negative ? -n : n);
+            return true;
+        }
+
+        bool fail(int line)
+        {
+            errorLine = line;
+            rows = 0;
+            return false;
+        }
+
+        int rowCount() const
+        {
+            return rows;
+        }
+
+        bool hasW() const
+        {
+            return columns == 5;
+        }
+
+        int errorLineNumber() const
+        {
+            return errorLine;
+        }
+
+        int intervalMillis() const
+        {
+            // Returns the time between consecutive rows, or 0 if it varies.
+            // The differences are taken in 64 bits, because timestamps
+            // far apart can differ by more than an int32 can hold.
+            if (rows < 2)
+                return 0;
+            const std::int64_t interval = static_cast<std::int64_t>(millisColumn[1]) - millisColumn[0];
+            if (interval <= 0 || interval > INT32_MAX)
+                return 0;
+            for (int r = 2; r < rows; ++r)
+                if (static_cast<std::int64_t>(millisColumn[r]) - millisColumn[r-1] != interval)
+                    return 0;
+            return static_cast<int>(interval);
+        }
+
+        bool canDelta8() const
+        {
+            // Does every difference between consecutive values fit in 8 bits?
+            for (int c = 0; c < columns - 1; ++c)
+            {
+                const std::int16_t *v = column(c);
+                for (int r = 1; r < rows; ++r)
+                {
+                    int d = v[r] - v[r-1];
+                    if (d < -128 || d > 127)
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        std::vector<unsigned char> encode(SlothLogEncoding encoding) const
+        {
+            // Returns the contents of a binary log file. If Delta8 is requested
+            // but some difference does not fit in 8 bits, Packed16 is used instead;
+            // the header records the encoding actually used.
+            if (encoding == SlothLogEncoding::Delta8 && !canDelta8())
+                encoding = SlothLogEncoding::Packed16;
+
+            const std::size_t nrows = static_cast<std::size_t>(rows);
+            const int nvoltages = hasW() ? 4 : 3;
+            SlothLogHeader h{};
+            std::memcpy(h.magic, SlothLogMagic, sizeof(h.magic));
+            h.version = SlothLogVersion;
+            h.byteOrder = SlothLogByteOrder;
+            h.rowCount = static_cast<std::uint32_t>(rows);
+            h.columnCount = static_cast<std::uint32_t>(nvoltages + 1);
+            h.encoding = static_cast<std::uint32_t>(encoding);
+            h.firstMillis = (rows > 0) ? millisColumn[0] : 0;
+            h.intervalMillis = static_cast<std::uint32_t>(intervalMillis());
+            h.voltageScale = voltageScale;
+            h.voltageOffset = voltageOffset;
+            h.nodeScale = nodeScale;
+            h.nodeOffset = nodeOffset;
+
+            std::size_t size = sizeof(h) + nvoltages * columnBytes(encoding, nrows);
+            if (h.intervalMillis == 0)
+                size += 4 * nrows;
+
+            std::vector<unsigned char> file(size);
+            unsigned char *p = file.data();
+            std::memcpy(p, &h, sizeof(h));
+            p += sizeof(h);
+            if (h.intervalMillis == 0)
+            {
+                std::memcpy(p, millisColumn.data(), 4 * nrows);
+                p += 4 * nrows;
+            }
+
+            for (int c = 0; c < nvoltages; ++c)
+            {
+                const std::int16_t *v = column(c);
+                if (nrows == 0)
+                    continue;
+
+                if (encoding == SlothLogEncoding::Packed16)
+                {
+                    std::memcpy(p, v, 2 * nrows);
+                }
+                else
+                {
+                    std::memcpy(p, v, 2);
+                    for (std::size_t r = 1; r < nrows; ++r)
+                        p[r+1] = static_cast<unsigned char>(static_cast<std::int8_t>(v[r] - v[r-1]));
+                }
+                p += columnBytes(encoding, nrows);
+            }
+            return file;
+        }
+
+        bool save(const char *filename, SlothLogEncoding encoding) const
+        {
+            // Writes the log to a binary file.
+            std::vector<unsigned char> file = encode(encoding);
+            FILE *outfile = fopen(filename, "wb");
+            if (outfile == nullptr)
+                return false;
+            bool ok = (fwrite(file.data(), 1, file.size(), outfile) == file.size());
+            return (fclose(outfile) == 0) && ok;
+        }
+
+        // The raw columns, each containing rowCount() values.
+        const std::int32_t *millis() const
+        {
+            return millisColumn.data();
+        }
+
+        const std::int16_t *x() const
+        {
+            return xColumn.data();
+        }
+
+        const std::int16_t *y() const
+        {
+            return yColumn.data();
+        }
+
+        const std::int16_t *z() const
+        {
+            return zColumn.data();
+        }
+
+        const std::int16_t *w() const
+        {
+            return hasW() ? wColumn.data() : nullptr;
+        }
+
+        // The circuit voltages for a given row.
+        double xVoltage(int row) const
+        {
+            return xColumn[row]*voltageScale + voltageOffset;
+        }
+
+        double yVoltage(int row) const
+        {
+            return yColumn[row]*voltageScale + voltageOffset;
+        }
+
+        double zVoltage(int row) const
+        {
+            return zColumn[row]*voltageScale + voltageOffset;
+        }
+
+        double wVoltage(int row) const
+        {
+            return hasW() ? (wColumn[row]*nodeScale + nodeOffset) : 0.0;
+        }
+    };
+}
@@ -0,0 +1,196 @@
+/*
+    SlothLyapunov.hpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Estimates the largest Lyapunov exponent of a Sloth circuit while it runs,
+    by carrying a tangent vector along the trajectory. Instead of simulating
+    a perturbed copy of the circuit, as ButterflyEffect does, the tangent
+    vector follows the linearized equations for an infinitesimal perturbation
+    of the node voltages (x, w, y).
+
+    Between comparator transitions the circuit is linear, so the tangent
+    vector advances by the same exact transition matrix the exact integrator
+    uses. When Q toggles, the crossing time itself depends on the perturbation.
+    The tangent vector is corrected by the saltation matrix
+
+        S = I + (f+ - f-) n' / (n' f-)
+
+    where f- and f+ are the rates of change of (x, w, y) before and after
+    the switch, and n = (0, 0, zy) is the gradient of z. Only dx/dt depends
+    on Q, and only dy/dt appears in n' f, so S reduces to a single term:
+
+        vx += (xq * (Q+ - Q-) / (yw * w)) * vy
+
+    The tangent vector is periodically renormalized, accumulating the
+    logarithm of its growth. The exponent is the average growth rate,
+    in nepers per second of real (not dilated) time.
+*/
+#pragma once
+
+#include <cmath>
+#include "SlothCircuit.hpp"
+
+namespace Analog
+{
+    template <typename circuit_t>
+    class LyapunovSlothCircuit : protected SlothComponents
+    {
+    private:
+        circuit_t circuit;
+
+        // Coefficients and transition matrix for the current sample rate and inputs.
+        SlothCoefficients coef;
+        SlothTransition trans;
+        float coefSampleRateHz = 0.0f;
+
+        double v[3]{};              // tangent vector for (x, w, y)
+        double logGrowth = 0.0;     // sum of the logarithms of all renormalization factors
+        double elapsed = 0.0;       // real-time seconds since the tangent vector was reset
+        int renormalizeInterval = 64;
+        int samplesSinceRenormalize = 0;
+
+        void refreshCoefficients(float sampleRateHz)
+        {
+            coef.calculate(circuit.timeDilationFactor() / sampleRateHz, circuit.variableResistance(), circuit.controlVoltage());
+            trans.calculate(coef);
+            coefSampleRateHz = sampleRateHz;
+        }
+
+        double tangentLength() const
+        {
+            return std::sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
+        }
+
+        void renormalize()
+        {
+            double length = tangentLength();
+            if (length > 0.0)
+            {
+                logGrowth += std::log(length);
+                v[0] /= length;
+                v[1] /= length;
+                v[2] /= length;
+            }
+            samplesSinceRenormalize = 0;
+        }
+
+    public:
+        LyapunovSlothCircuit()
+        {
+            resetExponent();
+        }
+
+        void initialize()
+        {
+            circuit.initialize();
+            resetExponent();
+        }
+
+        void resetExponent()
+        {
+            // Start a new measurement from the current state,
+            // for example after skipping the initial transient.
+            const double n = 1.0 / std::sqrt(3.0);
+            v[0] = v[1] = v[2] = n;
+            logGrowth = 0.0;
+            elapsed = 0.0;
+            samplesSinceRenormalize = 0;
+        }
+
+        void setRenormalizeInterval(int samples)
+        {
+            // The tangent vector grows or shrinks by only a tiny amount per sample,
+            // so it rarely needs to be renormalized.
+            renormalizeInterval = std::max(1, samples);
+        }
+
+        SlothState saveState() const
+        {
+            return circuit.saveState();
+        }
+
+        void restoreState(const SlothState& state)
+        {
+            circuit.restoreState(state);
+        }
+
+        void setKnobPosition(double fraction)
+        {
+            double k = circuit.variableResistance();
+            circuit.setKnobPosition(fraction);
+            if (circuit.variableResistance() != k)
+                coefSampleRateHz = 0.0f;
+        }
+
+        void setControlVoltage(double cv)
+        {
+            double u = circuit.controlVoltage();
+            circuit.setControlVoltage(cv);
+            if (circuit.controlVoltage() != u)
+                coefSampleRateHz = 0.0f;
+        }
+
+        double xVoltage() const
+        {
+            return circuit.xVoltage();
+        }
+
+        double wVoltage() const
+        {
+            return circuit.wVoltage();
+        }
+
+        double yVoltage() const
+        {
+            return circuit.yVoltage();
+        }
+
+        double zVoltage() const
+        {
+            return circuit.zVoltage();
+        }
+
+        double exponent() const
+        {
+            // Returns the largest Lyapunov exponent estimated since the last reset,
+            // in nepers per second. A positive value indicates chaos.
+            return (elapsed > 0.0) ? (logGrowth + std::log(tangentLength())) / elapsed : 0.0;
+        }
+
+        double measuredSeconds() const
+        {
+            return elapsed;
+        }
+
+        int update(float sampleRateHz)      // returns the number of iterations needed for convergence [1..iterationLimit]
+        {
+            if (sampleRateHz != coefSampleRateHz)
+                refreshCoefficients(sampleRateHz);
+
+            const double q1 = Q(circuit.zVoltage());
+            const int iter = circuit.update(sampleRateHz);
+            const double q2 = Q(circuit.zVoltage());
+
+            // Advance the tangent vector through the linear part of the step.
+            double d[3];
+            for (int r = 0; r < 3; ++r)
+                d[r] = trans.delta[r][0]*v[0] + trans.delta[r][1]*v[1] + trans.delta[r][2]*v[2];
+            v[0] += d[0];
+            v[1] += d[1];
+            v[2] += d[2];
+
+            // Apply the saltation correction if the comparator toggled.
+            if (q1 != q2)
+            {
+                const double dy = coef.yw * circuit.wVoltage();
+                if (dy != 0.0)
+                    v[0] += (coef.xq * (q2 - q1) / dy) * v[2];
+            }
+
+            elapsed += 1.0 / sampleRateHz;
+            if (++samplesSinceRenormalize >= renormalizeInterval)
+                renormalize();
+
+            return iter;
+        }
+    };
+}
@@ -0,0 +1,190 @@
+/*
+    SlothModule.hpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    A polyphonic Sloth module for modular synthesizer hosts such as VCV Rack.
+    One module simulates up to 16 channels. Every channel shares the module's
+    variant and knob, and each channel has its own control voltage input.
+
+    All channels are advanced together by a single SlothBank update per sample,
+    so a 16-channel patch costs one call and no virtual dispatch per sample.
+    Only the SIMD vectors that contain active channels are simulated.
+
+    The host adapter owns the GUI, parameter, and port plumbing, then calls
+    `process` once per sample (as in VCV Rack) or `processBlock` once per buffer.
+    Knob and CV values are passed to the bank only when they change, so a steady
+    control costs nothing, and `setControlDivision` can reduce the cost of
+    constantly-changing CVs further by reading them every few samples.
+*/
+#pragma once
+
+#include <algorithm>
+#include "SlothBank.hpp"
+
+namespace Analog
+{
+    class SlothPolyModule
+    {
+    public:
+        static constexpr int MaxChannels = 16;
+
+    private:
+        SlothBank<MaxChannels> bank;
+        SlothVariant variant = SlothVariant::Torpor;
+        int channels = 1;
+        int controlDivision = 1;
+        int controlPhase = 0;
+
+        double knob = 0.0;
+        double appliedKnob[MaxChannels]{};
+        double appliedCv[MaxChannels]{};
+
+        template <typename circuit_t>
+        void resetLane(int lane)
+        {
+            circuit_t circuit;
+            circuit.setKnobPosition(knob);
+            circuit.setControlVoltage(appliedCv[lane]);
+            bank.setVoice(lane, circuit);
+            appliedKnob[lane] = knob;
+        }
+
+        void resetLane(int lane)
+        {
+            switch (variant)
+            {
+            case SlothVariant::Apathy:  resetLane<ApathySlothCircuit> (lane);  break;
+            case SlothVariant::Inertia: resetLane<InertiaSlothCircuit>(lane);  break;
+            default:                    resetLane<TorporSlothCircuit> (lane);  break;
+            }
+        }
+
+        void applyControls(const float *cv)
+        {
+            // Pass any changed controls to the bank's active lanes.
+            for (int c = 0; c < channels; ++c)
+            {
+                if (appliedKnob[c] != knob)
+                {
+                    bank.setKnobPosition(c, knob);
+                    appliedKnob[c] = knob;
+                }
+
+                const double u = (cv != nullptr) ? cv[c] : 0.0;
+                if (appliedCv[c] != u)
+                {
+                    bank.setControlVoltage(c, u);
+                    appliedCv[c] = u;
+                }
+            }
+        }
+
+    public:
+        SlothPolyModule()
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            // Restart every channel from the variant's power-up state.
+            for (int lane = 0; lane < MaxChannels; ++lane)
+            {
+                appliedCv[lane] = 0.0;
+                resetLane(lane);
+            }
+            controlPhase = 0;
+        }
+
+        void setVariant(SlothVariant v)
+        {
+            // Changing the variant restarts every channel.
+            if (v != variant)
+            {
+                variant = v;
+                reset();
+            }
+        }
+
+        SlothVariant getVariant() const
+        {
+            return variant;
+        }
+
+        void setChannelCount(int n)
+        {
+            // Channels that become active start from the power-up state.
+            n = std::max(1, std::min(MaxChannels, n));
+            for (int lane = channels; lane < n; ++lane)
+            {
+                appliedCv[lane] = 0.0;
+                resetLane(lane);
+            }
+            channels = n;
+        }
+
+        int channelCount() const
+        {
+            return channels;
+        }
+
+        void setKnobPosition(double fraction)
+        {
+            // Takes effect the next time the controls are read.
+            knob = fraction;
+        }
+
+        void setControlDivision(int samples)
+        {
+            // Read the knob and CV inputs once every `samples` samples.
+            // The default of 1 reads them every sample, which gives
+            // exactly the same output as separate scalar circuits.
+            controlDivision = std::max(1, samples);
+            controlPhase = 0;
+        }
+
+        void process(float sampleRateHz, const float *cv, float *xOutput, float *yOutput, float *zOutput)
+        {
+            // Generates one sample for every active channel.
+            // `cv` holds one control voltage per channel, or is null for 0 V.
+            // Any output array may be null. Each one that is not receives one
+            // voltage per active channel.
+            if (controlPhase == 0)
+                applyControls(cv);
+            if (++controlPhase >= controlDivision)
+                controlPhase = 0;
+
+            bank.updateLanes(sampleRateHz, channels);
+
+            for (int c = 0; c < channels; ++c)
+            {
+                if (xOutput) xOutput[c] = static_cast<float>(bank.xVoltage(c));
+                if (yOutput) yOutput[c] = static_cast<float>(bank.yVoltage(c));
+                if (zOutput) zOutput[c] = static_cast<float>(bank.zVoltage(c));
+            }
+        }
+
+        void processBlock(
+            float sampleRateHz,
+            int nSamples,
+            const float *cv,
+            float *xOutput,
+            float *yOutput,
+            float *zOutput)
+        {
+            // Generates `nSamples` samples for every active channel.
+            // All buffers are interleaved by channel, with MaxChannels floats per sample,
+            // so sample s of channel c is at index s*MaxChannels + c.
+            for (int s = 0; s < nSamples; ++s)
+            {
+                const int offset = s * MaxChannels;
+                process(
+                    sampleRateHz,
+                    cv ? (cv + offset) : nullptr,
+                    xOutput ? (xOutput + offset) : nullptr,
+                    yOutput ? (yOutput + offset) : nullptr,
+                    zOutput ? (zOutput + offset) : nullptr
+                );
+            }
+        }
+    };
+}
@@ -0,0 +1,457 @@
+/*
+    SlothNetwork.hpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Simulates N Sloth circuits patched into each other, for example the x output
+    of each circuit feeding the control voltage input of the next one.
+
+    Patching separate circuit objects together means each circuit reads the
+    other circuits' voltages from the previous sample, which adds a one-sample
+    delay to every connection. Here all the circuits are solved together instead.
+    Every iteration of the midpoint solver recalculates each circuit's control
+    voltage from the latest estimates of its sources' voltages at the end of
+    the time step, so the connections have no delay.
+
+    The state is stored as a structure of arrays, like SlothBank, and each
+    iteration makes SIMD passes over all the circuits ("nodes"), with a pass
+    through the sparse list of connections between them. A node whose
+    deltas have converged latches its result, as in SlothBank. A node with
+    no incoming connections produces exactly the same voltages as a scalar
+    SlothCircuit with the same variant, knob, and CV settings.
+
+    A connection can take a node's x or y voltage. The z voltage is not
+    offered, because it responds instantly to the node's own control voltage,
+    so connecting z outputs in a loop would create an algebraic loop.
+*/
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include "SlothCircuit.hpp"
+#include "SlothSimd.hpp"
+
+namespace Analog
+{
+    enum class SlothNetworkOutput
+    {
+        X,
+        Y,
+    };
+
+
+    template <int N>
+    class SlothNetwork : protected SlothComponents
+    {
+        static_assert(N > 0, "A SlothNetwork must contain at least one node.");
+
+    private:
+        // Round the number of nodes up to a whole number of SIMD vectors.
+        // The padding nodes are simulated but never converge or become visible.
+        static constexpr int W = SlothVec::width;
+        static constexpr int P = W * ((N + W - 1) / W);
+
+        struct Link
+        {
+            int tap;        // index into `tap`: the source node, offset by P for its y voltage
+            int target;
+            double gain;
+        };
+
+        // The sparse coupling matrix: the connections sorted by target node,
+        // so all the contributions to one node are summed together.
+        std::vector<Link> links;
+
+        // Variant parameters
+        alignas(64) double timeDilation[P];
+        alignas(64) double w0[P];
+
+        // Inputs
+        alignas(64) double K[P];
+        alignas(64) double U[P];    // each node's own control voltage, before its incoming connections are added
+
+        // Node voltages
+        alignas(64) double x1[P];
+        alignas(64) double w1[P];
+        alignas(64) double y1[P];
+        alignas(64) double z1[P];
+
+        // 1.0 for padding nodes, 0.0 for real nodes.
+        alignas(64) double padding[P];
+
+        // 1.0 for nodes with at least one incoming connection, 0.0 otherwise.
+        alignas(64) double driven[P];
+
+        // Cached solver coefficients for each node (see SlothCoefficients),
+        // valid for the sample rate `coefSampleRateHz`, or invalid if it is zero.
+        // z0 only depends on the control voltage, so it is always valid, and
+        // the solver recalculates it on every iteration for the driven nodes.
+        alignas(64) double xz[P];
+        alignas(64) double xq[P];
+        alignas(64) double xw[P];
+        alignas(64) double wx[P];
+        alignas(64) double ww[P];
+        alignas(64) double yw[P];
+        float coefSampleRateHz = 0.0f;
+
+        // Solver state carried from one iteration to the next within a time step.
+        alignas(64) double dx[P], dw[P], dy[P];
+        alignas(64) double ex[P], ew[P], ey[P];
+        alignas(64) double x2[P], w2[P], y2[P], z2[P];
+        alignas(64) double done[P];
+        alignas(64) double z0[P];
+
+        // The end-of-step estimates of every node's x voltage, then every node's y voltage.
+        // Latched nodes keep reporting their latched voltages.
+        alignas(64) double tap[2*P];
+
+        void refreshCoefficients(int node)
+        {
+            SlothCoefficients c;
+            c.calculate(timeDilation[node] / coefSampleRateHz, K[node], U[node]);
+            xz[node] = c.xz;
+            xq[node] = c.xq;
+            xw[node] = c.xw;
+            wx[node] = c.wx;
+            ww[node] = c.ww;
+            yw[node] = c.yw;
+        }
+
+        void refreshCoefficients(float sampleRateHz)
+        {
+            coefSampleRateHz = sampleRateHz;
+            for (int i = 0; i < P; ++i)
+                refreshCoefficients(i);
+        }
+
+        void nodeChanged(int node)
+        {
+            // Keep the node's coefficients current, if we know the sample rate yet.
+            if (coefSampleRateHz != 0.0f)
+                refreshCoefficients(node);
+        }
+
+        static SlothVec Q(SlothVec z)
+        {
+            // The comparator U1 output responds immediately to the voltage z.
+            // It is an inverting amplifier whose output is saturated.
+            return select(z < SlothVec::broadcast(0.0), SlothVec::broadcast(QPOS), SlothVec::broadcast(QNEG));
+        }
+
+        void calculateInputs()
+        {
+            // Add each connection's contribution to its target's control voltage,
+            // then convert the clamped total into the target's z0 coefficient.
+            const double cvGain = SlothCoefficients::controlVoltageGain();
+            const Link *link = links.data();
+            const Link *end = link + links.size();
+            while (link != end)
+            {
+                const int node = link->target;
+                double u = U[node];
+                do
+                {
+                    u += link->gain * tap[link->tap];
+                    ++link;
+                }
+                while (link != end && link->target == node);
+                z0[node] = cvGain * clampControlVoltage(u);
+            }
+        }
+
+        void estimate(int base, SlothVec xm, SlothVec wm, SlothVec zm, SlothVec Qm, SlothMask latched)
+        {
+            // Update the finite changes of the voltage variables after the time interval,
+            // and publish the resulting end-of-step voltages for the connections to read.
+            // Latched nodes keep reporting their latched voltages.
+            SlothVec ddx = (SlothVec::load(xz + base)*zm + SlothVec::load(xq + base)*Qm) + SlothVec::load(xw + base)*wm;
+            SlothVec ddw = SlothVec::load(wx + base)*xm + SlothVec::load(ww + base)*wm;
+            SlothVec ddy = SlothVec::load(yw + base)*wm;
+            ddx.store(dx + base);
+            ddw.store(dw + base);
+            ddy.store(dy + base);
+            select(latched, SlothVec::load(x2 + base), SlothVec::load(x1 + base) + ddx).store(tap + base);
+            select(latched, SlothVec::load(y2 + base), SlothVec::load(y1 + base) + ddy).store(tap + P + base);
+        }
+
+        int solve()
+        {
+            // This is the same algorithm as SlothBank::solve, except that all the
+            // nodes iterate together, and the driven nodes' z0 coefficients are
+            // recalculated from their inputs between estimating the deltas and
+            // testing them for convergence. All the arithmetic is performed in
+            // the same order as the scalar code. Each pass over the nodes tests
+            // one iteration's deltas and estimates the next iteration's.
+
+            const SlothVec zero = SlothVec::broadcast(0.0);
+            const SlothVec half = SlothVec::broadcast(0.5);
+            const SlothVec one  = SlothVec::broadcast(1.0);
+            const SlothVec czy  = SlothVec::broadcast(-R4/R5);
+
+            // Iterate until convergence.
+            const double tolerance = 1.0e-12;        // one picovolt
+            const SlothVec toleranceSquared = SlothVec::broadcast(tolerance * tolerance);
+
+            if (!links.empty())
+            {
+                // The z voltage of a driven node responds instantly to its inputs,
+                // so recalculate it from the voltages its sources have now.
+                // Otherwise the first time step after the sources change, or after
+                // the node is connected, would start from an inconsistent z.
+                for (int i = 0; i < P; ++i)
+                {
+                    tap[i] = x1[i];
+                    tap[P + i] = y1[i];
+                }
+                calculateInputs();
+                for (int base = 0; base < P; base += W)
+                {
+                    const SlothMask isDriven = zero < SlothVec::load(driven + base);
+                    const SlothVec zs = czy*SlothVec::load(y1 + base) + SlothVec::load(z0 + base);
+                    select(isDriven, zs, SlothVec::load(z1 + base)).store(z1 + base);
+                }
+            }
+
+            // Start with crude estimates that the voltage variables remain constant over the time interval.
+            for (int base = 0; base < P; base += W)
+            {
+                const SlothVec x = SlothVec::load(x1 + base);
+                const SlothVec w = SlothVec::load(w1 + base);
+                const SlothVec y = SlothVec::load(y1 + base);
+                const SlothVec z = SlothVec::load(z1 + base);
+                zero.store(ex + base);
+                zero.store(ew + base);
+                zero.store(ey + base);
+                x.store(x2 + base);
+                w.store(w2 + base);
+                y.store(y2 + base);
+                z.store(z2 + base);
+
+                // Padding nodes start out converged, so they never hold up the real nodes.
+                const SlothVec pad = SlothVec::load(padding + base);
+                pad.store(done + base);
+                estimate(base, x, w, z, Q(z), zero < pad);
+            }
+
+            for (int iter = 1; true; ++iter)
+            {
+                // Find each driven node's control voltage at the end of the time step.
+                calculateInputs();
+
+                SlothMask pending = SlothMask::broadcast(false);
+                for (int base = 0; base < P; base += W)
+                {
+                    const SlothVec x = SlothVec::load(x1 + base);
+                    const SlothVec w = SlothVec::load(w1 + base);
+                    const SlothVec y = SlothVec::load(y1 + base);
+                    const SlothVec z = SlothVec::load(z1 + base);
+                    const SlothVec ddx = SlothVec::load(dx + base);
+                    const SlothVec ddw = SlothVec::load(dw + base);
+                    const SlothVec ddy = SlothVec::load(dy + base);
+
+                    SlothVec xn = x + ddx;
+                    SlothVec wn = w + ddw;
+                    SlothVec yn = y + ddy;
+
+                    // Assume z changes instantaneously because there is no capacitor the U2 feedback loop.
+                    SlothVec zn = czy*yn + SlothVec::load(z0 + base);
+
+                    SlothMask isDone = zero < SlothVec::load(done + base);
+                    if (iter > 1)
+                    {
+                        // Which nodes have converged on this iteration?
+                        SlothVec cx = ddx - SlothVec::load(ex + base);
+                        SlothVec cw = ddw - SlothVec::load(ew + base);
+                        SlothVec cy = ddy - SlothVec::load(ey + base);
+                        SlothVec variance = (cx*cx + cw*cw) + cy*cy;
+                        SlothMask converged = (variance < toleranceSquared) | SlothMask::broadcast(iter >= iterationLimit);
+                        SlothMask latch = andNot(converged, isDone);
+                        select(latch, xn, SlothVec::load(x2 + base)).store(x2 + base);
+                        select(latch, wn, SlothVec::load(w2 + base)).store(w2 + base);
+                        select(latch, yn, SlothVec::load(y2 + base)).store(y2 + base);
+                        select(latch, zn, SlothVec::load(z2 + base)).store(z2 + base);
+                        isDone = isDone | converged;
+                        select(isDone, one, zero).store(done + base);
+                        pending = pending | andNot(SlothMask::broadcast(true), isDone);
+                    }
+
+                    // Remember the previous delta voltages, so we can tell whether we have converged next time.
+                    ddx.store(ex + base);
+                    ddw.store(ew + base);
+                    ddy.store(ey + base);
+
+                    // We approximate the mean value over the time interval as the average
+                    // of the starting value with the estimated next value.
+                    SlothVec xm = x + ddx*half;
+                    SlothVec wm = w + ddw*half;
+                    SlothVec zm = (z + zn)*half;
+
+                    // Usually Q remains constant, but it toggles when z changes polarity.
+                    // alpha = the fraction into the time step at which z(t) = 0.
+                    SlothMask crossing = (z * zn) < zero;
+                    SlothVec alpha = z / select(crossing, z - zn, one);
+                    SlothVec Qcross = alpha*Q(z) + (one - alpha)*Q(zn);
+                    SlothVec Qm = select(crossing, Qcross, Q(zm));
+
+                    estimate(base, xm, wm, zm, Qm, isDone);
+                }
+
+                if (iter > 1 && !pending.any())
+                {
+                    // Every node has converged, or we have hit the iteration safety limit.
+                    // Update the circuit state voltages and return.
+                    for (int base = 0; base < P; base += W)
+                    {
+                        SlothVec::load(x2 + base).store(x1 + base);
+                        SlothVec::load(w2 + base).store(w1 + base);
+                        SlothVec::load(y2 + base).store(y1 + base);
+                        SlothVec::load(z2 + base).store(z1 + base);
+                    }
+                    return iter;
+                }
+            }
+        }
+
+    public:
+        // The iteration safety limit for the convergence solver.
+        const int iterationLimit = 5;
+
+        static constexpr int size()
+        {
+            return N;
+        }
+
+        SlothNetwork()
+        {
+            // Every node starts out as Torpor with its inputs at zero, and no connections.
+            for (int i = 0; i < P; ++i)
+            {
+                padding[i] = (i < N) ? 0.0 : 1.0;
+                driven[i] = 0.0;
+                timeDilation[i] = 1.0;
+                w0[i] = 0.0;
+                initialize(i);
+                setKnobPosition(i, 0.0);
+                setControlVoltage(i, 0.0);
+            }
+        }
+
+        void setVoice(int node, const SlothCircuit& circuit)
+        {
+            // Copy the variant, inputs, and current state of a scalar circuit into a node.
+            timeDilation[node] = circuit.timeDilationFactor();
+            w0[node] = circuit.initialChargeVoltage();
+            K[node] = circuit.variableResistance();
+            setControlVoltage(node, circuit.controlVoltage());
+            x1[node] = circuit.xVoltage();
+            w1[node] = circuit.wVoltage();
+            y1[node] = circuit.yVoltage();
+            z1[node] = circuit.zVoltage();
+            nodeChanged(node);
+        }
+
+        bool connect(int source, int target, double gain, SlothNetworkOutput output = SlothNetworkOutput::X)
+        {
+            // Adds `gain` times the source node's x or y voltage to the target node's
+            // control voltage. A node may feed itself, and several connections may
+            // feed the same node, in which case their contributions are summed.
+            // The total control voltage is clamped to the supply rails.
+            // Returns false, without connecting anything, if either node index is out of range.
+            if (source < 0 || source >= N || target < 0 || target >= N)
+                return false;
+
+            const int index = (output == SlothNetworkOutput::Y) ? (P + source) : source;
+            auto position = std::upper_bound(links.begin(), links.end(), target, [](int node, const Link& link)
+            {
+                return node < link.target;
+            });
+            links.insert(position, Link{index, target, gain});
+            driven[target] = 1.0;
+            return true;
+        }
+
+        void disconnectAll()
+        {
+            links.clear();
+            for (int i = 0; i < P; ++i)
+            {
+                driven[i] = 0.0;
+                setControlVoltage(i, U[i]);
+            }
+        }
+
+        int connectionCount() const
+        {
+            return static_cast<int>(links.size());
+        }
+
+        void initialize(int node)
+        {
+            w1[node] = w0[node];
+            x1[node] = 0.0;
+            y1[node] = 0.0;
+            z1[node] = 0.0;
+        }
+
+        void initialize()
+        {
+            for (int i = 0; i < N; ++i)
+                initialize(i);
+        }
+
+        SlothState saveState(int node) const
+        {
+            return SlothState{x1[node], w1[node], y1[node], z1[node]};
+        }
+
+        void restoreState(int node, const SlothState& state)
+        {
+            x1[node] = state.x;
+            w1[node] = state.w;
+            y1[node] = state.y;
+            z1[node] = state.z;
+        }
+
+        void setKnobPosition(int node, double fraction)
+        {
+            K[node] = knobResistance(fraction);
+            nodeChanged(node);
+        }
+
+        void setControlVoltage(int node, double cv)
+        {
+            // The node's own control voltage, to which its incoming connections are added.
+            // A node without incoming connections responds to a change on the next
+            // time step, exactly like a scalar circuit. The expression for z0
+            // is the same one SlothCoefficients uses, so the result is identical.
+            U[node] = clampControlVoltage(cv);
+            z0[node] = SlothCoefficients::controlVoltageGain() * U[node];
+        }
+
+        double xVoltage(int node) const
+        {
+            return x1[node];
+        }
+
+        double wVoltage(int node) const
+        {
+            return w1[node];
+        }
+
+        double yVoltage(int node) const
+        {
+            return y1[node];
+        }
+
+        double zVoltage(int node) const
+        {
+            return z1[node];
+        }
+
+        int update(float sampleRateHz)      // returns the iteration count needed for every node to converge [1..iterationLimit]
+        {
+            if (sampleRateHz != coefSampleRateHz)
+                refreshCoefficients(sampleRateHz);
+
+            return solve();
+        }
+    };
+}
@@ -0,0 +1,650 @@
+/*
+    SlothOverview.hpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    A multi-resolution overview of a long recording, so a viewer can zoom
+    from the whole recording down to single samples and draw any window
+    at a cost proportional to the number of pixels, not the number of samples.
+
+    A SlothTrace opens a recording as interleaved 32-bit float voltages,
+    one channel per circuit variable. It accepts a hardware log in either
+    format that SlothLog loads (x, y, z, and w if present), or a render made
+    by SlothRender.hpp (x, y, z), either a WAV file or raw floats.
+    Renders are memory-mapped rather than read, so they may be much larger
+    than the computer's memory.
+
+    A SlothOverview is a pyramid of levels. Each level divides the recording
+    into buckets of 2^k frames, holding the minimum, maximum, and mean of each
+    channel over the bucket. Each level has buckets twice as long as the one
+    before it, up to a single bucket covering the whole recording.
+    The finest level has buckets of 2^shift frames, where shift is chosen so
+    it has no more than about a million buckets, which keeps the overview
+    small compared to the recording. Windows finer than that are drawn
+    from the recording's own samples.
+
+    An overview is built in a single pass and saved alongside the recording
+    with the same name plus ".ovw". The file starts with a SlothOverviewHeader,
+    followed by each level's buckets in order, the channels of each bucket
+    next to each other. The header records the size and modification time
+    of the recording, so an overview left over from an older recording
+    of the same name is recognized as stale and rebuilt.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "SlothLog.hpp"
+
+namespace Analog
+{
+    struct SlothEnvelope
+    {
+        float min;
+        float max;
+        float mean;
+    };
+
+    static_assert(sizeof(SlothEnvelope) == 12, "SlothEnvelope must not contain padding.");
+
+
+    class SlothTrace
+    {
+    private:
+        std::vector<float> decoded;         // the samples of a log, converted to volts
+        void *mapped = nullptr;             // the memory-mapped file of a render
+        std::size_t mappedBytes = 0;
+        const float *data = nullptr;
+        int channels = 0;
+        long long frames = 0;
+        double frameSeconds = 0.0;
+        double firstSeconds = 0.0;
+        std::uint64_t fileBytes = 0;
+        std::int64_t fileTime = 0;
+
+        static std::uint32_t u32(const unsigned char *p)
+        {
+            return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+        }
+
+        static bool isRawFileName(const char *filename)
+        {
+            const std::size_t n = std::strlen(filename);
+            return (n >= 4) && !std::strcmp(filename + n - 4, ".raw");
+        }
+
+        bool mapRender(int fd, const char *filename, float rawSampleRateHz)
+        {
+            // Returns true if the file is a render, in which case it stays mapped.
+            // The samples of a WAV file start right after its 4096-byte header.
+            const std::size_t headerBytes = 4096;
+            const bool raw = isRawFileName(filename);
+            if (!raw && fileBytes < headerBytes)
+                return false;
+
+            void *p = mmap(nullptr, fileBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED)
+                return false;
+
+            const unsigned char *bytes = static_cast<const unsigned char *>(p);
+            std::size_t offset = 0;
+            float rate = rawSampleRateHz;
+            if (!raw)
+            {
+                const bool wav =
+                    (!std::memcmp(bytes, "RIFF", 4) || !std::memcmp(bytes, "RF64", 4)) &&
+                    !std::memcmp(bytes + 8, "WAVE", 4) &&
+                    !std::memcmp(bytes + 48, "fmt ", 4) &&
+                    (bytes[56] | (bytes[57] << 8)) == 3 &&
+                    !std::memcmp(bytes + headerBytes - 8, "data", 4);
+
+                if (!wav)
+                {
+                    munmap(p, fileBytes);
+                    return false;
+                }
+                offset = headerBytes;
+                rate = static_cast<float>(u32(bytes + 60));
+            }
+
+            mapped = p;
+            mappedBytes = fileBytes;
+            data = reinterpret_cast<const float *>(bytes + offset);
+            channels = 3;
+            frames = static_cast<long long>((fileBytes - offset) / (channels * sizeof(float)));
+            frameSeconds = (rate > 0.0f) ? (1.0 / rate) : 0.0;
+            firstSeconds = 0.0;
+            return true;
+        }
+
+        bool decodeLog(const char *filename)
+        {
+            SlothLog log;
+            if (!log.load(filename))
+                return false;
+
+            const int rows = log.rowCount();
+            channels = log.hasW() ? 4 : 3;
+            decoded.resize(static_cast<std::size_t>(rows) * channels);
+            float *p = decoded.data();
+            for (int r = 0; r < rows; ++r)
+            {
+                *p++ = static_cast<float>(log.xVoltage(r));
+                *p++ = static_cast<float>(log.yVoltage(r));
+                *p++ = static_cast<float>(log.zVoltage(r));
+                if (log.hasW())
+                    *p++ = static_cast<float>(log.wVoltage(r));
+            }
+
+            data = decoded.data();
+            frames = rows;
+            if (rows > 1)
+            {
+                // An irregular log is drawn as if its rows were evenly spaced.
+                const int interval = log.intervalMillis();
+                const double millis = (interval > 0) ? interval : (static_cast<double>(log.millis()[rows-1]) - log.millis()[0]) / (rows - 1.0);
+                frameSeconds = millis / 1000.0;
+            }
+            firstSeconds = (rows > 0) ? (log.millis()[0] / 1000.0) : 0.0;
+            return true;
+        }
+
+    public:
+        SlothTrace() = default;
+        SlothTrace(const SlothTrace&) = delete;
+        SlothTrace& operator = (const SlothTrace&) = delete;
+
+        ~SlothTrace()
+        {
+            close();
+        }
+
+        void close()
+        {
+            if (mapped != nullptr)
+                munmap(mapped, mappedBytes);
+            mapped = nullptr;
+            mappedBytes = 0;
+            decoded.clear();
+            data = nullptr;
+            channels = 0;
+            frames = 0;
+            frameSeconds = 0.0;
+            firstSeconds = 0.0;
+            fileBytes = 0;
+            fileTime = 0;
+        }
+
+        bool load(const char *filename, float rawSampleRateHz = 44100.0f)
+        {
+            // Opens a render or a log. Files ending in ".raw" are raw renders,
+            // which do not record their sample rate, so it must be passed in.
+            close();
+            int fd = open(filename, O_RDONLY);
+            if (fd < 0)
+                return false;
+
+            struct stat st;
+            if (fstat(fd, &st) != 0)
+            {
+                ::close(fd);
+                return false;
+            }
+            fileBytes = static_cast<std::uint64_t>(st.st_size);
+            fileTime = static_cast<std::int64_t>(st.st_mtime);
+
+            bool ok = (fileBytes > 0) && mapRender(fd, filename, rawSampleRateHz);
+            ::close(fd);
+            if (!ok)
+                ok = !isRawFileName(filename) && decodeLog(filename);
+
+            if (!ok)
+                close();
+            return ok;
+        }
+
+        bool isMapped() const
+        {
+            return mapped != nullptr;
+        }
+
+        int channelCount() const
+        {
+            return channels;
+        }
+
+        long long frameCount() const
+        {
+            return frames;
+        }
+
+        double secondsPerFrame() const
+        {
+            return frameSeconds;
+        }
+
+        double startSeconds() const
+        {
+            // The time of the first frame: the Arduino clock for a log, or 0 for a render.
+            return firstSeconds;
+        }
+
+        std::uint64_t sourceBytes() const
+        {
+            return fileBytes;
+        }
+
+        std::int64_t sourceTime() const
+        {
+            return fileTime;
+        }
+
+        const float *samples() const
+        {
+            // The interleaved samples, channelCount() per frame.
+            return data;
+        }
+
+        float sample(long long frame, int channel) const
+        {
+            return data[frame*channels + channel];
+        }
+
+        static const char *channelName(int channel)
+        {
+            static const char *names[] = {"x", "y", "z", "w"};
+            return (channel >= 0 && channel < 4) ? names[channel] : "?";
+        }
+    };
+
+
+    struct SlothOverviewHeader
+    {
+        char magic[8];                  // "SLOTHOVW"
+        std::uint32_t version;          // SlothOverviewVersion
+        std::uint32_t byteOrder;        // SlothOverviewByteOrder, as written by the generating machine
+        std::uint32_t channelCount;
+        std::uint32_t shift;            // the finest level has buckets of 2^shift frames
+        std::uint32_t levelCount;
+        std::uint32_t reserved;
+        std::uint64_t frameCount;
+        std::uint64_t sourceBytes;      // the size of the recording the overview was built from
+        std::int64_t sourceTime;        // the recording's modification time, in seconds since 1970
+        double secondsPerFrame;
+    };
+
+    static_assert(sizeof(SlothOverviewHeader) == 64, "SlothOverviewHeader must not contain padding.");
+
+    const char SlothOverviewMagic[8] = {'S', 'L', 'O', 'T', 'H', 'O', 'V', 'W'};
+    const std::uint32_t SlothOverviewVersion = 1;
+    const std::uint32_t SlothOverviewByteOrder = 0x01020304;
+
+
+    class SlothOverview
+    {
+    private:
+        int channels = 0;
+        int shift = 1;
+        long long frames = 0;
+        double frameSeconds = 0.0;
+        std::uint64_t fileBytes = 0;
+        std::int64_t fileTime = 0;
+        std::vector<std::vector<SlothEnvelope>> levels;   // levels[i] has buckets of 2^(shift+i) frames
+
+        static long long bucketCount(long long frames, int bucketShift)
+        {
+            return (frames + (1LL << bucketShift) - 1) >> bucketShift;
+        }
+
+        long long framesInBucket(int bucketShift, long long index) const
+        {
+            // Every bucket is full, except perhaps the last one in its level.
+            const long long begin = index << bucketShift;
+            return std::min(1LL << bucketShift, frames - begin);
+        }
+
+        static std::uint64_t fileSize(long long frames, int channels, int bucketShift, std::uint32_t& levelCount)
+        {
+            // The size of an overview file, and its number of levels.
+            std::uint64_t bytes = sizeof(SlothOverviewHeader);
+            levelCount = 0;
+            if (frames <= 0)
+                return bytes;
+            for (int s = bucketShift; ; ++s)
+            {
+                const long long n = bucketCount(frames, s);
+                bytes += static_cast<std::uint64_t>(n) * channels * sizeof(SlothEnvelope);
+                ++levelCount;
+                if (n == 1)
+                    return bytes;
+            }
+        }
+
+        void allocate()
+        {
+            levels.clear();
+            if (frames <= 0)
+                return;
+            for (int s = shift; ; ++s)
+            {
+                const long long n = bucketCount(frames, s);
+                levels.emplace_back(static_cast<std::size_t>(n * channels));
+                if (n == 1)
+                    break;
+            }
+        }
+
+    public:
+        static int DefaultShift(long long frames)
+        {
+            // The finest level has at most about a million buckets.
+            int s = 1;
+            while ((frames >> s) > (1LL << 20))
+                ++s;
+            return s;
+        }
+
+        void build(const SlothTrace& trace, int bucketShift = 0)
+        {
+            build(trace.samples(), trace.frameCount(), trace.channelCount(), trace.secondsPerFrame(), bucketShift);
+            fileBytes = trace.sourceBytes();
+            fileTime = trace.sourceTime();
+        }
+
+        void build(const float *samples, long long frameCount, int channelCount, double secondsPerFrame, int bucketShift = 0)
+        {
+            // Builds every level from interleaved samples, channelCount per frame.
+            // A bucketShift of 0 selects DefaultShift.
+            channels = channelCount;
+            frames = frameCount;
+            frameSeconds = secondsPerFrame;
+            shift = (bucketShift > 0) ? bucketShift : DefaultShift(frameCount);
+            fileBytes = 0;
+            fileTime = 0;
+            allocate();
+            if (levels.empty())
+                return;
+
+            // The finest level comes from the samples.
+            std::vector<SlothEnvelope>& base = levels[0];
+            std::vector<double> sum(channels);
+            const long long nbase = bucketCount(frames, shift);
+            for (long long b = 0; b < nbase; ++b)
+            {
+                const long long begin = b << shift;
+                const long long end = begin + framesInBucket(shift, b);
+                SlothEnvelope *env = &base[b * channels];
+                const float *s = &samples[begin * channels];
+                for (int c = 0; c < channels; ++c)
+                {
+                    env[c].min = env[c].max = s[c];
+                    sum[c] = 0.0;
+                }
+                for (long long f = begin; f < end; ++f, s += channels)
+                {
+                    for (int c = 0; c < channels; ++c)
+                    {
+                        env[c].min = std::min(env[c].min, s[c]);
+                        env[c].max = std::max(env[c].max, s[c]);
+                        sum[c] += s[c];
+                    }
+                }
+                for (int c = 0; c < channels; ++c)
+                    env[c].mean = static_cast<float>(sum[c] / (end - begin));
+            }
+
+            // Each coarser level combines pairs of buckets from the level before it.
+            for (std::size_t i = 1; i < levels.size(); ++i)
+            {
+                const int s = shift + static_cast<int>(i);
+                const long long nfine = bucketCount(frames, s - 1);
+                const long long n = bucketCount(frames, s);
+                for (long long b = 0; b < n; ++b)
+                {
+                    const SlothEnvelope *a = &levels[i-1][(2*b) * channels];
+                    SlothEnvelope *env = &levels[i][b * channels];
+                    if (2*b + 1 == nfine)
+                    {
+                        std::copy(a, a + channels, env);
+                        continue;
+                    }
+                    const SlothEnvelope *e = a + channels;
+                    const double na = static_cast<double>(framesInBucket(s - 1, 2*b));
+                    const double ne = static_cast<double>(framesInBucket(s - 1, 2*b + 1));
+                    for (int c = 0; c < channels; ++c)
+                    {
+                        env[c].min = std::min(a[c].min, e[c].min);
+                        env[c].max = std::max(a[c].max, e[c].max);
+                        env[c].mean = static_cast<float>((na*a[c].mean + ne*e[c].mean) / (na + ne));
+                    }
+                }
+            }
+        }
+
+        int channelCount() const
+        {
+            return channels;
+        }
+
+        long long frameCount() const
+        {
+            return frames;
+        }
+
+        double secondsPerFrame() const
+        {
+            return frameSeconds;
+        }
+
+        int bucketShift() const
+        {
+            return shift;
+        }
+
+        int levelCount() const
+        {
+            return static_cast<int>(levels.size());
+        }
+
+        SlothEnvelope total(int channel) const
+        {
+            // The envelope of the whole recording.
+            return levels.empty() ? SlothEnvelope{} : levels.back()[channel];
+        }
+
+        bool matches(const SlothTrace& trace) const
+        {
+            // Was this overview built from the recording as it is now?
+            return
+                frames == trace.frameCount() &&
+                channels == trace.channelCount() &&
+                fileBytes == trace.sourceBytes() &&
+                fileTime == trace.sourceTime();
+        }
+
+        int window(int channel, long long firstFrame, long long frameCount, int pixels, SlothEnvelope *out, const float *samples = nullptr) const
+        {
+            // Fills out[0..pixels-1] with the envelope of each pixel of a window
+            // of frameCount frames starting at firstFrame, which must be a frame in
+            // the recording. Returns the number of pixels filled, which is less than
+            // `pixels` if the window extends past the end.
+            //
+            // The level is the coarsest whose buckets fit in one pixel, so
+            // each pixel combines at most 3 buckets. A pixel includes every bucket
+            // that overlaps it, so its envelope may extend by less than a bucket
+            // on either side. If the window is too fine for the finest level,
+            // the interleaved `samples` the overview was built from are used instead,
+            // when they are passed in; otherwise the finest level is used anyway.
+            if (pixels <= 0 || frameCount <= 0 || firstFrame < 0 || firstFrame >= frames)
+                return 0;
+
+            const long long last = std::min(frames, firstFrame + frameCount);
+            const double framesPerPixel = static_cast<double>(frameCount) / pixels;
+
+            int level = -1;     // -1 means the samples themselves
+            if (samples == nullptr || framesPerPixel >= (1LL << shift))
+            {
+                const int k = (framesPerPixel >= 1.0) ? static_cast<int>(std::floor(std::log2(framesPerPixel))) : 0;
+                level = std::max(0, std::min(levelCount() - 1, k - shift));
+            }
+            const int s = (level < 0) ? 0 : (shift + level);
+
+            int filled = 0;
+            for (int p = 0; p < pixels; ++p)
+            {
+                long long a = firstFrame + (p * frameCount) / pixels;
+                long long b = firstFrame + ((p + 1) * frameCount) / pixels;
+                b = std::min(b, last);
+                if (a >= last)
+                    break;
+                if (b <= a)
+                    b = a + 1;      // zoomed in past single frames
+
+                const long long j0 = a >> s;
+                const long long j1 = ((b - 1) >> s) + 1;
+                SlothEnvelope env;
+                if (level < 0)
+                {
+                    double sum = 0.0;
+                    env.min = env.max = samples[j0*channels + channel];
+                    for (long long j = j0; j < j1; ++j)
+                    {
+                        const float v = samples[j*channels + channel];
+                        env.min = std::min(env.min, v);
+                        env.max = std::max(env.max, v);
+                        sum += v;
+                    }
+                    env.mean = static_cast<float>(sum / (j1 - j0));
+                }
+                else
+                {
+                    const std::vector<SlothEnvelope>& buckets = levels[level];
+                    double sum = 0.0;
+                    double count = 0.0;
+                    env = buckets[j0*channels + channel];
+                    for (long long j = j0; j < j1; ++j)
+                    {
+                        const SlothEnvelope& e = buckets[j*channels + channel];
+                        const double n = static_cast<double>(framesInBucket(s, j));
+                        env.min = std::min(env.min, e.min);
+                        env.max = std::max(env.max, e.max);
+                        sum += n * e.mean;
+                        count += n;
+                    }
+                    env.mean = static_cast<float>(sum / count);
+                }
+                out[filled++] = env;
+            }
+            return filled;
+        }
+
+        bool save(const char *filename) const
+        {
+            SlothOverviewHeader header{};
+            std::memcpy(header.magic, SlothOverviewMagic, sizeof(header.magic));
+            header.version = SlothOverviewVersion;
+            header.byteOrder = SlothOverviewByteOrder;
+            header.channelCount = static_cast<std::uint32_t>(channels);
+            header.shift = static_cast<std::uint32_t>(shift);
+            header.levelCount = static_cast<std::uint32_t>(levels.size());
+            header.frameCount = static_cast<std::uint64_t>(frames);
+            header.sourceBytes = fileBytes;
+            header.sourceTime = fileTime;
+            header.secondsPerFrame = frameSeconds;
+
+            FILE *outfile = fopen(filename, "wb");
+            if (outfile == nullptr)
+                return false;
+
+            bool ok = (fwrite(&header, sizeof(header), 1, outfile) == 1);
+            for (const std::vector<SlothEnvelope>& level : levels)
+                ok = ok && (fwrite(level.data(), sizeof(SlothEnvelope), level.size(), outfile) == level.size());
+            return (fclose(outfile) == 0) && ok;
+        }
+
+        bool load(const char *filename)
+        {
+            // Reads an overview file. Returns false, leaving the overview empty,
+            // if the file is missing, was written by a different version,
+            // or has the wrong size. The size the header implies is checked against
+            // the actual file size before allocating anything, so a truncated or
+            // corrupt file cannot make the overview allocate a huge amount of memory.
+            levels.clear();
+            frames = 0;
+
+            FILE *infile = fopen(filename, "rb");
+            if (infile == nullptr)
+                return false;
+
+            const long actualBytes = (fseek(infile, 0, SEEK_END) == 0) ? ftell(infile) : -1;
+            SlothOverviewHeader header;
+            bool ok =
+                (actualBytes >= 0) &&
+                (fseek(infile, 0, SEEK_SET) == 0) &&
+                (fread(&header, sizeof(header), 1, infile) == 1) &&
+                !std::memcmp(header.magic, SlothOverviewMagic, sizeof(header.magic)) &&
+                header.version == SlothOverviewVersion &&
+                header.byteOrder == SlothOverviewByteOrder &&
+                header.channelCount > 0 && header.channelCount <= 64 &&
+                header.shift > 0 && header.shift < 48 &&
+                header.frameCount < (1ULL << 48);
+
+            if (ok)
+            {
+                std::uint32_t levelCount;
+                const std::uint64_t expectedBytes = fileSize(static_cast<long long>(header.frameCount), static_cast<int>(header.channelCount), static_cast<int>(header.shift), levelCount);
+                ok = (levelCount == header.levelCount) && (expectedBytes == static_cast<std::uint64_t>(actualBytes));
+            }
+
+            if (ok)
+            {
+                channels = static_cast<int>(header.channelCount);
+                shift = static_cast<int>(header.shift);
+                frames = static_cast<long long>(header.frameCount);
+                frameSeconds = header.secondsPerFrame;
+                fileBytes = header.sourceBytes;
+                fileTime = header.sourceTime;
+                allocate();
+                ok = (levels.size() == header.levelCount);
+                for (std::vector<SlothEnvelope>& level : levels)
+                    ok = ok && (fread(level.data(), sizeof(SlothEnvelope), level.size(), infile) == level.size());
+                ok = ok && (fgetc(infile) == EOF);
+            }
+
+            fclose(infile);
+            if (!ok)
+            {
+                levels.clear();
+                frames = 0;
+            }
+            return ok;
+        }
+    };
+
+
+    inline std::string OverviewFileName(const char *recordingFileName)
+    {
+        return std::string(recordingFileName) + ".ovw";
+    }
+
+
+    inline bool LoadOrBuildOverview(SlothOverview& overview, const SlothTrace& trace, const char *overviewFileName)
+    {
+        // Loads the overview file if it is up to date with the recording.
+        // Otherwise builds the overview and tries to save it for next time.
+        // Returns true if the overview was loaded, false if it was built.
+        if (overview.load(overviewFileName) && overview.matches(trace))
+            return true;
+
+        overview.build(trace);
+        overview.save(overviewFileName);
+        return false;
+    }
+}
@@ -0,0 +1,261 @@
+/*
+    SlothPool.hpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Spreads the work of simulating many independent Sloth voices
+    across a fixed pool of worker threads.
+
+    SlothThreadPool runs a batch of numbered tasks on its workers and the
+    calling thread together. Each thread claims the next unclaimed task with
+    a single atomic compare-and-swap, so faster threads naturally take more
+    tasks from slower ones. The calling thread never locks a mutex, waits on
+    a condition variable, or allocates memory, so `run` can be called from
+    a real-time audio callback. Idle workers spin briefly, then yield,
+    then sleep in short intervals until the next batch arrives.
+
+    SlothEnsemble owns a collection of voices and renders one audio block
+    for all of them per call, dividing the voices into tasks for the pool.
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #include <immintrin.h>
+#endif
+
+namespace Analog
+{
+    class SlothThreadPool
+    {
+    private:
+        // The batch number in the upper 32 bits, and the index of the next
+        // unclaimed task in the lower 32 bits. Packing them together means a
+        // thread can never claim a task from a batch that has already finished.
+        // Between batches the index is parked at `idleIndex`, which is never
+        // less than any task count, so nothing can be claimed while the next
+        // batch is being published.
+        static constexpr std::uint64_t idleIndex = 0xffffffff;
+        std::atomic<std::uint64_t> claim{idleIndex};
+
+        // The current batch. These are only written while no batch is running.
+        std::atomic<std::uint32_t> taskCount{0};
+        std::atomic<void (*)(void *, int)> taskFunc{nullptr};
+        std::atomic<void *> taskContext{nullptr};
+
+        std::atomic<std::uint32_t> completed{0};
+        std::atomic<bool> quit{false};
+        std::vector<std::thread> workers;
+
+        static void pause()
+        {
+#if defined(__x86_64__) || defined(_M_X64)
+            _mm_pause();
+#endif
+        }
+
+        bool runTasks()
+        {
+            // Claim and run tasks from the current batch until there are none left.
+            // Returns true if this thread ran at least one task.
+            bool worked = false;
+            std::uint64_t c = claim.load(std::memory_order_acquire);
+            while (true)
+            {
+                std::uint32_t index = static_cast<std::uint32_t>(c);
+                if (index >= taskCount.load(std::memory_order_acquire))
+                    return worked;
+
+                if (claim.compare_exchange_weak(c, c + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+                {
+                    // The batch cannot finish until this task does,
+                    // so the batch's function and context are stable here.
+                    void (*func)(void *, int) = taskFunc.load(std::memory_order_relaxed);
+                    func(taskContext.load(std::memory_order_relaxed), static_cast<int>(index));
+                    completed.fetch_add(1, std::memory_order_release);
+                    worked = true;
+                    c = claim.load(std::memory_order_acquire);
+                }
+            }
+        }
+
+        void workerLoop()
+        {
+            int idle = 0;
+            while (!quit.load(std::memory_order_relaxed))
+            {
+                if (runTasks())
+                {
+                    idle = 0;
+                }
+                else if (++idle < 1000)
+                {
+                    pause();
+                }
+                else if (idle < 2000)
+                {
+                    std::this_thread::yield();
+                }
+                else
+                {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                    idle = 2000;
+                }
+            }
+        }
+
+        template <typename func_t>
+        static void invoke(void *context, int task)
+        {
+            (*static_cast<func_t *>(context))(task);
+        }
+
+    public:
+        explicit SlothThreadPool(int nWorkers = defaultWorkerCount())
+        {
+            // Creates `nWorkers` background threads. The thread that calls `run`
+            // also works on tasks, so a pool with zero workers runs everything inline.
+            for (int i = 0; i < nWorkers; ++i)
+                workers.emplace_back([this]{ workerLoop(); });
+        }
+
+        ~SlothThreadPool()
+        {
+            quit.store(true, std::memory_order_relaxed);
+            for (std::thread& t : workers)
+                t.join();
+        }
+
+        SlothThreadPool(const SlothThreadPool&) = delete;
+        SlothThreadPool& operator = (const SlothThreadPool&) = delete;
+
+        static int defaultWorkerCount()
+        {
+            // One worker per hardware thread, less the calling thread.
+            int n = static_cast<int>(std::thread::hardware_concurrency());
+            return std::max(0, n - 1);
+        }
+
+        int workerCount() const
+        {
+            return static_cast<int>(workers.size());
+        }
+
+        template <typename func_t>
+        void run(int nTasks, func_t& func)
+        {
+            // Calls func(task) once for each task in [0, nTasks), spread across
+            // the workers and the calling thread. Returns after every task has finished.
+            // Only one thread may call `run` at a time.
+            if (nTasks <= 0)
+                return;
+
+            // Publish the batch, then start it by moving the claim word to a new batch number.
+            completed.store(0, std::memory_order_relaxed);
+            taskFunc.store(&invoke<func_t>, std::memory_order_relaxed);
+            taskContext.store(&func, std::memory_order_relaxed);
+            // Publishing the count with release orders the previous batch's park store before it.
+            // Otherwise a worker on a weakly ordered CPU could see the new, larger count while
+            // `claim` still reads as the finished batch, and claim a task past that batch's end.
+            taskCount.store(static_cast<std::uint32_t>(nTasks), std::memory_order_release);
+            std::uint64_t batch = (claim.load(std::memory_order_relaxed) >> 32) + 1;
+            claim.store(batch << 32, std::memory_order_release);
+
+            runTasks();
+
+            // Wait for tasks still running on other threads.
+            for (int spin = 0; completed.load(std::memory_order_acquire) != static_cast<std::uint32_t>(nTasks); ++spin)
+            {
+                if (spin < 1000)
+                    pause();
+                else
+                    std::this_thread::yield();
+            }
+
+            // Park the claim index, so no thread can claim a task until the next batch is published.
+            claim.store((batch << 32) | idleIndex, std::memory_order_release);
+        }
+    };
+
+
+    template <typename circuit_t>
+    class SlothEnsemble
+    {
+    private:
+        std::vector<circuit_t> voices;
+        std::vector<float> xBuffer;
+        std::vector<float> yBuffer;
+        std::vector<float> zBuffer;
+        int maxBlockSamples;
+        int voicesPerTask;
+
+        // The arguments of the block being rendered.
+        float blockSampleRateHz = 0.0f;
+        int blockSamples = 0;
+
+    public:
+        SlothEnsemble(int nVoices, int maximumBlockSamples, int voicesPerTask_ = 16)
+            : voices(nVoices)
+            , xBuffer(static_cast<std::size_t>(nVoices) * maximumBlockSamples)
+            , yBuffer(static_cast<std::size_t>(nVoices) * maximumBlockSamples)
+            , zBuffer(static_cast<std::size_t>(nVoices) * maximumBlockSamples)
+            , maxBlockSamples(maximumBlockSamples)
+            , voicesPerTask(std::max(1, voicesPerTask_))
+            {}
+
+        int size() const
+        {
+            return static_cast<int>(voices.size());
+        }
+
+        circuit_t& voice(int index)
+        {
+            return voices[index];
+        }
+
+        const float *xOutput(int index) const
+        {
+            return &xBuffer[static_cast<std::size_t>(index) * maxBlockSamples];
+        }
+
+        const float *yOutput(int index) const
+        {
+            return &yBuffer[static_cast<std::size_t>(index) * maxBlockSamples];
+        }
+
+        const float *zOutput(int index) const
+        {
+            return &zBuffer[static_cast<std::size_t>(index) * maxBlockSamples];
+        }
+
+        void operator() (int task)
+        {
+            // Renders the voices belonging to one task.
+            int first = task * voicesPerTask;
+            int last = std::min(size(), first + voicesPerTask);
+            for (int v = first; v < last; ++v)
+            {
+                std::size_t offset = static_cast<std::size_t>(v) * maxBlockSamples;
+                voices[v].process(blockSampleRateHz, blockSamples, &xBuffer[offset], &yBuffer[offset], &zBuffer[offset]);
+            }
+        }
+
+        int process(SlothThreadPool& pool, float sampleRateHz, int nSamples)
+        {
+            // Renders the next `nSamples` samples of every voice, but no more than
+            // the maximum block size passed to the constructor.
+            // Returns the number of samples rendered, so a caller with a larger
+            // buffer can call again for the rest.
+            // Afterward, xOutput(v) etc. point to the samples of voice v.
+            blockSampleRateHz = sampleRateHz;
+            blockSamples = std::max(0, std::min(nSamples, maxBlockSamples));
+            int nTasks = (size() + voicesPerTask - 1) / voicesPerTask;
+            pool.run(nTasks, *this);
+            return blockSamples;
+        }
+    };
+}
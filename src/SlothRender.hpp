@@ -0,0 +1,413 @@
+/*
+    SlothRender.hpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Renders long Sloth trajectories to disk for offline sample-library production.
+
+    Each render simulates one variant at a fixed knob position and control voltage
+    with the block `process` function, and writes x, y, and z as three interleaved
+    channels of 32-bit floats. The output is either a WAV file (WAVE_FORMAT_IEEE_FLOAT)
+    or raw samples with no header. A render is deterministic: its bytes depend only
+    on the variant, knob, CV, duration, and sample rate. The chunk size, the number
+    of threads, and the other renders running at the same time make no difference.
+
+    The samples are streamed through two 4096-byte-aligned chunk buffers.
+    While the simulation fills one chunk, a background thread writes the other,
+    so the simulation rarely waits for the disk. Every chunk is a whole number of
+    4096-byte pages, and a WAV file's header is padded to exactly 4096 bytes,
+    so every write except the last starts and ends on a page boundary.
+
+    A WAV file whose size exceeds the 4 GB limit of RIFF is finished as RF64
+    (EBU Tech 3306), using the space reserved for it by a JUNK chunk in the header.
+
+    RunRenders spreads independent renders across a SlothThreadPool, one render per task.
+*/
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SlothCircuit.hpp"
+#include "SlothPool.hpp"
+
+namespace Analog
+{
+    enum class SlothRenderFormat
+    {
+        Wav,
+        Raw,
+    };
+
+
+    struct SlothRenderSpec
+    {
+        double seconds = 60.0;                  // simulated time of each render
+        float sampleRateHz = 44100.0f;
+        SlothRenderFormat format = SlothRenderFormat::Wav;
+        int chunkFrames = 65536;                // frames per chunk, rounded up to a multiple of 1024
+
+        long long frameCount() const
+        {
+            return static_cast<long long>(seconds * sampleRateHz + 0.5);
+        }
+
+        int alignedChunkFrames() const
+        {
+            // 1024 frames of 3 floats each is exactly 3 pages of 4096 bytes.
+            return std::max(1, (chunkFrames + 1023) / 1024) * 1024;
+        }
+    };
+
+
+    struct SlothRenderJob
+    {
+        SlothVariant variant = SlothVariant::Torpor;
+        double knob = 0.0;
+        double cv = 0.0;
+        std::string filename;
+    };
+
+
+    // Writes chunks of samples to a file on a background thread, double buffered.
+    class SlothChunkWriter
+    {
+    private:
+        static constexpr std::size_t alignment = 4096;
+
+        FILE *outfile = nullptr;
+        std::size_t capacity = 0;           // floats per buffer
+        float *buffers[2] {nullptr, nullptr};
+        int fillIndex = 0;                  // the buffer the caller is filling
+
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable signal;
+        int pendingIndex = -1;              // the buffer being written, or -1 if the writer is idle
+        std::size_t pendingCount = 0;
+        bool quit = false;
+        bool ok = true;
+
+        void writerLoop()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true)
+            {
+                signal.wait(lock, [this]{ return quit || pendingIndex >= 0; });
+                if (pendingIndex < 0)
+                    return;
+
+                // Write without holding the lock, so the caller can keep filling the other buffer.
+                const float *data = buffers[pendingIndex];
+                const std::size_t count = pendingCount;
+                lock.unlock();
+                const bool written = (fwrite(data, sizeof(float), count, outfile) == count);
+                lock.lock();
+
+                ok = ok && written;
+                pendingIndex = -1;
+                signal.notify_all();
+            }
+        }
+
+        void waitIdle()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            signal.wait(lock, [this]{ return pendingIndex < 0; });
+        }
+
+    public:
+        SlothChunkWriter() = default;
+        SlothChunkWriter(const SlothChunkWriter&) = delete;
+        SlothChunkWriter& operator = (const SlothChunkWriter&) = delete;
+
+        ~SlothChunkWriter()
+        {
+            close();
+        }
+
+        bool open(const char *filename, std::size_t floatsPerChunk)
+        {
+            close();
+            outfile = fopen(filename, "wb");
+            if (outfile == nullptr)
+                return false;
+
+            // The chunks are already large, so bypass the C library's buffer.
+            setvbuf(outfile, nullptr, _IONBF, 0);
+
+            capacity = floatsPerChunk;
+            for (float *& b : buffers)
+                b = static_cast<float *>(::operator new(capacity * sizeof(float), std::align_val_t(alignment)));
+
+            fillIndex = 0;
+            pendingIndex = -1;
+            quit = false;
+            ok = true;
+            thread = std::thread([this]{ writerLoop(); });
+            return true;
+        }
+
+        bool write(const void *data, std::size_t nbytes)
+        {
+            // Appends bytes directly, bypassing the chunk buffers, after any chunk in progress.
+            if (outfile == nullptr)
+                return false;
+            waitIdle();
+            const bool written = (fwrite(data, 1, nbytes, outfile) == nbytes);
+            std::lock_guard<std::mutex> lock(mutex);
+            ok = ok && written;
+            return written;
+        }
+
+        bool rewrite(long offset, const void *data, std::size_t nbytes)
+        {
+            // Overwrites bytes already in the file, for example a header.
+            // Call this only after submitting the last chunk.
+            if (outfile == nullptr)
+                return false;
+            waitIdle();
+            const bool written = (fseek(outfile, offset, SEEK_SET) == 0) && (fwrite(data, 1, nbytes, outfile) == nbytes);
+            std::lock_guard<std::mutex> lock(mutex);
+            ok = ok && written;
+            return written;
+        }
+
+        float *chunk()
+        {
+            // The buffer to fill next, with room for the number of floats passed to `open`.
+            return buffers[fillIndex];
+        }
+
+        void submit(std::size_t count)
+        {
+            // Hands the first `count` floats of chunk() to the writer thread,
+            // after the previous chunk has been written.
+            std::unique_lock<std::mutex> lock(mutex);
+            signal.wait(lock, [this]{ return pendingIndex < 0; });
+            pendingIndex = fillIndex;
+            pendingCount = std::min(count, capacity);
+            signal.notify_all();
+            fillIndex ^= 1;
+        }
+
+        bool close()
+        {
+            // Finishes writing, closes the file, and returns true if every write succeeded.
+            if (outfile == nullptr)
+                return ok;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                quit = true;
+                signal.notify_all();
+            }
+            thread.join();
+
+            ok = (fclose(outfile) == 0) && ok;
+            outfile = nullptr;
+            for (float *& b : buffers)
+            {
+                ::operator delete(b, std::align_val_t(alignment));
+                b = nullptr;
+            }
+            return ok;
+        }
+    };
+
+
+    // The 4096-byte header of a WAV file of 3 float channels.
+    class SlothWavHeader
+    {
+    private:
+        unsigned char bytes[4096] {};
+        std::size_t pos = 0;
+
+        void tag(const char *id)
+        {
+            std::memcpy(&bytes[pos], id, 4);
+            pos += 4;
+        }
+
+        void u16(unsigned value)
+        {
+            bytes[pos++] = static_cast<unsigned char>(value);
+            bytes[pos++] = static_cast<unsigned char>(value >> 8);
+        }
+
+        void u32(std::uint32_t value)
+        {
+            for (int i = 0; i < 4; ++i)
+                bytes[pos++] = static_cast<unsigned char>(value >> (8*i));
+        }
+
+        void u64(std::uint64_t value)
+        {
+            for (int i = 0; i < 8; ++i)
+                bytes[pos++] = static_cast<unsigned char>(value >> (8*i));
+        }
+
+        static std::uint32_t limit(std::uint64_t value)
+        {
+            return (value > 0xffffffffu) ? 0xffffffffu : static_cast<std::uint32_t>(value);
+        }
+
+    public:
+        static constexpr int channels = 3;
+        static constexpr std::size_t size = sizeof(bytes);
+
+        SlothWavHeader(float sampleRateHz, std::uint64_t frames)
+        {
+            const std::uint32_t rate = static_cast<std::uint32_t>(sampleRateHz + 0.5f);
+            const std::uint64_t dataBytes = frames * channels * sizeof(float);
+            const std::uint64_t riffBytes = size - 8 + dataBytes;
+            const bool rf64 = (riffBytes > 0xffffffffu);
+
+            tag(rf64 ? "RF64" : "RIFF");
+            u32(limit(riffBytes));
+            tag("WAVE");
+
+            // Reserve room for the ds64 chunk, which replaces the JUNK chunk in an RF64 file.
+            tag(rf64 ? "ds64" : "JUNK");
+            u32(28);
+            if (rf64)
+            {
+                u64(riffBytes);
+                u64(dataBytes);
+                u64(frames);
+                u32(0);         // no table entries
+            }
+            else
+            {
+                pos += 28;
+            }
+
+            tag("fmt ");
+            u32(18);
+            u16(3);             // WAVE_FORMAT_IEEE_FLOAT
+            u16(channels);
+            u32(rate);
+            u32(rate * channels * sizeof(float));
+            u16(channels * sizeof(float));
+            u16(32);
+            u16(0);             // no extension
+
+            tag("fact");
+            u32(4);
+            u32(limit(frames));
+
+            // Pad so the samples start exactly at the end of the header.
+            tag("JUNK");
+            u32(static_cast<std::uint32_t>(size - pos - 12));
+            pos = size - 8;
+
+            tag("data");
+            u32(limit(dataBytes));
+        }
+
+        const unsigned char *data() const
+        {
+            return bytes;
+        }
+    };
+
+
+    template <typename circuit_t>
+    bool RenderTrajectory(const SlothRenderJob& job, const SlothRenderSpec& spec)
+    {
+        // Renders one trajectory to job.filename. Returns false if the file could not be written.
+        circuit_t circuit;
+        circuit.setKnobPosition(job.knob);
+        circuit.setControlVoltage(job.cv);
+
+        const long long totalFrames = spec.frameCount();
+        const int chunkFrames = spec.alignedChunkFrames();
+        const std::size_t channels = SlothWavHeader::channels;
+
+        SlothChunkWriter writer;
+        if (!writer.open(job.filename.c_str(), chunkFrames * channels))
+            return false;
+
+        const bool wav = (spec.format == SlothRenderFormat::Wav);
+        if (wav)
+        {
+            // Write a placeholder header, then the real one once the length is known.
+            const SlothWavHeader placeholder(spec.sampleRateHz, 0);
+            writer.write(placeholder.data(), SlothWavHeader::size);
+        }
+
+        std::vector<float> x(chunkFrames);
+        std::vector<float> y(chunkFrames);
+        std::vector<float> z(chunkFrames);
+        for (long long done = 0; done < totalFrames; )
+        {
+            const int n = static_cast<int>(std::min<long long>(chunkFrames, totalFrames - done));
+            circuit.process(spec.sampleRateHz, n, x.data(), y.data(), z.data());
+
+            float *out = writer.chunk();
+            for (int i = 0; i < n; ++i)
+            {
+                out[channels*i + 0] = x[i];
+                out[channels*i + 1] = y[i];
+                out[channels*i + 2] = z[i];
+            }
+            writer.submit(channels * n);
+            done += n;
+        }
+
+        if (wav)
+        {
+            const SlothWavHeader header(spec.sampleRateHz, static_cast<std::uint64_t>(totalFrames));
+            writer.rewrite(0, header.data(), SlothWavHeader::size);
+        }
+        return writer.close();
+    }
+
+
+    inline bool RenderJob(const SlothRenderJob& job, const SlothRenderSpec& spec)
+    {
+        switch (job.variant)
+        {
+        case SlothVariant::Torpor:  return RenderTrajectory<TorporSlothCircuit> (job, spec);
+        case SlothVariant::Apathy:  return RenderTrajectory<ApathySlothCircuit> (job, spec);
+        case SlothVariant::Inertia: return RenderTrajectory<InertiaSlothCircuit>(job, spec);
+        default:                    return false;
+        }
+    }
+
+
+    inline int FindDuplicateRender(const std::vector<SlothRenderJob>& jobs)
+    {
+        // Returns the index of the first job whose filename repeats an earlier job's, or -1 if there is none.
+        std::set<std::string> names;
+        for (std::size_t i = 0; i < jobs.size(); ++i)
+            if (!names.insert(jobs[i].filename).second)
+                return static_cast<int>(i);
+        return -1;
+    }
+
+
+    inline int RunRenders(SlothThreadPool& pool, const std::vector<SlothRenderJob>& jobs, const SlothRenderSpec& spec)
+    {
+        // Runs every render, in parallel across the pool's threads.
+        // Returns the number of renders whose files could not be written.
+        // Two renders writing the same file at once would corrupt it, so if any two jobs
+        // have the same filename, nothing is rendered and every job counts as failed.
+        if (FindDuplicateRender(jobs) >= 0)
+            return static_cast<int>(jobs.size());
+
+        std::vector<char> failed(jobs.size(), 0);
+        auto task = [&](int index)
+        {
+            failed[index] = !RenderJob(jobs[index], spec);
+        };
+        pool.run(static_cast<int>(jobs.size()), task);
+        return static_cast<int>(std::count(failed.begin(), failed.end(), 1));
+    }
+}
@@ -0,0 +1,91 @@
+/*
+    SlothRing.hpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    A lock-free ring buffer for passing samples from exactly one producer
+    thread to exactly one consumer thread, for example from a simulation
+    thread to a render loop.
+
+    The producer owns the write counter and the consumer owns the read
+    counter. Each side publishes its counter with a release store after
+    touching the slots, and reads the other side's counter with an acquire
+    load, so neither side ever locks, waits, or allocates. Items are moved
+    in blocks, so the atomics are touched once per block, not once per item.
+    The counters run freely and are reduced to a slot index by masking,
+    so the capacity is always a power of two.
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace Analog
+{
+    template <typename item_t>
+    class SlothRing
+    {
+    private:
+        std::vector<item_t> slots;
+        const std::size_t mask;
+
+        // Keep the two counters on separate cache lines,
+        // so the producer and consumer do not contend for them.
+        alignas(64) std::atomic<std::size_t> writeCount{0};
+        alignas(64) std::atomic<std::size_t> readCount{0};
+
+        static std::size_t roundUpPowerOfTwo(std::size_t n)
+        {
+            std::size_t p = 1;
+            while (p < n)
+                p <<= 1;
+            return p;
+        }
+
+    public:
+        explicit SlothRing(std::size_t minimumCapacity)
+            : slots(roundUpPowerOfTwo(std::max<std::size_t>(2, minimumCapacity)))
+            , mask(slots.size() - 1)
+            {}
+
+        SlothRing(const SlothRing&) = delete;
+        SlothRing& operator = (const SlothRing&) = delete;
+
+        std::size_t capacity() const
+        {
+            return slots.size();
+        }
+
+        std::size_t write(const item_t *items, std::size_t count)
+        {
+            // Producer only. Copies as many of `items` as there is room for,
+            // and returns how many were copied.
+            const std::size_t w = writeCount.load(std::memory_order_relaxed);
+            const std::size_t r = readCount.load(std::memory_order_acquire);
+            const std::size_t n = std::min(count, slots.size() - (w - r));
+            for (std::size_t i = 0; i < n; ++i)
+                slots[(w + i) & mask] = items[i];
+            writeCount.store(w + n, std::memory_order_release);
+            return n;
+        }
+
+        std::size_t read(item_t *items, std::size_t maxCount)
+        {
+            // Consumer only. Copies up to `maxCount` of the oldest items
+            // into `items`, and returns how many were copied.
+            const std::size_t r = readCount.load(std::memory_order_relaxed);
+            const std::size_t w = writeCount.load(std::memory_order_acquire);
+            const std::size_t n = std::min(maxCount, w - r);
+            for (std::size_t i = 0; i < n; ++i)
+                items[i] = slots[(r + i) & mask];
+            readCount.store(r + n, std::memory_order_release);
+            return n;
+        }
+
+        std::size_t available() const
+        {
+            // Consumer only: the number of items waiting to be read.
+            return writeCount.load(std::memory_order_acquire) - readCount.load(std::memory_order_relaxed);
+        }
+    };
+}
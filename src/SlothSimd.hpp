@@ -0,0 +1,305 @@
+/*
+    SlothSimd.hpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    A minimal portable wrapper around SIMD instructions that operate
+    on packs of 64-bit floating point numbers. It provides only the
+    operations needed by the multi-voice Sloth engines.
+
+    The instruction set is chosen at compile time:
+
+        AVX-512     8 lanes     (e.g. g++ -mavx512f)
+        AVX         4 lanes     (e.g. g++ -mavx2)
+        SSE2        2 lanes     (default on x86-64)
+        NEON        2 lanes     (default on 64-bit ARM)
+        scalar      1 lane      (anything else, or define SLOTH_NO_SIMD)
+
+    Every operation is an exact IEEE 754 operation, the same as its
+    scalar equivalent, so SIMD code produces bit-identical results.
+
+    That holds only if the compiler does not fuse a multiply and an add
+    into one rounding (FMA contraction). GCC does that to scalar code
+    whenever the target has FMA instructions, for example with -mfma,
+    -mavx512f, or -march=native, but never to the SlothVec operations.
+    Build with -ffp-contract=off, as the scripts in this directory do.
+    FloatContractionEnabled detects a build that contracts.
+*/
+#pragma once
+
+#if !defined(SLOTH_NO_SIMD) && defined(__AVX512F__)
+    #define SLOTH_SIMD_AVX512 1
+    #include <immintrin.h>
+#elif !defined(SLOTH_NO_SIMD) && defined(__AVX__)
+    #define SLOTH_SIMD_AVX 1
+    #include <immintrin.h>
+#elif !defined(SLOTH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+    #define SLOTH_SIMD_SSE2 1
+    #include <emmintrin.h>
+#elif !defined(SLOTH_NO_SIMD) && defined(__ARM_NEON) && defined(__aarch64__)
+    #define SLOTH_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
+namespace Analog
+{
+    // A pack of boolean flags, one per lane, produced by comparing two SlothVec values.
+    struct SlothMask
+    {
+#if defined(SLOTH_SIMD_AVX512)
+        __mmask8 m;
+#elif defined(SLOTH_SIMD_AVX)
+        __m256d m;
+#elif defined(SLOTH_SIMD_SSE2)
+        __m128d m;
+#elif defined(SLOTH_SIMD_NEON)
+        uint64x2_t m;
+#else
+        bool m;
+#endif
+
+        static SlothMask broadcast(bool flag)
+        {
+#if defined(SLOTH_SIMD_AVX512)
+            return SlothMask{static_cast<__mmask8>(flag ? 0xff : 0x00)};
+#elif defined(SLOTH_SIMD_AVX)
+            return SlothMask{_mm256_castsi256_pd(_mm256_set1_epi64x(flag ? -1 : 0))};
+#elif defined(SLOTH_SIMD_SSE2)
+            return SlothMask{_mm_castsi128_pd(_mm_set1_epi64x(flag ? -1 : 0))};
+#elif defined(SLOTH_SIMD_NEON)
+            return SlothMask{vdupq_n_u64(flag ? ~0ULL : 0ULL)};
+#else
+            return SlothMask{flag};
+#endif
+        }
+
+        bool any() const
+        {
+#if defined(SLOTH_SIMD_AVX512)
+            return m != 0;
+#elif defined(SLOTH_SIMD_AVX)
+            return _mm256_movemask_pd(m) != 0;
+#elif defined(SLOTH_SIMD_SSE2)
+            return _mm_movemask_pd(m) != 0;
+#elif defined(SLOTH_SIMD_NEON)
+            return vmaxvq_u32(vreinterpretq_u32_u64(m)) != 0;
+#else
+            return m;
+#endif
+        }
+
+        friend SlothMask operator & (SlothMask a, SlothMask b)
+        {
+#if defined(SLOTH_SIMD_AVX512)
+            return SlothMask{static_cast<__mmask8>(a.m & b.m)};
+#elif defined(SLOTH_SIMD_AVX)
+            return SlothMask{_mm256_and_pd(a.m, b.m)};
+#elif defined(SLOTH_SIMD_SSE2)
+            return SlothMask{_mm_and_pd(a.m, b.m)};
+#elif defined(SLOTH_SIMD_NEON)
+            return SlothMask{vandq_u64(a.m, b.m)};
+#else
+            return SlothMask{a.m && b.m};
+#endif
+        }
+
+        friend SlothMask operator | (SlothMask a, SlothMask b)
+        {
+#if defined(SLOTH_SIMD_AVX512)
+            return SlothMask{static_cast<__mmask8>(a.m | b.m)};
+#elif defined(SLOTH_SIMD_AVX)
+            return SlothMask{_mm256_or_pd(a.m, b.m)};
+#elif defined(SLOTH_SIMD_SSE2)
+            return SlothMask{_mm_or_pd(a.m, b.m)};
+#elif defined(SLOTH_SIMD_NEON)
+            return SlothMask{vorrq_u64(a.m, b.m)};
+#else
+            return SlothMask{a.m || b.m};
+#endif
+        }
+
+        friend SlothMask andNot(SlothMask a, SlothMask b)     // a & ~b
+        {
+#if defined(SLOTH_SIMD_AVX512)
+            return SlothMask{static_cast<__mmask8>(a.m & ~b.m)};
+#elif defined(SLOTH_SIMD_AVX)
+            return SlothMask{_mm256_andnot_pd(b.m, a.m)};
+#elif defined(SLOTH_SIMD_SSE2)
+            return SlothMask{_mm_andnot_pd(b.m, a.m)};
+#elif defined(SLOTH_SIMD_NEON)
+            return SlothMask{vbicq_u64(a.m, b.m)};
+#else
+            return SlothMask{a.m && !b.m};
+#endif
+        }
+    };
+
+
+    // A pack of SlothVec::width double-precision numbers.
+    struct SlothVec
+    {
+#if defined(SLOTH_SIMD_AVX512)
+        static constexpr int width = 8;
+        __m512d v;
+#elif defined(SLOTH_SIMD_AVX)
+        static constexpr int width = 4;
+        __m256d v;
+#elif defined(SLOTH_SIMD_SSE2)
+        static constexpr int width = 2;
+        __m128d v;
+#elif defined(SLOTH_SIMD_NEON)
+        static constexpr int width = 2;
+        float64x2_t v;
+#else
+        static constexpr int width = 1;
+        double v;
+#endif
+
+        static SlothVec broadcast(double x)
+        {
+#if defined(SLOTH_SIMD_AVX512)
+            return SlothVec{_mm512_set1_pd(x)};
+#elif defined(SLOTH_SIMD_AVX)
+            return SlothVec{_mm256_set1_pd(x)};
+#elif defined(SLOTH_SIMD_SSE2)
+            return SlothVec{_mm_set1_pd(x)};
+#elif defined(SLOTH_SIMD_NEON)
+            return SlothVec{vdupq_n_f64(x)};
+#else
+            return SlothVec{x};
+#endif
+        }
+
+        static SlothVec load(const double *p)     // p must be aligned to 64 bytes
+        {
+#if defined(SLOTH_SIMD_AVX512)
+            return SlothVec{_mm512_load_pd(p)};
+#elif defined(SLOTH_SIMD_AVX)
+            return SlothVec{_mm256_load_pd(p)};
+#elif defined(SLOTH_SIMD_SSE2)
+            return SlothVec{_mm_load_pd(p)};
+#elif defined(SLOTH_SIMD_NEON)
+            return SlothVec{vld1q_f64(p)};
+#else
+            return SlothVec{*p};
+#endif
+        }
+
+        void store(double *p) const     // p must be aligned to 64 bytes
+        {
+#if defined(SLOTH_SIMD_AVX512)
+            _mm512_store_pd(p, v);
+#elif defined(SLOTH_SIMD_AVX)
+            _mm256_store_pd(p, v);
+#elif defined(SLOTH_SIMD_SSE2)
+            _mm_store_pd(p, v);
+#elif defined(SLOTH_SIMD_NEON)
+            vst1q_f64(p, v);
+#else
+            *p = v;
+#endif
+        }
+
+        friend SlothVec operator + (SlothVec a, SlothVec b)
+        {
+#if defined(SLOTH_SIMD_AVX512)
+            return SlothVec{_mm512_add_pd(a.v, b.v)};
+#elif defined(SLOTH_SIMD_AVX)
+            return SlothVec{_mm256_add_pd(a.v, b.v)};
+#elif defined(SLOTH_SIMD_SSE2)
+            return SlothVec{_mm_add_pd(a.v, b.v)};
+#elif defined(SLOTH_SIMD_NEON)
+            return SlothVec{vaddq_f64(a.v, b.v)};
+#else
+            return SlothVec{a.v + b.v};
+#endif
+        }
+
+        friend SlothVec operator - (SlothVec a, SlothVec b)
+        {
+#if defined(SLOTH_SIMD_AVX512)
+            return SlothVec{_mm512_sub_pd(a.v, b.v)};
+#elif defined(SLOTH_SIMD_AVX)
+            return SlothVec{_mm256_sub_pd(a.v, b.v)};
+#elif defined(SLOTH_SIMD_SSE2)
+            return SlothVec{_mm_sub_pd(a.v, b.v)};
+#elif defined(SLOTH_SIMD_NEON)
+            return SlothVec{vsubq_f64(a.v, b.v)};
+#else
+            return SlothVec{a.v - b.v};
+#endif
+        }
+
+        friend SlothVec operator * (SlothVec a, SlothVec b)
+        {
+#if defined(SLOTH_SIMD_AVX512)
+            return SlothVec{_mm512_mul_pd(a.v, b.v)};
+#elif defined(SLOTH_SIMD_AVX)
+            return SlothVec{_mm256_mul_pd(a.v, b.v)};
+#elif defined(SLOTH_SIMD_SSE2)
+            return SlothVec{_mm_mul_pd(a.v, b.v)};
+#elif defined(SLOTH_SIMD_NEON)
+            return SlothVec{vmulq_f64(a.v, b.v)};
+#else
+            return SlothVec{a.v * b.v};
+#endif
+        }
+
+        friend SlothVec operator / (SlothVec a, SlothVec b)
+        {
+#if defined(SLOTH_SIMD_AVX512)
+            return SlothVec{_mm512_div_pd(a.v, b.v)};
+#elif defined(SLOTH_SIMD_AVX)
+            return SlothVec{_mm256_div_pd(a.v, b.v)};
+#elif defined(SLOTH_SIMD_SSE2)
+            return SlothVec{_mm_div_pd(a.v, b.v)};
+#elif defined(SLOTH_SIMD_NEON)
+            return SlothVec{vdivq_f64(a.v, b.v)};
+#else
+            return SlothVec{a.v / b.v};
+#endif
+        }
+
+        friend SlothMask operator < (SlothVec a, SlothVec b)
+        {
+#if defined(SLOTH_SIMD_AVX512)
+            return SlothMask{_mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ)};
+#elif defined(SLOTH_SIMD_AVX)
+            return SlothMask{_mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ)};
+#elif defined(SLOTH_SIMD_SSE2)
+            return SlothMask{_mm_cmplt_pd(a.v, b.v)};
+#elif defined(SLOTH_SIMD_NEON)
+            return SlothMask{vcltq_f64(a.v, b.v)};
+#else
+            return SlothMask{a.v < b.v};
+#endif
+        }
+
+        friend SlothVec select(SlothMask mask, SlothVec a, SlothVec b)     // mask ? a : b, lane by lane
+        {
+#if defined(SLOTH_SIMD_AVX512)
+            return SlothVec{_mm512_mask_blend_pd(mask.m, b.v, a.v)};
+#elif defined(SLOTH_SIMD_AVX)
+            return SlothVec{_mm256_blendv_pd(b.v, a.v, mask.m)};
+#elif defined(SLOTH_SIMD_SSE2)
+            return SlothVec{_mm_or_pd(_mm_and_pd(mask.m, a.v), _mm_andnot_pd(mask.m, b.v))};
+#elif defined(SLOTH_SIMD_NEON)
+            return SlothVec{vbslq_f64(mask.m, a.v, b.v)};
+#else
+            return SlothVec{mask.m ? a.v : b.v};
+#endif
+        }
+    };
+
+
+    inline bool FloatContractionEnabled()
+    {
+        // Returns true if this translation unit was compiled so that a*b + c
+        // is evaluated with a single rounding. With a = 1 + 2^-30, a*a rounds
+        // to 1 + 2^-29, so the separately rounded result is exactly zero,
+        // but the fused result keeps the 2^-60 term.
+        volatile double va = 1.0 + 0x1p-30;
+        volatile double vc = -(1.0 + 0x1p-29);
+        double a = va;
+        double c = vc;
+        return a*a + c != 0.0;
+    }
+}
@@ -0,0 +1,204 @@
+/*
+    SlothSnapshot.hpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    A compact binary file format holding precomputed Sloth circuit states,
+    so voices can start at a mature point on their attractor
+    without simulating a warm-up period.
+
+    The file contains a header followed by a table of 32-bit floats:
+
+        state[variant][knob][cv][time] = (x, w, y, z)
+
+    Each of the knob, cv, and time axes is a uniform grid from its minimum
+    to its maximum value, inclusive. A time is the number of real-time seconds
+    elapsed since `initialize()`, with the knob and CV held constant.
+    The variants are stored in the order of the SlothVariant enum.
+
+    SlothSnapshotTable reads the table in place, so it can be used directly
+    on a memory-mapped file without copying or parsing anything.
+*/
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "SlothCircuit.hpp"
+
+namespace Analog
+{
+    // The grid of knob positions, control voltages, and elapsed times.
+    struct SlothSnapshotGrid
+    {
+        std::uint32_t knobCount = 11;
+        std::uint32_t cvCount = 11;
+        std::uint32_t timeCount = 8;
+        float knobMin = 0.0f;
+        float knobMax = 1.0f;
+        float cvMin = -1.0f;
+        float cvMax = +1.0f;
+        float timeMin = 60.0f;
+        float timeMax = 480.0f;
+
+        static float value(float lo, float hi, std::uint32_t count, std::uint32_t index)
+        {
+            return (count > 1) ? lo + (hi - lo) * (static_cast<float>(index) / (count - 1)) : lo;
+        }
+
+        static std::uint32_t nearest(float lo, float hi, std::uint32_t count, double v)
+        {
+            // Find the index of the grid value closest to `v`, clamped to the grid.
+            if (count <= 1 || !(hi > lo))
+                return 0;
+            double f = std::round((v - lo) / (hi - lo) * (count - 1));
+            return static_cast<std::uint32_t>(std::max(0.0, std::min(static_cast<double>(count - 1), f)));
+        }
+    };
+
+
+    struct SlothSnapshotHeader
+    {
+        char magic[8];              // "SLOTHSNP"
+        std::uint32_t version;      // SlothSnapshotVersion
+        std::uint32_t byteOrder;    // SlothSnapshotByteOrder, as written by the generating machine
+        std::uint32_t variantCount;
+        SlothSnapshotGrid grid;
+    };
+
+    static_assert(sizeof(SlothSnapshotHeader) == 56, "SlothSnapshotHeader must not contain padding.");
+
+    const char SlothSnapshotMagic[8] = {'S', 'L', 'O', 'T', 'H', 'S', 'N', 'P'};
+    const std::uint32_t SlothSnapshotVersion = 1;
+    const std::uint32_t SlothSnapshotByteOrder = 0x01020304;
+
+
+    class SlothSnapshotTable
+    {
+    private:
+        const SlothSnapshotHeader *header = nullptr;
+        const float *table = nullptr;
+
+    public:
+        static std::size_t fileSize(std::uint32_t variantCount, const SlothSnapshotGrid& grid)
+        {
+            std::size_t states = static_cast<std::size_t>(variantCount) * grid.knobCount * grid.cvCount * grid.timeCount;
+            return sizeof(SlothSnapshotHeader) + 4 * sizeof(float) * states;
+        }
+
+        bool attach(const void *data, std::size_t size)
+        {
+            // Use the snapshot file contents at `data`, which must remain valid
+            // while this table is in use, and must be aligned to at least 4 bytes.
+            // Returns false if the data is not a compatible snapshot file.
+            header = nullptr;
+            table = nullptr;
+
+            if (data == nullptr || size < sizeof(SlothSnapshotHeader))
+                return false;
+
+            const SlothSnapshotHeader *h = static_cast<const SlothSnapshotHeader *>(data);
+            if (std::memcmp(h->magic, SlothSnapshotMagic, sizeof(h->magic)))
+                return false;
+
+            if (h->version != SlothSnapshotVersion || h->byteOrder != SlothSnapshotByteOrder)
+                return false;
+
+            if (h->variantCount == 0 || h->grid.knobCount == 0 || h->grid.cvCount == 0 || h->grid.timeCount == 0)
+                return false;
+
+            if (size != fileSize(h->variantCount, h->grid))
+                return false;
+
+            header = h;
+            table = reinterpret_cast<const float *>(h + 1);
+            return true;
+        }
+
+        bool isAttached() const
+        {
+            return header != nullptr;
+        }
+
+        const SlothSnapshotGrid& grid() const
+        {
+            return header->grid;
+        }
+
+        bool hasVariant(SlothVariant variant) const
+        {
+            return isAttached() && static_cast<std::uint32_t>(variant) < header->variantCount;
+        }
+
+        SlothState state(SlothVariant variant, std::uint32_t knobIndex, std::uint32_t cvIndex, std::uint32_t timeIndex) const
+        {
+            // Returns the state stored at the given grid indices.
+            const SlothSnapshotGrid& g = header->grid;
+            std::size_t index = ((static_cast<std::size_t>(variant) * g.knobCount + knobIndex) * g.cvCount + cvIndex) * g.timeCount + timeIndex;
+            const float *s = table + 4*index;
+            return SlothState{s[0], s[1], s[2], s[3]};
+        }
+
+        SlothState nearest(SlothVariant variant, double knob, double cv, double seconds) const
+        {
+            // Returns the stored state whose grid point is closest to the given settings.
+            const SlothSnapshotGrid& g = header->grid;
+            return state(
+                variant,
+                SlothSnapshotGrid::nearest(g.knobMin, g.knobMax, g.knobCount, knob),
+                SlothSnapshotGrid::nearest(g.cvMin, g.cvMax, g.cvCount, cv),
+                SlothSnapshotGrid::nearest(g.timeMin, g.timeMax, g.timeCount, seconds)
+            );
+        }
+    };
+
+
+    template <typename circuit_t>
+    void RenderSnapshots(const SlothSnapshotGrid& grid, float *table)
+    {
+        // Fill in the states for one variant, in the order they are stored in the file.
+        // Each knob/CV combination is simulated once, fast-forwarding from one time to the next.
+        for (std::uint32_t k = 0; k < grid.knobCount; ++k)
+        {
+            for (std::uint32_t c = 0; c < grid.cvCount; ++c)
+            {
+                circuit_t circuit;
+                circuit.setKnobPosition(SlothSnapshotGrid::value(grid.knobMin, grid.knobMax, grid.knobCount, k));
+                circuit.setControlVoltage(SlothSnapshotGrid::value(grid.cvMin, grid.cvMax, grid.cvCount, c));
+                double elapsed = 0.0;
+                for (std::uint32_t t = 0; t < grid.timeCount; ++t)
+                {
+                    double seconds = SlothSnapshotGrid::value(grid.timeMin, grid.timeMax, grid.timeCount, t);
+                    circuit.advance(seconds - elapsed);
+                    elapsed = seconds;
+                    *table++ = static_cast<float>(circuit.xVoltage());
+                    *table++ = static_cast<float>(circuit.wVoltage());
+                    *table++ = static_cast<float>(circuit.yVoltage());
+                    *table++ = static_cast<float>(circuit.zVoltage());
+                }
+            }
+        }
+    }
+
+
+    inline std::vector<float> GenerateSnapshotFile(const SlothSnapshotGrid& grid)
+    {
+        // Returns the contents of a snapshot file for all variants.
+        // The file is built in a vector of floats so that it is suitably aligned.
+        const std::size_t size = SlothSnapshotTable::fileSize(SlothVariantCount, grid);
+        std::vector<float> file(size / sizeof(float));
+
+        SlothSnapshotHeader header;
+        std::memcpy(header.magic, SlothSnapshotMagic, sizeof(header.magic));
+        header.version = SlothSnapshotVersion;
+        header.byteOrder = SlothSnapshotByteOrder;
+        header.variantCount = SlothVariantCount;
+        header.grid = grid;
+        std::memcpy(file.data(), &header, sizeof(header));
+
+        float *table = file.data() + sizeof(header)/sizeof(float);
+        const std::size_t variantFloats = 4 * static_cast<std::size_t>(grid.knobCount) * grid.cvCount * grid.timeCount;
+        RenderSnapshots<TorporSlothCircuit> (grid, table + 0*variantFloats);
+        RenderSnapshots<ApathySlothCircuit> (grid, table + 1*variantFloats);
+        RenderSnapshots<InertiaSlothCircuit>(grid, table + 2*variantFloats);
+        return file;
+    }
+}
@@ -0,0 +1,202 @@
+/*
+    SlothStatic.hpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    A Sloth circuit whose component values, time dilation, and initial
+    charge voltage are compile-time constants supplied by a parameter type,
+    such as TorporParameters. The constants fold into the coefficient
+    expressions, and the object holds only the circuit inputs, node voltages,
+    and cached coefficients.
+
+    A custom variant can derive its parameters from an existing one:
+
+        struct SlowerParameters : Analog::TorporParameters
+        {
+            static constexpr double timeDilation = 0.5;
+            static constexpr double C2 = 1.0e-6;
+        };
+
+        Analog::StaticSlothCircuit<SlowerParameters> circuit;
+
+    StaticSlothCircuit uses the iterative midpoint solver. With the standard
+    parameters, it produces exactly the same voltages as the corresponding
+    SlothCircuit class.
+*/
+#pragma once
+
+#include "SlothCircuit.hpp"
+
+namespace Analog
+{
+    template <typename params_t, typename real_t = double>
+    class StaticSlothCircuit
+    {
+    private:
+        using Solver = SlothSolverT<real_t>;
+        using Roundoff = typename Solver::Roundoff;
+
+        // Inputs
+        double K{};     // the total resistance R3 (fixed) + R9 (variable)
+        double U{};     // control voltage fed into the circuit via R8
+
+        // Node voltages
+        real_t x1{};
+        real_t w1{};
+        real_t y1{};
+        real_t z1{};
+        Roundoff roundoff;
+
+        // Cached solver coefficients, valid for the sample rate `coefSampleRateHz`,
+        // or invalid if it is zero.
+        SlothCoefficientsT<real_t> coef;
+        float coefSampleRateHz = 0.0f;
+
+        void refreshCoefficients(float sampleRateHz)
+        {
+            coef.template calculate<params_t>(params_t::timeDilation / sampleRateHz, K, U);
+            coefSampleRateHz = sampleRateHz;
+        }
+
+    public:
+        // The iteration safety limit for the convergence solver.
+        static constexpr int iterationLimit = 5;
+
+        StaticSlothCircuit()
+        {
+            initialize();
+            setKnobPosition(0.0);
+            setControlVoltage(0.0);
+        }
+
+        void initialize()
+        {
+            w1 = static_cast<real_t>(params_t::w0);
+            x1 = 0;
+            y1 = 0;
+            z1 = 0;
+            roundoff = Roundoff();
+        }
+
+        SlothState saveState() const
+        {
+            return SlothState{x1, w1, y1, z1};
+        }
+
+        void restoreState(const SlothState& state)
+        {
+            x1 = static_cast<real_t>(state.x);
+            w1 = static_cast<real_t>(state.w);
+            y1 = static_cast<real_t>(state.y);
+            z1 = static_cast<real_t>(state.z);
+            roundoff = Roundoff();
+        }
+
+        void setKnobPosition(double fraction)
+        {
+            double k = params_t::knobResistance(fraction);
+            if (k != K)
+            {
+                K = k;
+                coefSampleRateHz = 0.0f;
+            }
+        }
+
+        void setControlVoltage(double cv)
+        {
+            double u = params_t::clampControlVoltage(cv);
+            if (u != U)
+            {
+                U = u;
+                coefSampleRateHz = 0.0f;
+            }
+        }
+
+        static constexpr double timeDilationFactor()
+        {
+            return params_t::timeDilation;
+        }
+
+        static constexpr double initialChargeVoltage()
+        {
+            return params_t::w0;
+        }
+
+        double variableResistance() const
+        {
+            return K;
+        }
+
+        double controlVoltage() const
+        {
+            return U;
+        }
+
+        double xVoltage() const
+        {
+            return x1;
+        }
+
+        double wVoltage() const
+        {
+            return w1;
+        }
+
+        double yVoltage() const
+        {
+            return y1;
+        }
+
+        double zVoltage() const
+        {
+            return z1;
+        }
+
+        int update(float sampleRateHz)      // returns the number of iterations needed for convergence [1..iterationLimit]
+        {
+            if (sampleRateHz != coefSampleRateHz)
+                refreshCoefficients(sampleRateHz);
+
+            return Solver::solve(iterationLimit, coef, x1, w1, y1, z1, roundoff);
+        }
+
+        int process(float sampleRateHz, int nSamples, float *xOutput, float *yOutput, float *zOutput)
+        {
+            // Generates a block of `nSamples` consecutive samples, exactly as if
+            // `update` had been called once per sample. Any of the output buffers
+            // may be null if the caller does not need that voltage.
+            // Returns the largest iteration count needed by any sample in the block.
+
+            if (sampleRateHz != coefSampleRateHz)
+                refreshCoefficients(sampleRateHz);
+
+            const SlothCoefficientsT<real_t> c = coef;
+            real_t x = x1;
+            real_t w = w1;
+            real_t y = y1;
+            real_t z = z1;
+            Roundoff r = roundoff;
+            int maxIter = 0;
+
+            for (int s = 0; s < nSamples; ++s)
+            {
+                int iter = Solver::solve(iterationLimit, c, x, w, y, z, r);
+                maxIter = std::max(maxIter, iter);
+
+                if (xOutput) xOutput[s] = static_cast<float>(x);
+                if (yOutput) yOutput[s] = static_cast<float>(y);
+                if (zOutput) zOutput[s] = static_cast<float>(z);
+            }
+
+            x1 = x;
+            w1 = w;
+            y1 = y;
+            z1 = z;
+            roundoff = r;
+            return maxIter;
+        }
+    };
+
+
+    using StaticTorporSlothCircuit  = StaticSlothCircuit<TorporParameters>;
+    using StaticApathySlothCircuit  = StaticSlothCircuit<ApathyParameters>;
+    using StaticInertiaSlothCircuit = StaticSlothCircuit<InertiaParameters>;
+}
@@ -0,0 +1,285 @@
+/*
+    SlothSweep.hpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Maps the behavior of the Sloth variants over a grid of knob positions
+    and control voltages. Each grid point is simulated alongside a twin whose
+    control voltage is perturbed very slightly, the way ButterflyEffect does it,
+    to measure how long the two take to diverge. Along the way we collect
+    summary statistics of the point's trajectory.
+
+    Each SlothBank simulates several points at once in its SIMD lanes,
+    and the banks are spread across the threads of a SlothThreadPool.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "SlothBank.hpp"
+#include "SlothPool.hpp"
+
+namespace Analog
+{
+    struct SlothSweepSpec
+    {
+        std::vector<SlothVariant> variants {SlothVariant::Torpor, SlothVariant::Apathy, SlothVariant::Inertia};
+        int knobCount = 11;
+        double knobMin = 0.0;
+        double knobMax = 1.0;
+        int cvCount = 25;
+        double cvMin = -12.0;
+        double cvMax = +12.0;
+        double seconds = 100.0;                 // simulated time per point
+        float sampleRateHz = 44100.0f;
+        double cvPerturbation = 1.0e-4;         // the twin's CV offset, in volts
+        double divergenceThreshold = 0.1;       // distance in the (x, y) plane, in volts
+
+        static double value(double lo, double hi, int count, int index)
+        {
+            return (count > 1) ? lo + (hi - lo) * (static_cast<double>(index) / (count - 1)) : lo;
+        }
+
+        int pointCount() const
+        {
+            return static_cast<int>(variants.size()) * knobCount * cvCount;
+        }
+
+        double twinControlVoltage(double cv) const
+        {
+            // The twin's CV is perturbed toward the interior of the supply rails.
+            // Perturbing past a rail would be clamped back, leaving the twin
+            // on exactly the same trajectory, so it would never diverge.
+            const double u = SlothComponents::clampControlVoltage(cv);
+            const double twin = u + cvPerturbation;
+            return (SlothComponents::clampControlVoltage(twin) == twin) ? twin : (u - cvPerturbation);
+        }
+    };
+
+
+    // The summary of one grid point, in the compact form written to sweep files.
+    struct SlothSweepPoint
+    {
+        std::uint32_t variant;          // a SlothVariant value
+        float knob;
+        float cv;
+        float divergenceSeconds;        // negative if the twin never diverged
+        float meanIterations;
+        float xMin, xMax;
+        float yMin, yMax;
+        float zMin, zMax;
+        float crossingsPerSecond;       // how often z changes polarity, toggling the comparator
+    };
+
+    static_assert(sizeof(SlothSweepPoint) == 48, "SlothSweepPoint must not contain padding.");
+
+
+    class SlothSweep
+    {
+    private:
+        // Each bank holds pairs of lanes: lane 2*i is a grid point and lane 2*i+1 is its twin.
+        static constexpr int LANES = 8;
+        static constexpr int POINTS_PER_BANK = LANES / 2;
+        using bank_t = SlothBank<LANES>;
+
+        const SlothSweepSpec& spec;
+        std::vector<SlothSweepPoint>& results;
+
+        template <typename circuit_t>
+        static void setLane(bank_t& bank, int lane, double knob, double cv)
+        {
+            circuit_t circuit;
+            circuit.setKnobPosition(knob);
+            circuit.setControlVoltage(cv);
+            bank.setVoice(lane, circuit);
+        }
+
+        static void setLane(bank_t& bank, int lane, SlothVariant variant, double knob, double cv)
+        {
+            switch (variant)
+            {
+            case SlothVariant::Apathy:  setLane<ApathySlothCircuit> (bank, lane, knob, cv);  break;
+            case SlothVariant::Inertia: setLane<InertiaSlothCircuit>(bank, lane, knob, cv);  break;
+            default:                    setLane<TorporSlothCircuit> (bank, lane, knob, cv);  break;
+            }
+        }
+
+        SlothSweepPoint describe(int index) const
+        {
+            // Find the variant, knob, and CV for the grid point with the given index.
+            int c = index % spec.cvCount;
+            int k = (index / spec.cvCount) % spec.knobCount;
+            int v = index / (spec.cvCount * spec.knobCount);
+            SlothSweepPoint p{};
+            p.variant = static_cast<std::uint32_t>(spec.variants[v]);
+            p.knob = static_cast<float>(SlothSweepSpec::value(spec.knobMin, spec.knobMax, spec.knobCount, k));
+            p.cv = static_cast<float>(SlothSweepSpec::value(spec.cvMin, spec.cvMax, spec.cvCount, c));
+            return p;
+        }
+
+    public:
+        SlothSweep(const SlothSweepSpec& _spec, std::vector<SlothSweepPoint>& _results)
+            : spec(_spec)
+            , results(_results)
+        {
+            results.resize(spec.pointCount());
+            for (int i = 0; i < spec.pointCount(); ++i)
+                results[i] = describe(i);
+        }
+
+        int taskCount() const
+        {
+            return (spec.pointCount() + POINTS_PER_BANK - 1) / POINTS_PER_BANK;
+        }
+
+        void operator() (int task)
+        {
+            // Simulate the grid points belonging to one bank.
+            const int first = task * POINTS_PER_BANK;
+            const int count = std::min(POINTS_PER_BANK, spec.pointCount() - first);
+
+            bank_t bank;
+            for (int i = 0; i < count; ++i)
+            {
+                const SlothSweepPoint& p = results[first + i];
+                SlothVariant variant = static_cast<SlothVariant>(p.variant);
+                setLane(bank, 2*i, variant, p.knob, p.cv);
+                setLane(bank, 2*i + 1, variant, p.knob, spec.twinControlVoltage(p.cv));
+            }
+
+            double xMin[POINTS_PER_BANK], xMax[POINTS_PER_BANK];
+            double yMin[POINTS_PER_BANK], yMax[POINTS_PER_BANK];
+            double zMin[POINTS_PER_BANK], zMax[POINTS_PER_BANK];
+            double zPrev[POINTS_PER_BANK];
+            long iterSum[POINTS_PER_BANK];
+            long crossings[POINTS_PER_BANK];
+            long divergeSample[POINTS_PER_BANK];
+            for (int i = 0; i < POINTS_PER_BANK; ++i)
+            {
+                xMin[i] = yMin[i] = zMin[i] = +1.0e+9;
+                xMax[i] = yMax[i] = zMax[i] = -1.0e+9;
+                zPrev[i] = bank.zVoltage(2*i);
+                iterSum[i] = 0;
+                crossings[i] = 0;
+                divergeSample[i] = -1;
+            }
+
+            const long nSamples = static_cast<long>(spec.seconds * spec.sampleRateHz);
+            int laneIter[LANES];
+            for (long sample = 0; sample < nSamples; ++sample)
+            {
+                bank.update(spec.sampleRateHz, laneIter);
+                for (int i = 0; i < count; ++i)
+                {
+                    const double x = bank.xVoltage(2*i);
+                    const double y = bank.yVoltage(2*i);
+                    const double z = bank.zVoltage(2*i);
+                    xMin[i] = std::min(xMin[i], x);
+                    xMax[i] = std::max(xMax[i], x);
+                    yMin[i] = std::min(yMin[i], y);
+                    yMax[i] = std::max(yMax[i], y);
+                    zMin[i] = std::min(zMin[i], z);
+                    zMax[i] = std::max(zMax[i], z);
+                    iterSum[i] += laneIter[2*i];
+                    if ((z < 0.0) != (zPrev[i] < 0.0))
+                        ++crossings[i];
+                    zPrev[i] = z;
+
+                    if (divergeSample[i] < 0)
+                    {
+                        const double dist = std::hypot(bank.xVoltage(2*i + 1) - x, bank.yVoltage(2*i + 1) - y);
+                        if (dist > spec.divergenceThreshold)
+                            divergeSample[i] = sample;
+                    }
+                }
+            }
+
+            for (int i = 0; i < count; ++i)
+            {
+                SlothSweepPoint& p = results[first + i];
+                p.divergenceSeconds = (divergeSample[i] < 0) ? -1.0f : static_cast<float>(divergeSample[i] / spec.sampleRateHz);
+                p.meanIterations = static_cast<float>(static_cast<double>(iterSum[i]) / std::max(1L, nSamples));
+                p.xMin = static_cast<float>(xMin[i]);
+                p.xMax = static_cast<float>(xMax[i]);
+                p.yMin = static_cast<float>(yMin[i]);
+                p.yMax = static_cast<float>(yMax[i]);
+                p.zMin = static_cast<float>(zMin[i]);
+                p.zMax = static_cast<float>(zMax[i]);
+                p.crossingsPerSecond = static_cast<float>(crossings[i] / spec.seconds);
+            }
+        }
+    };
+
+
+    inline std::vector<SlothSweepPoint> RunSweep(SlothThreadPool& pool, const SlothSweepSpec& spec)
+    {
+        std::vector<SlothSweepPoint> results;
+        SlothSweep sweep(spec, results);
+        pool.run(sweep.taskCount(), sweep);
+        return results;
+    }
+
+
+    struct SlothSweepHeader
+    {
+        char magic[8];              // "SLOTHSWP"
+        std::uint32_t version;      // SlothSweepVersion
+        std::uint32_t byteOrder;    // SlothSweepByteOrder, as written by the generating machine
+        std::uint32_t pointCount;
+        float seconds;
+        float sampleRateHz;
+        float cvPerturbation;
+        float divergenceThreshold;
+        std::uint32_t reserved;
+    };
+
+    static_assert(sizeof(SlothSweepHeader) == 40, "SlothSweepHeader must not contain padding.");
+
+    const char SlothSweepMagic[8] = {'S', 'L', 'O', 'T', 'H', 'S', 'W', 'P'};
+    const std::uint32_t SlothSweepVersion = 1;
+    const std::uint32_t SlothSweepByteOrder = 0x01020304;
+
+
+    inline bool WriteSweepFile(const char *filename, const SlothSweepSpec& spec, const std::vector<SlothSweepPoint>& results)
+    {
+        // Writes a header followed by one SlothSweepPoint record per grid point.
+        SlothSweepHeader header{};
+        std::memcpy(header.magic, SlothSweepMagic, sizeof(header.magic));
+        header.version = SlothSweepVersion;
+        header.byteOrder = SlothSweepByteOrder;
+        header.pointCount = static_cast<std::uint32_t>(results.size());
+        header.seconds = static_cast<float>(spec.seconds);
+        header.sampleRateHz = spec.sampleRateHz;
+        header.cvPerturbation = static_cast<float>(spec.cvPerturbation);
+        header.divergenceThreshold = static_cast<float>(spec.divergenceThreshold);
+
+        FILE *outfile = fopen(filename, "wb");
+        if (outfile == nullptr)
+            return false;
+
+        bool ok = (fwrite(&header, sizeof(header), 1, outfile) == 1);
+        if (ok && !results.empty())
+            ok = (fwrite(results.data(), sizeof(SlothSweepPoint), results.size(), outfile) == results.size());
+        return (fclose(outfile) == 0) && ok;
+    }
+
+
+    inline bool WriteSweepCsv(const char *filename, const std::vector<SlothSweepPoint>& results)
+    {
+        FILE *outfile = fopen(filename, "wt");
+        if (outfile == nullptr)
+            return false;
+
+        fprintf(outfile, "variant,knob,cv,divergence,iterations,xmin,xmax,ymin,ymax,zmin,zmax,crossings\n");
+        for (const SlothSweepPoint& p : results)
+        {
+            fprintf(outfile, "%s,%0.4f,%0.4f,%0.3f,%0.4f,%0.4f,%0.4f,%0.4f,%0.4f,%0.4f,%0.4f,%0.4f\n",
+                SlothVariantName(static_cast<SlothVariant>(p.variant)),
+                p.knob, p.cv, p.divergenceSeconds, p.meanIterations,
+                p.xMin, p.xMax, p.yMin, p.yMax, p.zMin, p.zMax, p.crossingsPerSecond);
+        }
+        return fclose(outfile) == 0;
+    }
+}
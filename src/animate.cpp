@@ -2,36 +2,232 @@
     animate.cpp  -  Don Cross <cosinekitty@gmail.com>  -  2023-09-10
 
     Runs the Sloth Torpor simulation and renders an X/Y plot.
+    The simulation runs in real time on its own thread,
+    passing samples to the render loop through lock-free ring buffers.
 
     https://github.com/cosinekitty/sloth
 */
 
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
 #include "SlothCircuit.hpp"
+#include "SlothRing.hpp"
 #include "plotter.hpp"
 
 
-int main()
+struct TracePoint
+{
+    float x;
+    float y;
+};
+
+
+static void Simulate(
+    const std::vector<std::unique_ptr<Analog::SlothRing<TracePoint>>>& rings,
+    const std::atomic<bool>& quit,
+    std::atomic<long>& dropped)
+{
+    // Runs one circuit per ring, keeping simulated time locked to wall-clock time
+    // no matter how quickly the render loop drains the rings.
+    // If a ring is full, the render loop has fallen behind, so the
+    // samples that do not fit are dropped rather than slowing the simulation.
+    using namespace Analog;
+    using clock = std::chrono::steady_clock;
+
+    const int voiceCount = static_cast<int>(rings.size());
+    std::vector<TorporSlothCircuit> circuits(voiceCount);
+    for (int v = 0; v < voiceCount; ++v)
+    {
+        circuits[v].setControlVoltage(-1.0 + 0.01*v);
+        circuits[v].setKnobPosition(0.0);
+    }
+
+    const int BLOCK = 256;
+    float x[BLOCK];
+    float y[BLOCK];
+    TracePoint points[BLOCK];
+    const clock::time_point start = clock::now();
+    long long produced = 0;
+    while (!quit.load(std::memory_order_relaxed))
+    {
+        std::chrono::duration<double> elapsed = clock::now() - start;
+        const long long due = static_cast<long long>(elapsed.count() * SAMPLE_RATE);
+        if (produced >= due)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        const int n = static_cast<int>(std::min<long long>(BLOCK, due - produced));
+        for (int v = 0; v < voiceCount; ++v)
+        {
+            circuits[v].process(SAMPLE_RATE, n, x, y, nullptr);
+            for (int i = 0; i < n; ++i)
+                points[i] = TracePoint{x[i], y[i]};
+            std::size_t written = rings[v]->write(points, n);
+            if (written < static_cast<std::size_t>(n))
+                dropped.fetch_add(static_cast<long>(n - written), std::memory_order_relaxed);
+        }
+        produced += n;
+    }
+}
+
+
+static int PrintUsage()
+{
+    printf("USAGE: animate [trail_length [points_per_frame [voices]]]\n");
+    printf("       animate phosphor [half_life_frames [voices]]\n");
+    printf("\n");
+    printf("The first form draws a fading trail of points, one or more per frame.\n");
+    printf("The second form accumulates every simulated sample into a decaying\n");
+    printf("density image, like the phosphor of an analog oscilloscope.\n");
+    printf("\n");
+    printf("Each voice is a separate circuit whose control voltage\n");
+    printf("differs from the previous voice's by 0.01 V.\n");
+    return 1;
+}
+
+
+int main(int argc, const char *argv[])
 {
     using namespace Analog;
 
-    Plotter plotter(5000);
+    const bool phosphor = (argc > 1 && !strcmp(argv[1], "phosphor"));
+    const int argBase = phosphor ? 2 : 1;
+    if (argc > argBase + 3 || (phosphor && argc > argBase + 2))
+        return PrintUsage();
+
+    const int MAX_TRAIL_LENGTH = 1000000;
+    int trailLength = 5000;
+    int pointsPerFrame = 1;
+    double halfLifeFrames = 300.0;
+    int voiceCount = 1;
+
+    if (phosphor)
+    {
+        if (argc > argBase)
+        {
+            halfLifeFrames = atof(argv[argBase]);
+            if (halfLifeFrames < 1.0 || halfLifeFrames > 1.0e+6)
+            {
+                printf("ERROR: half_life_frames must be a number in the range 1..1000000.\n");
+                return 1;
+            }
+        }
+        if (argc > argBase + 1)
+            voiceCount = atoi(argv[argBase + 1]);
+    }
+    else
+    {
+        if (argc > argBase)
+        {
+            trailLength = atoi(argv[argBase]);
+            if (trailLength < 2 || trailLength > MAX_TRAIL_LENGTH)
+            {
+                printf("ERROR: trail_length must be an integer in the range 2..%d.\n", MAX_TRAIL_LENGTH);
+                return 1;
+            }
+        }
+        if (argc > argBase + 1)
+        {
+            pointsPerFrame = atoi(argv[argBase + 1]);
+            if (pointsPerFrame < 1 || pointsPerFrame > SAMPLES_PER_FRAME)
+            {
+                printf("ERROR: points_per_frame must be an integer in the range 1..%d.\n", SAMPLES_PER_FRAME);
+                return 1;
+            }
+        }
+        if (argc > argBase + 2)
+            voiceCount = atoi(argv[argBase + 2]);
+    }
 
-    TorporSlothCircuit circuit;
-    circuit.setControlVoltage(-1.0);
-    circuit.setKnobPosition(0.0);
+    const Color palette[] = { GREEN, SKYBLUE, ORANGE, MAGENTA, YELLOW, RED, VIOLET, WHITE };
+    const int MAX_VOICES = static_cast<int>(sizeof(palette) / sizeof(palette[0]));
+    if (voiceCount < 1 || voiceCount > MAX_VOICES)
+    {
+        printf("ERROR: voices must be an integer in the range 1..%d.\n", MAX_VOICES);
+        return 1;
+    }
 
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Sloth Torpor Simulation");
-    SetTargetFPS(30);
-    while (!WindowShouldClose())
+    SetTargetFPS(FRAME_RATE);
     {
-        BeginDrawing();
-        ClearBackground(BLACK);
-        plotter.plot(circuit.xVoltage(), circuit.yVoltage());
-        EndDrawing();
-        for (int s = 0; s < SAMPLES_PER_FRAME; ++s)
-            circuit.update(SAMPLE_RATE);
+        // The plotters hold graphics resources, so they must be destroyed before the window is closed.
+        std::vector<std::unique_ptr<Plotter>> plotters;
+        std::vector<std::unique_ptr<PhosphorPlotter>> screens;
+        std::vector<std::unique_ptr<SlothRing<TracePoint>>> rings;
+        for (int v = 0; v < voiceCount; ++v)
+        {
+            if (phosphor)
+                screens.push_back(std::make_unique<PhosphorPlotter>(halfLifeFrames, palette[v]));
+            else
+                plotters.push_back(std::make_unique<Plotter>(trailLength, palette[v]));
+            rings.push_back(std::make_unique<SlothRing<TracePoint>>(SAMPLE_RATE));
+        }
+
+        std::atomic<bool> quit{false};
+        std::atomic<long> dropped{0};
+        std::thread simulation(Simulate, std::cref(rings), std::cref(quit), std::ref(dropped));
+
+        // In trail mode, spread the new trail points evenly across
+        // each frame's worth of samples. In phosphor mode, every sample is recorded.
+        const int stride = SAMPLES_PER_FRAME / pointsPerFrame;
+        std::vector<int> phase(voiceCount, 0);
+        std::vector<TracePoint> points(rings[0]->capacity());
+        while (!WindowShouldClose())
+        {
+            // Drain whatever the simulation has produced since the last frame.
+            for (int v = 0; v < voiceCount; ++v)
+            {
+                std::size_t n = rings[v]->read(points.data(), points.size());
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    if (phosphor)
+                    {
+                        screens[v]->append(points[i].x, points[i].y);
+                    }
+                    else
+                    {
+                        if (phase[v] == 0)
+                            plotters[v]->append(points[i].x, points[i].y);
+                        if (++phase[v] == stride)
+                            phase[v] = 0;
+                    }
+                }
+            }
+
+            BeginDrawing();
+            ClearBackground(BLACK);
+            if (phosphor)
+            {
+                // Overlapping voices add their light together.
+                BeginBlendMode(BLEND_ADDITIVE);
+                for (const auto& screen : screens)
+                    screen->draw();
+                EndBlendMode();
+            }
+            else
+            {
+                for (const auto& plotter : plotters)
+                    plotter->draw();
+            }
+            if (phosphor || pointsPerFrame > 1 || voiceCount > 1)
+                DrawFPS(10, 10);
+            long lost = dropped.load(std::memory_order_relaxed);
+            if (lost > 0)
+                DrawText(TextFormat("%ld samples dropped", lost), 10, 35, 20, GRAY);
+            EndDrawing();
+        }
+
+        quit.store(true);
+        simulation.join();
     }
     CloseWindow();
     return 0;
 }
-
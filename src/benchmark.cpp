@@ -0,0 +1,485 @@
+/*
+    benchmark.cpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Measures the speed of the Sloth simulation in nanoseconds per sample,
+    separately from the correctness tests in circuit_test.cpp.
+
+    Each benchmark is calibrated to find how many samples take at least the
+    minimum repetition time, warmed up once at that size, then timed for a
+    number of repetitions with a monotonic clock. The median repetition is
+    reported, along with the fastest and slowest, so a single disturbance
+    on a busy machine does not move the result.
+
+    For banks and ensembles, a "sample" means one sample of one voice,
+    so every benchmark is directly comparable with the scalar `update`.
+
+    https://github.com/cosinekitty/sloth
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+#include "SlothCircuit.hpp"
+#include "SlothBank.hpp"
+#include "SlothPool.hpp"
+#include "SlothModule.hpp"
+#include "SlothNetwork.hpp"
+#include "NetlistCircuit.hpp"
+#include "SlothKernels.hpp"
+
+
+struct BenchmarkSpec
+{
+    int repetitions = 5;
+    double minSeconds = 0.2;        // minimum duration of each repetition
+    const char *filter = "";        // run only benchmarks whose names contain this text
+    int threads = Analog::SlothThreadPool::defaultWorkerCount() + 1;
+};
+
+
+struct BenchmarkResult
+{
+    std::string name;
+    long long samples = 0;          // voice-samples per repetition
+    int repetitions = 0;
+    double medianNs = 0.0;          // nanoseconds per voice-sample
+    double minNs = 0.0;
+    double maxNs = 0.0;
+
+    double samplesPerSecond() const
+    {
+        return (medianNs > 0.0) ? 1.0e+9 / medianNs : 0.0;
+    }
+};
+
+
+// Keeps the compiler from discarding simulation results that are never used.
+volatile double BenchmarkSink;
+
+
+// Runs `func(n)`, which must simulate `n` units of work and return how many
+// voice-samples that was, and records the timing.
+static bool RunBenchmark(
+    const BenchmarkSpec& spec,
+    const std::string& name,
+    const std::function<long long(long long)>& func,
+    std::vector<BenchmarkResult>& results)
+{
+    using clock = std::chrono::steady_clock;
+
+    if (!strstr(name.c_str(), spec.filter))
+        return false;
+
+    // Calibrate: double the amount of work until one run takes long enough.
+    // The first runs also warm up the caches and the CPU clock.
+    long long units = 1;
+    while (true)
+    {
+        clock::time_point start = clock::now();
+        func(units);
+        std::chrono::duration<double> elapsed = clock::now() - start;
+        if (elapsed.count() >= spec.minSeconds)
+            break;
+        if (elapsed.count() < spec.minSeconds / 16)
+            units *= 8;
+        else
+            units *= 2;
+    }
+
+    std::vector<double> ns;
+    long long samples = 0;
+    for (int r = 0; r < spec.repetitions; ++r)
+    {
+        clock::time_point start = clock::now();
+        samples = func(units);
+        std::chrono::duration<double, std::nano> elapsed = clock::now() - start;
+        ns.push_back(elapsed.count() / samples);
+    }
+    std::sort(ns.begin(), ns.end());
+
+    BenchmarkResult result;
+    result.name = name;
+    result.samples = samples;
+    result.repetitions = spec.repetitions;
+    result.medianNs = (ns.size() % 2) ? ns[ns.size()/2] : (ns[ns.size()/2 - 1] + ns[ns.size()/2]) / 2;
+    result.minNs = ns.front();
+    result.maxNs = ns.back();
+    results.push_back(result);
+
+    printf("%-28s %12.3lf %12.3lf %12.3lf %14.0lf\n",
+        name.c_str(), result.medianNs, result.minNs, result.maxNs, result.samplesPerSecond());
+    fflush(stdout);
+    return true;
+}
+
+
+const float SAMPLE_RATE = 44100.0f;
+const int BLOCK = 256;
+
+
+template <typename circuit_t>
+static void UpdateBenchmark(const BenchmarkSpec& spec, const std::string& name, Analog::SlothIntegrator integrator, std::vector<BenchmarkResult>& results)
+{
+    circuit_t circuit;
+    circuit.setIntegrator(integrator);
+    RunBenchmark(spec, name, [&circuit](long long n)
+    {
+        double sum = 0.0;
+        for (long long i = 0; i < n; ++i)
+        {
+            circuit.update(SAMPLE_RATE);
+            sum += circuit.xVoltage();
+        }
+        BenchmarkSink = sum;
+        return n;
+    }, results);
+}
+
+
+template <typename params_t>
+static void NetlistBenchmark(const BenchmarkSpec& spec, const std::string& name, std::vector<BenchmarkResult>& results)
+{
+    Analog::SlothNetlist<params_t> netlist;
+    RunBenchmark(spec, name, [&netlist](long long n)
+    {
+        double sum = 0.0;
+        for (long long i = 0; i < n; ++i)
+        {
+            netlist.update(SAMPLE_RATE);
+            sum += netlist.xVoltage();
+        }
+        BenchmarkSink = sum;
+        return n;
+    }, results);
+}
+
+
+template <typename kernel_t>
+static void KernelBenchmark(const BenchmarkSpec& spec, const std::string& name, std::vector<BenchmarkResult>& results)
+{
+    kernel_t kernel;
+    RunBenchmark(spec, name, [&kernel](long long n)
+    {
+        double sum = 0.0;
+        for (long long i = 0; i < n; ++i)
+        {
+            kernel.update(SAMPLE_RATE);
+            sum += kernel.xVoltage();
+        }
+        BenchmarkSink = sum;
+        return n;
+    }, results);
+}
+
+
+template <typename circuit_t>
+static void ProcessBenchmark(const BenchmarkSpec& spec, const std::string& name, std::vector<BenchmarkResult>& results)
+{
+    circuit_t circuit;
+    std::vector<float> x(BLOCK), y(BLOCK);
+    RunBenchmark(spec, name, [&circuit, &x, &y](long long blocks)
+    {
+        for (long long b = 0; b < blocks; ++b)
+            circuit.process(SAMPLE_RATE, BLOCK, x.data(), y.data(), nullptr);
+        BenchmarkSink = x[BLOCK - 1];
+        return blocks * BLOCK;
+    }, results);
+}
+
+
+template <typename circuit_t>
+static void SpanBenchmark(const BenchmarkSpec& spec, const std::string& name, Analog::SlothIntegrator integrator, bool cvSpan, bool knobSpan, std::vector<BenchmarkResult>& results)
+{
+    // Block processing with a different control voltage and/or knob position
+    // on every sample, as when one voice modulates another at audio rate.
+    circuit_t circuit;
+    circuit.setIntegrator(integrator);
+    std::vector<float> x(BLOCK), cv(BLOCK), knob(BLOCK);
+    for (int i = 0; i < BLOCK; ++i)
+    {
+        cv[i] = static_cast<float>(std::sin(0.1 * i));
+        knob[i] = static_cast<float>(0.5 + 0.5*std::cos(0.1 * i));
+    }
+    RunBenchmark(spec, name, [&](long long blocks)
+    {
+        for (long long b = 0; b < blocks; ++b)
+            circuit.process(SAMPLE_RATE, BLOCK, x.data(), nullptr, nullptr, cvSpan ? cv.data() : nullptr, knobSpan ? knob.data() : nullptr);
+        BenchmarkSink = x[BLOCK - 1];
+        return blocks * BLOCK;
+    }, results);
+}
+
+
+template <typename circuit_t>
+static void SetterBenchmark(const BenchmarkSpec& spec, const std::string& name, std::vector<BenchmarkResult>& results)
+{
+    // The same modulation as SpanBenchmark, but setting the inputs before every call to update.
+    circuit_t circuit;
+    std::vector<float> cv(BLOCK), knob(BLOCK);
+    for (int i = 0; i < BLOCK; ++i)
+    {
+        cv[i] = static_cast<float>(std::sin(0.1 * i));
+        knob[i] = static_cast<float>(0.5 + 0.5*std::cos(0.1 * i));
+    }
+    RunBenchmark(spec, name, [&](long long blocks)
+    {
+        double sum = 0.0;
+        for (long long b = 0; b < blocks; ++b)
+        {
+            for (int i = 0; i < BLOCK; ++i)
+            {
+                circuit.setControlVoltage(cv[i]);
+                circuit.setKnobPosition(knob[i]);
+                circuit.update(SAMPLE_RATE);
+                sum += circuit.xVoltage();
+            }
+        }
+        BenchmarkSink = sum;
+        return blocks * BLOCK;
+    }, results);
+}
+
+
+template <int N>
+static void BankBenchmark(const BenchmarkSpec& spec, std::vector<BenchmarkResult>& results)
+{
+    Analog::SlothBank<N> bank;
+    for (int lane = 0; lane < N; ++lane)
+        bank.setKnobPosition(lane, lane / (N - 1.0 + 1.0e-9));
+    RunBenchmark(spec, "bank/" + std::to_string(N), [&bank](long long n)
+    {
+        for (long long i = 0; i < n; ++i)
+            bank.update(SAMPLE_RATE);
+        BenchmarkSink = bank.xVoltage(0);
+        return n * N;
+    }, results);
+}
+
+
+static void PoolBenchmark(const BenchmarkSpec& spec, Analog::SlothThreadPool& pool, int voiceCount, std::vector<BenchmarkResult>& results)
+{
+    using namespace Analog;
+    SlothEnsemble<TorporSlothCircuit> ensemble(voiceCount, BLOCK, 8);
+    for (int v = 0; v < voiceCount; ++v)
+        ensemble.voice(v).setKnobPosition(v / (voiceCount - 1.0 + 1.0e-9));
+    RunBenchmark(spec, "pool/" + std::to_string(voiceCount), [&ensemble, &pool, voiceCount](long long blocks)
+    {
+        for (long long b = 0; b < blocks; ++b)
+            ensemble.process(pool, SAMPLE_RATE, BLOCK);
+        BenchmarkSink = ensemble.xOutput(0)[BLOCK - 1];
+        return blocks * BLOCK * voiceCount;
+    }, results);
+}
+
+
+static void ModuleBenchmark(const BenchmarkSpec& spec, int channels, bool movingCv, int division, std::vector<BenchmarkResult>& results)
+{
+    // A polyphonic module, called once per sample as a modular host would.
+    // A moving CV changes every channel's input on every sample.
+    using namespace Analog;
+    SlothPolyModule module;
+    module.setChannelCount(channels);
+    module.setControlDivision(division);
+    std::string name = "module/" + std::to_string(channels) + (movingCv ? "/cv" : "");
+    if (division > 1)
+        name += "/div" + std::to_string(division);
+    RunBenchmark(spec, name, [&module, channels, movingCv](long long n)
+    {
+        float cv[SlothPolyModule::MaxChannels]{};
+        float x[SlothPolyModule::MaxChannels];
+        for (long long i = 0; i < n; ++i)
+        {
+            if (movingCv)
+                for (int c = 0; c < channels; ++c)
+                    cv[c] = static_cast<float>((i & 1023) * 0.001 + c * 0.01);
+            module.process(SAMPLE_RATE, cv, x, nullptr, nullptr);
+        }
+        BenchmarkSink = x[0];
+        return n * channels;
+    }, results);
+}
+
+
+template <int N>
+static void NetworkBenchmark(const BenchmarkSpec& spec, std::vector<BenchmarkResult>& results)
+{
+    // A ring of N nodes, each node's x voltage driving the next node's CV.
+    Analog::SlothNetwork<N> network;
+    for (int node = 0; node < N; ++node)
+    {
+        network.setKnobPosition(node, node / (N - 1.0 + 1.0e-9));
+        network.connect(node, (node + 1) % N, 0.5);
+    }
+    RunBenchmark(spec, "network/" + std::to_string(N) + "/ring", [&network](long long n)
+    {
+        for (long long i = 0; i < n; ++i)
+            network.update(SAMPLE_RATE);
+        BenchmarkSink = network.xVoltage(0);
+        return n * N;
+    }, results);
+}
+
+
+template <int N>
+static void DelayedRingBenchmark(const BenchmarkSpec& spec, std::vector<BenchmarkResult>& results)
+{
+    // The same ring made of separate circuits, each reading the previous sample of its neighbor.
+    std::vector<Analog::TorporSlothCircuit> circuits(N);
+    for (int node = 0; node < N; ++node)
+        circuits[node].setKnobPosition(node / (N - 1.0 + 1.0e-9));
+    RunBenchmark(spec, "circuits/" + std::to_string(N) + "/ring", [&circuits](long long n)
+    {
+        double previous[N];
+        for (long long i = 0; i < n; ++i)
+        {
+            for (int node = 0; node < N; ++node)
+                previous[node] = circuits[node].xVoltage();
+            for (int node = 0; node < N; ++node)
+            {
+                circuits[node].setControlVoltage(0.5 * previous[(node + N - 1) % N]);
+                circuits[node].update(SAMPLE_RATE);
+            }
+        }
+        BenchmarkSink = circuits[0].xVoltage();
+        return n * N;
+    }, results);
+}
+
+
+static bool EndsWith(const char *text, const char *suffix)
+{
+    std::size_t n = strlen(text);
+    std::size_t m = strlen(suffix);
+    return (n >= m) && !strcmp(text + n - m, suffix);
+}
+
+
+static bool WriteResults(const char *filename, const BenchmarkSpec& spec, const std::vector<BenchmarkResult>& results)
+{
+    // Writes CSV if the filename ends with .csv, otherwise JSON.
+    FILE *outfile = fopen(filename, "wt");
+    if (outfile == nullptr)
+        return false;
+
+    if (EndsWith(filename, ".csv"))
+    {
+        fprintf(outfile, "name,samples,repetitions,median_ns,min_ns,max_ns,samples_per_second\n");
+        for (const BenchmarkResult& r : results)
+            fprintf(outfile, "%s,%lld,%d,%0.4lf,%0.4lf,%0.4lf,%0.0lf\n",
+                r.name.c_str(), r.samples, r.repetitions, r.medianNs, r.minNs, r.maxNs, r.samplesPerSecond());
+    }
+    else
+    {
+        fprintf(outfile, "{\n  \"threads\": %d,\n  \"min_seconds\": %g,\n  \"benchmarks\": [\n", spec.threads, spec.minSeconds);
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const BenchmarkResult& r = results[i];
+            fprintf(outfile,
+                "    {\"name\": \"%s\", \"samples\": %lld, \"repetitions\": %d, \"median_ns\": %0.4lf, \"min_ns\": %0.4lf, \"max_ns\": %0.4lf, \"samples_per_second\": %0.0lf}%s\n",
+                r.name.c_str(), r.samples, r.repetitions, r.medianNs, r.minNs, r.maxNs, r.samplesPerSecond(),
+                (i + 1 < results.size()) ? "," : "");
+        }
+        fprintf(outfile, "  ]\n}\n");
+    }
+
+    return 0 == fclose(outfile);
+}
+
+
+static int PrintUsage()
+{
+    printf(
+        "USAGE: benchmark [options]\n"
+        "\n"
+        "Options:\n"
+        "    -f text        run only benchmarks whose names contain text\n"
+        "    -r count       timed repetitions of each benchmark (default 5)\n"
+        "    -m seconds     minimum duration of each repetition (default 0.2)\n"
+        "    -j threads     total threads for the pool benchmarks (default: all hardware threads)\n"
+        "    -o outfile     also write the results as JSON, or CSV if outfile ends with .csv\n"
+    );
+    return 1;
+}
+
+
+int main(int argc, const char *argv[])
+{
+    using namespace Analog;
+
+    BenchmarkSpec spec;
+    const char *outFileName = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *opt = argv[i];
+        int remaining = argc - i - 1;
+        if (!strcmp(opt, "-f") && remaining >= 1)
+            spec.filter = argv[++i];
+        else if (!strcmp(opt, "-r") && remaining >= 1)
+            spec.repetitions = atoi(argv[++i]);
+        else if (!strcmp(opt, "-m") && remaining >= 1)
+            spec.minSeconds = atof(argv[++i]);
+        else if (!strcmp(opt, "-j") && remaining >= 1)
+            spec.threads = atoi(argv[++i]);
+        else if (!strcmp(opt, "-o") && remaining >= 1)
+            outFileName = argv[++i];
+        else
+            return PrintUsage();
+    }
+
+    if (spec.repetitions < 1 || spec.minSeconds <= 0.0 || spec.threads < 1)
+        return PrintUsage();
+
+    printf("%-28s %12s %12s %12s %14s\n", "benchmark", "median ns", "min ns", "max ns", "samples/s");
+
+    std::vector<BenchmarkResult> results;
+    UpdateBenchmark<TorporSlothCircuit>(spec, "update/torpor", SlothIntegrator::Midpoint, results);
+    UpdateBenchmark<ApathySlothCircuit>(spec, "update/apathy", SlothIntegrator::Midpoint, results);
+    UpdateBenchmark<InertiaSlothCircuit>(spec, "update/inertia", SlothIntegrator::Midpoint, results);
+    UpdateBenchmark<TorporSlothCircuitT<float>>(spec, "update/torpor/float", SlothIntegrator::Midpoint, results);
+    UpdateBenchmark<TorporSlothCircuit>(spec, "update/torpor/exact", SlothIntegrator::Exact, results);
+    UpdateBenchmark<TorporSlothCircuit>(spec, "update/torpor/predictive", SlothIntegrator::Predictive, results);
+    UpdateBenchmark<InertiaSlothCircuit>(spec, "update/inertia/predictive", SlothIntegrator::Predictive, results);
+    UpdateBenchmark<TorporSlothCircuitT<double, SlothSolverStats>>(spec, "update/torpor/stats", SlothIntegrator::Midpoint, results);
+    NetlistBenchmark<TorporParameters>(spec, "netlist/torpor", results);
+    NetlistBenchmark<InertiaParameters>(spec, "netlist/inertia", results);
+    KernelBenchmark<TorporKernel>(spec, "kernel/torpor", results);
+    KernelBenchmark<InertiaKernel>(spec, "kernel/inertia", results);
+    ProcessBenchmark<TorporSlothCircuit>(spec, "process/torpor", results);
+    ProcessBenchmark<ApathySlothCircuit>(spec, "process/apathy", results);
+    ProcessBenchmark<InertiaSlothCircuit>(spec, "process/inertia", results);
+    SpanBenchmark<TorporSlothCircuit>(spec, "process/torpor/cv", SlothIntegrator::Midpoint, true, false, results);
+    SpanBenchmark<TorporSlothCircuit>(spec, "process/torpor/knob", SlothIntegrator::Midpoint, false, true, results);
+    SpanBenchmark<TorporSlothCircuit>(spec, "process/torpor/cv+knob", SlothIntegrator::Midpoint, true, true, results);
+    SpanBenchmark<TorporSlothCircuit>(spec, "process/torpor/exact/cv", SlothIntegrator::Exact, true, false, results);
+    SpanBenchmark<TorporSlothCircuit>(spec, "process/torpor/predictive/cv", SlothIntegrator::Predictive, true, false, results);
+    SetterBenchmark<TorporSlothCircuit>(spec, "update/torpor/cv+knob", results);
+    BankBenchmark<4>(spec, results);
+    BankBenchmark<8>(spec, results);
+    BankBenchmark<16>(spec, results);
+
+    ModuleBenchmark(spec, 1, false, 1, results);
+    ModuleBenchmark(spec, 16, false, 1, results);
+    ModuleBenchmark(spec, 16, true, 1, results);
+    ModuleBenchmark(spec, 16, true, 16, results);
+
+    NetworkBenchmark<4>(spec, results);
+    NetworkBenchmark<16>(spec, results);
+    DelayedRingBenchmark<16>(spec, results);
+
+    SlothThreadPool pool(spec.threads - 1);
+    for (int voices : {1, 8, 64, 256})
+        PoolBenchmark(spec, pool, voices, results);
+
+    if (outFileName != nullptr && !WriteResults(outFileName, spec, results))
+    {
+        printf("benchmark: error writing file: %s\n", outFileName);
+        return 1;
+    }
+    return 0;
+}
@@ -1,5 +1,27 @@
+#include <cstddef>
 #include <cstdio>
+#include <cstring>
+#include <vector>
 #include "SlothCircuit.hpp"
+#include "SlothBank.hpp"
+#include "SlothControlRate.hpp"
+#include "SlothAdaptive.hpp"
+#include "SlothSnapshot.hpp"
+#include "SlothStatic.hpp"
+#include "SlothPool.hpp"
+#include "SlothSweep.hpp"
+#include "SlothLyapunov.hpp"
+#include "SlothLog.hpp"
+#include "SlothFit.hpp"
+#include "SlothRing.hpp"
+#include "SlothAudio.hpp"
+#include "SlothModule.hpp"
+#include "SlothNetwork.hpp"
+#include "NetlistCircuit.hpp"
+#include "NetlistKernel.hpp"
+#include "SlothKernels.hpp"
+#include "SlothRender.hpp"
+#include "SlothOverview.hpp"
 #include "TimeInSeconds.hpp"
 
 
@@ -164,14 +186,2443 @@ bool ButterflyEffect(const char *name)
 }
 
 
+template <typename circuit_t>
+bool BlockProcessing(const char *name, Analog::SlothIntegrator integrator = Analog::SlothIntegrator::Midpoint)
+{
+    // Verify that block processing produces exactly the same output
+    // as calling `update` once per sample, including when the control
+    // voltage and knob position are supplied as per-sample buffers.
+
+    printf("BlockProcessing(%s): starting\n", name);
+
+    circuit_t reference;
+    circuit_t block;
+    reference.setIntegrator(integrator);
+    block.setIntegrator(integrator);
+
+    const int SAMPLE_RATE = 44100;
+    const int SIMULATION_SECONDS = 60;
+    const int SIMULATION_SAMPLES = SIMULATION_SECONDS * SAMPLE_RATE;
+    const int MAX_BLOCK = 1000;
+
+    std::vector<float> xBuffer(MAX_BLOCK);
+    std::vector<float> yBuffer(MAX_BLOCK);
+    std::vector<float> zBuffer(MAX_BLOCK);
+    std::vector<float> cvBuffer(MAX_BLOCK);
+    std::vector<float> knobBuffer(MAX_BLOCK);
+
+    int sample = 0;
+    int blockCount = 0;
+    while (sample < SIMULATION_SAMPLES)
+    {
+        // Vary the block size, and cycle through constant inputs, both per-sample
+        // inputs, a per-sample CV alone, and a per-sample knob position alone.
+        int n = std::min(SIMULATION_SAMPLES - sample, 1 + (blockCount * 337) % MAX_BLOCK);
+        int mode = blockCount % 4;
+        bool cvSpan = (mode == 1 || mode == 2);
+        bool knobSpan = (mode == 1 || mode == 3);
+
+        for (int i = 0; i < n; ++i)
+        {
+            double t = static_cast<double>(sample + i) / SAMPLE_RATE;
+            cvBuffer[i] = static_cast<float>(0.1 + 0.05*std::sin(0.7 * t));
+            knobBuffer[i] = static_cast<float>(0.5 + 0.25*std::cos(0.3 * t));
+        }
+
+        int maxIter;
+        if (!cvSpan)
+            block.setControlVoltage(cvBuffer[0]);
+        if (!knobSpan)
+            block.setKnobPosition(knobBuffer[0]);
+        maxIter = block.process(
+            SAMPLE_RATE, n, xBuffer.data(), yBuffer.data(), zBuffer.data(),
+            cvSpan ? cvBuffer.data() : nullptr,
+            knobSpan ? knobBuffer.data() : nullptr);
+
+        if (maxIter < 1 || maxIter >= block.iterationLimit)
+        {
+            printf("BlockProcessing(%s): unexpected max iteration count %d in block %d\n", name, maxIter, blockCount);
+            return false;
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+            reference.setControlVoltage(cvSpan ? cvBuffer[i] : cvBuffer[0]);
+            reference.setKnobPosition(knobSpan ? knobBuffer[i] : knobBuffer[0]);
+            reference.update(SAMPLE_RATE);
+
+            if (xBuffer[i] != static_cast<float>(reference.xVoltage()) ||
+                yBuffer[i] != static_cast<float>(reference.yVoltage()) ||
+                zBuffer[i] != static_cast<float>(reference.zVoltage()))
+            {
+                printf("BlockProcessing(%s): MISMATCH at sample %d\n", name, sample + i);
+                return false;
+            }
+
+            if (!CheckVoltage(xBuffer[i], "x", sample + i)) return false;
+            if (!CheckVoltage(yBuffer[i], "y", sample + i)) return false;
+            if (!CheckVoltage(zBuffer[i], "z", sample + i)) return false;
+        }
+
+        sample += n;
+        ++blockCount;
+    }
+
+    printf("BlockProcessing(%s): PASS (%d blocks)\n", name, blockCount);
+    return true;
+}
+
+
+template <typename circuit_t>
+bool ExactIntegrator(const char *name)
+{
+    // Verify that the exact linear integrator stays in bounds,
+    // agrees closely with the iterative midpoint solver, and only
+    // needs to fall back to iteration on rare comparator crossings.
+
+    using namespace Analog;
+
+    printf("ExactIntegrator(%s): starting\n", name);
+
+    circuit_t midpoint;
+    midpoint.setControlVoltage(+0.1);
+    midpoint.setKnobPosition(0.5);
+
+    circuit_t exact;
+    exact.setControlVoltage(+0.1);
+    exact.setKnobPosition(0.5);
+    exact.setIntegrator(SlothIntegrator::Exact);
+
+    const int SAMPLE_RATE = 44100;
+    const int SIMULATION_SECONDS = 60;
+    const int SIMULATION_SAMPLES = SIMULATION_SECONDS * SAMPLE_RATE;
+
+    int fallbackCount = 0;
+    double maxDiff = 0.0;
+    for (int sample = 0; sample < SIMULATION_SAMPLES; ++sample)
+    {
+        midpoint.update(SAMPLE_RATE);
+        int iter = exact.update(SAMPLE_RATE);
+        if (iter < 1 || iter >= exact.iterationLimit)
+        {
+            printf("ExactIntegrator(%s): unexpected iteration count %d at sample %d\n", name, iter, sample);
+            return false;
+        }
+
+        if (iter > 1)
+            ++fallbackCount;
+
+        if (!CheckVoltage(exact.xVoltage(), "x", sample)) return false;
+        if (!CheckVoltage(exact.yVoltage(), "y", sample)) return false;
+        if (!CheckVoltage(exact.zVoltage(), "z", sample)) return false;
+
+        maxDiff = std::max(maxDiff, std::abs(exact.xVoltage() - midpoint.xVoltage()));
+        maxDiff = std::max(maxDiff, std::abs(exact.yVoltage() - midpoint.yVoltage()));
+    }
+
+    printf("ExactIntegrator(%s): fallback steps = %d, max diff from midpoint = %lg V\n", name, fallbackCount, maxDiff);
+
+    if (maxDiff > 1.0e-6)
+    {
+        printf("ExactIntegrator(%s): EXCESSIVE difference from midpoint solver.\n", name);
+        return false;
+    }
+
+    if (fallbackCount > SIMULATION_SAMPLES / 1000)
+    {
+        printf("ExactIntegrator(%s): EXCESSIVE number of fallback steps.\n", name);
+        return false;
+    }
+
+    printf("ExactIntegrator(%s): PASS\n", name);
+    return true;
+}
+
+
+template <typename circuit_t>
+bool ControlRate(const char *name)
+{
+    // Verify that a circuit stepped at a reduced control rate, with linear
+    // interpolation, stays within its estimated error of the full-rate circuit.
+
+    using namespace Analog;
+
+    printf("ControlRate(%s): starting\n", name);
+
+    circuit_t reference;
+    reference.setControlVoltage(+0.1);
+    reference.setKnobPosition(0.5);
+
+    ControlRateSlothCircuit<circuit_t> circuit;
+    circuit.setAutomaticRatio(0.001);
+    circuit.setControlVoltage(+0.1);
+    circuit.setKnobPosition(0.5);
+
+    const int SAMPLE_RATE = 44100;
+    const int SIMULATION_SECONDS = 60;
+    const int SIMULATION_SAMPLES = SIMULATION_SECONDS * SAMPLE_RATE;
+
+    int steps = 0;
+    double maxDiff = 0.0;
+    for (int sample = 0; sample < SIMULATION_SAMPLES; ++sample)
+    {
+        reference.update(SAMPLE_RATE);
+        if (circuit.update(SAMPLE_RATE) > 0)
+            ++steps;
+
+        if (!CheckVoltage(circuit.xVoltage(), "x", sample)) return false;
+        if (!CheckVoltage(circuit.yVoltage(), "y", sample)) return false;
+        if (!CheckVoltage(circuit.zVoltage(), "z", sample)) return false;
+
+        maxDiff = std::max(maxDiff, std::abs(circuit.xVoltage() - reference.xVoltage()));
+        maxDiff = std::max(maxDiff, std::abs(circuit.yVoltage() - reference.yVoltage()));
+    }
+
+    const int ratio = circuit.getRatio();
+    const double bound = ControlRateSlothCircuit<circuit_t>::estimatedError(reference.timeDilationFactor(), SAMPLE_RATE, ratio);
+    printf("ControlRate(%s): ratio = %d, steps = %d, max diff = %lg V, estimated error = %lg V\n", name, ratio, steps, maxDiff, bound);
+
+    if (ratio < 2 || steps != (SIMULATION_SAMPLES + ratio - 1) / ratio)
+    {
+        printf("ControlRate(%s): UNEXPECTED ratio or step count.\n", name);
+        return false;
+    }
+
+    if (maxDiff > 1.5 * bound)
+    {
+        printf("ControlRate(%s): EXCESSIVE difference from full-rate circuit.\n", name);
+        return false;
+    }
+
+    printf("ControlRate(%s): PASS\n", name);
+    return true;
+}
+
+
+template <typename circuit_t>
+bool AdaptiveIntegration(const char *name)
+{
+    // Verify that the adaptive-step integrator agrees with a fixed-step
+    // circuit that is oversampled enough to serve as a reference,
+    // and that it resolves the comparator transitions as events.
+
+    using namespace Analog;
+
+    printf("AdaptiveIntegration(%s): starting\n", name);
+
+    circuit_t reference;
+    reference.setControlVoltage(+0.1);
+    reference.setKnobPosition(0.5);
+
+    AdaptiveSlothCircuit<circuit_t> circuit;
+    circuit.setControlVoltage(+0.1);
+    circuit.setKnobPosition(0.5);
+
+    const int SAMPLE_RATE = 44100;
+    const int OVERSAMPLE = 16;
+    const int SIMULATION_SECONDS = 60;
+    const int SIMULATION_SAMPLES = SIMULATION_SECONDS * SAMPLE_RATE;
+
+    double maxDiff = 0.0;
+    for (int sample = 0; sample < SIMULATION_SAMPLES; ++sample)
+    {
+        for (int k = 0; k < OVERSAMPLE; ++k)
+            reference.update(OVERSAMPLE * SAMPLE_RATE);
+        circuit.update(SAMPLE_RATE);
+
+        if (!CheckVoltage(circuit.xVoltage(), "x", sample)) return false;
+        if (!CheckVoltage(circuit.yVoltage(), "y", sample)) return false;
+        if (!CheckVoltage(circuit.zVoltage(), "z", sample)) return false;
+
+        maxDiff = std::max(maxDiff, std::abs(circuit.xVoltage() - reference.xVoltage()));
+        maxDiff = std::max(maxDiff, std::abs(circuit.yVoltage() - reference.yVoltage()));
+    }
+
+    const AdaptiveStats& stats = circuit.getStats();
+    printf("AdaptiveIntegration(%s): accepted = %ld, rejected = %ld, crossings = %ld, max diff = %lg V\n",
+        name, stats.acceptedSteps, stats.rejectedSteps, stats.crossings, maxDiff);
+
+    if (stats.crossings == 0 || stats.acceptedSteps >= SIMULATION_SAMPLES / 100)
+    {
+        printf("AdaptiveIntegration(%s): UNEXPECTED step or crossing count.\n", name);
+        return false;
+    }
+
+    if (maxDiff > 1.0e-6)
+    {
+        printf("AdaptiveIntegration(%s): EXCESSIVE difference from reference circuit.\n", name);
+        return false;
+    }
+
+    printf("AdaptiveIntegration(%s): PASS\n", name);
+    return true;
+}
+
+
+template <typename circuit_t>
+bool SaveRestoreAdvance(const char *name)
+{
+    // Verify that restoring a saved state reproduces the same samples,
+    // and that fast-forwarding with `advance` lands close to where
+    // the same amount of per-sample updates would.
+
+    using namespace Analog;
+
+    printf("SaveRestoreAdvance(%s): starting\n", name);
+
+    const int SAMPLE_RATE = 44100;
+    const int SIMULATION_SECONDS = 10;
+    const int SIMULATION_SAMPLES = SIMULATION_SECONDS * SAMPLE_RATE;
+
+    circuit_t circuit;
+    circuit.setControlVoltage(+0.1);
+    circuit.setKnobPosition(0.5);
+    for (int sample = 0; sample < SIMULATION_SAMPLES; ++sample)
+        circuit.update(SAMPLE_RATE);
+
+    const SlothState saved = circuit.saveState();
+    std::vector<float> first(SAMPLE_RATE), second(SAMPLE_RATE);
+    circuit.process(SAMPLE_RATE, SAMPLE_RATE, first.data(), nullptr, nullptr);
+    circuit.restoreState(saved);
+    circuit.process(SAMPLE_RATE, SAMPLE_RATE, second.data(), nullptr, nullptr);
+    if (first != second)
+    {
+        printf("SaveRestoreAdvance(%s): restored state did not reproduce the same samples.\n", name);
+        return false;
+    }
+
+    circuit_t fast;
+    fast.setControlVoltage(+0.1);
+    fast.setKnobPosition(0.5);
+    double startTime = TimeInSeconds();
+    fast.advance(SIMULATION_SECONDS);
+    double elapsed = TimeInSeconds() - startTime;
+
+    double diff = std::max({
+        std::abs(fast.xVoltage() - saved.x),
+        std::abs(fast.wVoltage() - saved.w),
+        std::abs(fast.yVoltage() - saved.y),
+        std::abs(fast.zVoltage() - saved.z)
+    });
+
+    printf("SaveRestoreAdvance(%s): advance took %0.6lf seconds, max diff = %lg V\n", name, elapsed, diff);
+    if (diff > 1.0e-4)
+    {
+        printf("SaveRestoreAdvance(%s): EXCESSIVE difference after advance.\n", name);
+        return false;
+    }
+
+    printf("SaveRestoreAdvance(%s): PASS\n", name);
+    return true;
+}
+
+
+bool SnapshotTable()
+{
+    // Verify that a generated snapshot file can be attached and looked up,
+    // that its states match fast-forwarded circuits, and that damaged files are rejected.
+
+    using namespace Analog;
+
+    printf("SnapshotTable: starting\n");
+
+    SlothSnapshotGrid grid;
+    grid.knobCount = 3;
+    grid.cvCount = 2;
+    grid.timeCount = 4;
+    grid.timeMin = 5.0f;
+    grid.timeMax = 20.0f;
+
+    std::vector<float> file = GenerateSnapshotFile(grid);
+    const std::size_t size = file.size() * sizeof(float);
+
+    SlothSnapshotTable table;
+    if (!table.attach(file.data(), size) || !table.hasVariant(SlothVariant::Inertia))
+    {
+        printf("SnapshotTable: FAILED to attach generated file.\n");
+        return false;
+    }
+
+    // The grid point nearest knob=0.6, cv=+0.9, 12 seconds is (0.5, +1.0, 10 seconds).
+    ApathySlothCircuit circuit;
+    circuit.setKnobPosition(0.5);
+    circuit.setControlVoltage(+1.0);
+    circuit.advance(5.0);
+    circuit.advance(5.0);
+    SlothState s = table.nearest(SlothVariant::Apathy, 0.6, +0.9, 12.0);
+    if (s.x != static_cast<float>(circuit.xVoltage()) ||
+        s.w != static_cast<float>(circuit.wVoltage()) ||
+        s.y != static_cast<float>(circuit.yVoltage()) ||
+        s.z != static_cast<float>(circuit.zVoltage()))
+    {
+        printf("SnapshotTable: looked-up state does not match the simulated circuit.\n");
+        return false;
+    }
+
+    // A restored voice starts exactly at the snapshot state.
+    SlothBank<2> bank;
+    bank.setVoice(1, circuit);
+    bank.restoreState(1, s);
+    if (bank.xVoltage(1) != s.x || bank.zVoltage(1) != s.z)
+    {
+        printf("SnapshotTable: bank voice was not seeded from the snapshot.\n");
+        return false;
+    }
+
+    if (table.attach(file.data(), size - 4))
+    {
+        printf("SnapshotTable: FAILED to reject a truncated file.\n");
+        return false;
+    }
+
+    file[0] = 0.0f;
+    if (table.attach(file.data(), size))
+    {
+        printf("SnapshotTable: FAILED to reject a file with a bad signature.\n");
+        return false;
+    }
+
+    printf("SnapshotTable: PASS\n");
+    return true;
+}
+
+
+template <typename float_circuit_t, typename double_circuit_t>
+bool FloatPrecision(const char *name)
+{
+    // Verify that the single-precision circuit stays within the voltage bounds,
+    // closely tracks the double-precision reference until chaos takes over,
+    // and afterward keeps producing an attractor of the same size.
+
+    using namespace Analog;
+
+    printf("FloatPrecision(%s): starting\n", name);
+
+    float_circuit_t circuit;
+    circuit.setControlVoltage(+0.1);
+    circuit.setKnobPosition(0.5);
+
+    double_circuit_t reference;
+    reference.setControlVoltage(+0.1);
+    reference.setKnobPosition(0.5);
+
+    const int SAMPLE_RATE = 44100;
+    const int SIMULATION_SECONDS = 300;
+    const int SIMULATION_SAMPLES = SIMULATION_SECONDS * SAMPLE_RATE;
+    const int EARLY_SAMPLES = 10 * SAMPLE_RATE;
+
+    double earlyDiff = 0.0;
+    int divergeSample = -1;
+    double sumSquares = 0.0;
+    double refSumSquares = 0.0;
+    for (int sample = 0; sample < SIMULATION_SAMPLES; ++sample)
+    {
+        circuit.update(SAMPLE_RATE);
+        reference.update(SAMPLE_RATE);
+
+        if (!CheckVoltage(circuit.xVoltage(), "x", sample)) return false;
+        if (!CheckVoltage(circuit.yVoltage(), "y", sample)) return false;
+        if (!CheckVoltage(circuit.zVoltage(), "z", sample)) return false;
+
+        double diff = std::abs(circuit.xVoltage() - reference.xVoltage());
+        if (sample < EARLY_SAMPLES)
+            earlyDiff = std::max(earlyDiff, diff);
+        if (divergeSample < 0 && diff > 0.1)
+            divergeSample = sample;
+
+        sumSquares += circuit.xVoltage() * circuit.xVoltage();
+        refSumSquares += reference.xVoltage() * reference.xVoltage();
+    }
+
+    const double rms = std::sqrt(sumSquares / SIMULATION_SAMPLES);
+    const double refRms = std::sqrt(refSumSquares / SIMULATION_SAMPLES);
+    printf("FloatPrecision(%s): max diff in first 10 seconds = %lg V, diverged at %lg seconds, x rms = %lg V, reference = %lg V\n",
+        name, earlyDiff, (divergeSample < 0) ? SIMULATION_SECONDS : static_cast<double>(divergeSample) / SAMPLE_RATE, rms, refRms);
+
+    if (earlyDiff > 1.0e-4 || (divergeSample >= 0 && divergeSample < EARLY_SAMPLES))
+    {
+        printf("FloatPrecision(%s): EXCESSIVE early divergence from double precision.\n", name);
+        return false;
+    }
+
+    if (std::abs(rms - refRms) > 0.05 * refRms)
+    {
+        printf("FloatPrecision(%s): attractor size does not match double precision.\n", name);
+        return false;
+    }
+
+    printf("FloatPrecision(%s): PASS\n", name);
+    return true;
+}
+
+
+template <typename static_circuit_t, typename circuit_t>
+bool StaticMatchesCircuit(const char *name)
+{
+    // Verify that a circuit with compile-time parameters produces exactly
+    // the same voltages as the corresponding runtime-parameter circuit.
+
+    printf("StaticMatchesCircuit(%s): starting\n", name);
+
+    static_circuit_t fixed;
+    circuit_t circuit;
+
+    const int SAMPLE_RATE = 44100;
+    const int SIMULATION_SECONDS = 30;
+    const int SIMULATION_SAMPLES = SIMULATION_SECONDS * SAMPLE_RATE;
+    for (int sample = 0; sample < SIMULATION_SAMPLES; ++sample)
+    {
+        if (sample % SAMPLE_RATE == 0)
+        {
+            // Move the inputs around once per second.
+            double knob = (sample / SAMPLE_RATE) % 3 / 2.0;
+            double cv = 0.1 * ((sample / SAMPLE_RATE) % 5 - 2);
+            fixed.setKnobPosition(knob);
+            fixed.setControlVoltage(cv);
+            circuit.setKnobPosition(knob);
+            circuit.setControlVoltage(cv);
+        }
+
+        int fixedIter = fixed.update(SAMPLE_RATE);
+        int iter = circuit.update(SAMPLE_RATE);
+        if (fixedIter != iter ||
+            fixed.xVoltage() != circuit.xVoltage() ||
+            fixed.wVoltage() != circuit.wVoltage() ||
+            fixed.yVoltage() != circuit.yVoltage() ||
+            fixed.zVoltage() != circuit.zVoltage())
+        {
+            printf("StaticMatchesCircuit(%s): mismatch at sample %d\n", name, sample);
+            return false;
+        }
+    }
+
+    printf("StaticMatchesCircuit(%s): object size = %d bytes, runtime-parameter circuit = %d bytes\n",
+        name, static_cast<int>(sizeof(static_circuit_t)), static_cast<int>(sizeof(circuit_t)));
+
+    if (sizeof(static_circuit_t) >= sizeof(circuit_t))
+    {
+        printf("StaticMatchesCircuit(%s): the static circuit is not smaller.\n", name);
+        return false;
+    }
+
+    printf("StaticMatchesCircuit(%s): PASS\n", name);
+    return true;
+}
+
+
+struct CustomParameters : Analog::TorporParameters
+{
+    // A variant that does not exist in hardware: a smaller C2 and half the speed of Torpor.
+    static constexpr double timeDilation = 0.5;
+    static constexpr double C2 = 1.0e-6;
+};
+
+
+bool StaticCustomVariant()
+{
+    // Verify that a custom variant is stable, and that its component values take effect.
+
+    using namespace Analog;
+
+    printf("StaticCustomVariant: starting\n");
+
+    StaticSlothCircuit<CustomParameters> custom;
+    StaticSlothCircuit<TorporParameters> torpor;
+
+    const int SAMPLE_RATE = 44100;
+    const int SIMULATION_SECONDS = 60;
+    const int SIMULATION_SAMPLES = SIMULATION_SECONDS * SAMPLE_RATE;
+    double maxDiff = 0.0;
+    for (int sample = 0; sample < SIMULATION_SAMPLES; ++sample)
+    {
+        custom.update(SAMPLE_RATE);
+        torpor.update(SAMPLE_RATE);
+
+        if (!CheckVoltage(custom.xVoltage(), "x", sample)) return false;
+        if (!CheckVoltage(custom.yVoltage(), "y", sample)) return false;
+        if (!CheckVoltage(custom.zVoltage(), "z", sample)) return false;
+
+        maxDiff = std::max(maxDiff, std::abs(custom.xVoltage() - torpor.xVoltage()));
+    }
+
+    printf("StaticCustomVariant: max diff from Torpor = %lg V\n", maxDiff);
+    if (maxDiff < 0.1)
+    {
+        printf("StaticCustomVariant: the custom parameters had no visible effect.\n");
+        return false;
+    }
+
+    printf("StaticCustomVariant: PASS\n");
+    return true;
+}
+
+
+bool ThreadPoolBatches()
+{
+    // Verify that every task in every batch runs exactly once,
+    // even when batches are small and follow each other quickly.
+
+    using namespace Analog;
+
+    printf("ThreadPoolBatches: starting\n");
+
+    SlothThreadPool pool(3);
+    const int NTASKS = 7;
+    const int NBATCHES = 20000;
+    std::vector<std::atomic<int>> counts(NTASKS);
+    for (std::atomic<int>& c : counts)
+        c.store(0);
+
+    auto job = [&counts](int task) { counts[task].fetch_add(1, std::memory_order_relaxed); };
+    for (int batch = 0; batch < NBATCHES; ++batch)
+    {
+        pool.run(NTASKS, job);
+        for (int task = 0; task < NTASKS; ++task)
+        {
+            if (counts[task].load() != batch + 1)
+            {
+                printf("ThreadPoolBatches: task %d ran %d times after %d batches.\n", task, counts[task].load(), batch + 1);
+                return false;
+            }
+        }
+    }
+
+    printf("ThreadPoolBatches: PASS\n");
+    return true;
+}
+
+
+bool EnsembleMatchesCircuits()
+{
+    // Verify that voices rendered by the thread pool produce exactly
+    // the same samples as the same voices rendered one at a time,
+    // for both scalar circuits in an ensemble and banks as pool tasks.
+
+    using namespace Analog;
+
+    printf("EnsembleMatchesCircuits: starting\n");
+
+    const int NVOICES = 100;
+    const int BLOCK = 256;
+    const int NBLOCKS = 200;
+    const float SAMPLE_RATE = 44100.0f;
+
+    SlothThreadPool pool(3);
+    SlothEnsemble<TorporSlothCircuit> ensemble(NVOICES, BLOCK, 8);
+    std::vector<TorporSlothCircuit> serial(NVOICES);
+    for (int v = 0; v < NVOICES; ++v)
+    {
+        ensemble.voice(v).setKnobPosition(v / (NVOICES - 1.0));
+        serial[v].setKnobPosition(v / (NVOICES - 1.0));
+    }
+
+    const int NBANKS = 4;
+    std::vector<SlothBank<8>> banks(NBANKS), serialBanks(NBANKS);
+    auto bankJob = [&banks, SAMPLE_RATE](int task) { banks[task].update(SAMPLE_RATE); };
+
+    std::vector<float> x(BLOCK), y(BLOCK), z(BLOCK);
+    double startTime = TimeInSeconds();
+    for (int block = 0; block < NBLOCKS; ++block)
+    {
+        ensemble.process(pool, SAMPLE_RATE, BLOCK);
+        for (int v = 0; v < NVOICES; ++v)
+        {
+            serial[v].process(SAMPLE_RATE, BLOCK, x.data(), y.data(), z.data());
+            for (int s = 0; s < BLOCK; ++s)
+            {
+                if (x[s] != ensemble.xOutput(v)[s] || y[s] != ensemble.yOutput(v)[s] || z[s] != ensemble.zOutput(v)[s])
+                {
+                    printf("EnsembleMatchesCircuits: voice %d mismatch in block %d, sample %d\n", v, block, s);
+                    return false;
+                }
+            }
+        }
+
+        pool.run(NBANKS, bankJob);
+        for (int b = 0; b < NBANKS; ++b)
+        {
+            serialBanks[b].update(SAMPLE_RATE);
+            for (int lane = 0; lane < 8; ++lane)
+            {
+                if (banks[b].xVoltage(lane) != serialBanks[b].xVoltage(lane))
+                {
+                    printf("EnsembleMatchesCircuits: bank %d lane %d mismatch in block %d\n", b, lane, block);
+                    return false;
+                }
+            }
+        }
+    }
+    double elapsed = TimeInSeconds() - startTime;
+
+    // A request for more than the maximum block size renders only that many samples, and says so.
+    if (ensemble.process(pool, SAMPLE_RATE, BLOCK + 100) != BLOCK || ensemble.process(pool, SAMPLE_RATE, 10) != 10)
+    {
+        printf("EnsembleMatchesCircuits: wrong number of samples rendered\n");
+        return false;
+    }
+
+    printf("EnsembleMatchesCircuits: workers = %d, elapsed = %0.3lf seconds\n", pool.workerCount(), elapsed);
+    printf("EnsembleMatchesCircuits: PASS\n");
+    return true;
+}
+
+
+bool FloatContraction()
+{
+    // The SIMD engines are bit-exact with the scalar circuits only if the compiler
+    // does not fuse multiplies and adds. Reject such a build up front,
+    // instead of failing later with a mysterious mismatch.
+
+    printf("FloatContraction: starting\n");
+    if (Analog::FloatContractionEnabled())
+    {
+        printf("FloatContraction: FAIL - the compiler fuses multiplies and adds. Build with -ffp-contract=off.\n");
+        return false;
+    }
+    printf("FloatContraction: PASS\n");
+    return true;
+}
+
+
+bool BankMatchesCircuits()
+{
+    // Verify that every lane of a SlothBank produces exactly the same
+    // voltages as a scalar SlothCircuit with the same settings.
+
+    using namespace Analog;
+
+    printf("BankMatchesCircuits: starting\n");
+
+    // Use an odd number of voices, so the bank has to pad its SIMD lanes.
+    const int NVOICES = 7;
+    TorporSlothCircuit torpor[3];
+    ApathySlothCircuit apathy[2];
+    InertiaSlothCircuit inertia[2];
+    SlothCircuit *circuit[NVOICES] =
+    {
+        &torpor[0], &apathy[0], &inertia[0], &torpor[1],
+        &apathy[1], &inertia[1], &torpor[2]
+    };
+
+    SlothBank<NVOICES> bank;
+    for (int i = 0; i < NVOICES; ++i)
+    {
+        circuit[i]->setControlVoltage(-2.0 + 0.5*i);
+        circuit[i]->setKnobPosition(i / (NVOICES - 1.0));
+        bank.setVoice(i, *circuit[i]);
+    }
+
+    const int SAMPLE_RATE = 44100;
+    const int SIMULATION_SECONDS = 30;
+    const int SIMULATION_SAMPLES = SIMULATION_SECONDS * SAMPLE_RATE;
+
+    for (int sample = 0; sample < SIMULATION_SAMPLES; ++sample)
+    {
+        // Alternate between the two forms of update, checking the per-lane iteration counts when we have them.
+        int laneIter[NVOICES];
+        bool counting = (sample % 2 == 1);
+        int bankIter = counting ? bank.update(SAMPLE_RATE, laneIter) : bank.update(SAMPLE_RATE);
+        int maxIter = 0;
+        for (int i = 0; i < NVOICES; ++i)
+        {
+            int iter = circuit[i]->update(SAMPLE_RATE);
+            maxIter = std::max(maxIter, iter);
+            if (counting && laneIter[i] != iter)
+            {
+                printf("BankMatchesCircuits: lane %d iteration count %d does not match circuit iteration count %d at sample %d\n", i, laneIter[i], iter, sample);
+                return false;
+            }
+
+            if (bank.xVoltage(i) != circuit[i]->xVoltage() ||
+                bank.wVoltage(i) != circuit[i]->wVoltage() ||
+                bank.yVoltage(i) != circuit[i]->yVoltage() ||
+                bank.zVoltage(i) != circuit[i]->zVoltage())
+            {
+                printf("BankMatchesCircuits: MISMATCH in lane %d at sample %d\n", i, sample);
+                return false;
+            }
+        }
+
+        if (bankIter != maxIter)
+        {
+            printf("BankMatchesCircuits: bank iteration count %d does not match max circuit iteration count %d at sample %d\n", bankIter, maxIter, sample);
+            return false;
+        }
+    }
+
+    printf("BankMatchesCircuits: PASS\n");
+    return true;
+}
+
+
+template <typename circuit_t>
+bool SweepPointMatches(const Analog::SlothSweepSpec& spec, const Analog::SlothSweepPoint& p)
+{
+    // Compute the statistics for one sweep point with scalar circuits,
+    // and verify the sweep found exactly the same values.
+
+    circuit_t circuit;
+    circuit.setKnobPosition(p.knob);
+    circuit.setControlVoltage(p.cv);
+
+    circuit_t twin;
+    twin.setKnobPosition(p.knob);
+    twin.setControlVoltage(spec.twinControlVoltage(p.cv));
+
+    double xMin = +1.0e+9, xMax = -1.0e+9;
+    double yMin = +1.0e+9, yMax = -1.0e+9;
+    double zMin = +1.0e+9, zMax = -1.0e+9;
+    double zPrev = circuit.zVoltage();
+    long iterSum = 0;
+    long crossings = 0;
+    long divergeSample = -1;
+    const long nSamples = static_cast<long>(spec.seconds * spec.sampleRateHz);
+    for (long sample = 0; sample < nSamples; ++sample)
+    {
+        iterSum += circuit.update(spec.sampleRateHz);
+        twin.update(spec.sampleRateHz);
+        xMin = std::min(xMin, circuit.xVoltage());
+        xMax = std::max(xMax, circuit.xVoltage());
+        yMin = std::min(yMin, circuit.yVoltage());
+        yMax = std::max(yMax, circuit.yVoltage());
+        zMin = std::min(zMin, circuit.zVoltage());
+        zMax = std::max(zMax, circuit.zVoltage());
+        if ((circuit.zVoltage() < 0.0) != (zPrev < 0.0))
+            ++crossings;
+        zPrev = circuit.zVoltage();
+        if (divergeSample < 0 && std::hypot(twin.xVoltage() - circuit.xVoltage(), twin.yVoltage() - circuit.yVoltage()) > spec.divergenceThreshold)
+            divergeSample = sample;
+    }
+
+    const float divergenceSeconds = (divergeSample < 0) ? -1.0f : static_cast<float>(divergeSample / spec.sampleRateHz);
+    const float meanIterations = static_cast<float>(static_cast<double>(iterSum) / nSamples);
+    const float crossingsPerSecond = static_cast<float>(crossings / spec.seconds);
+
+    if (p.divergenceSeconds != divergenceSeconds || p.meanIterations != meanIterations || p.crossingsPerSecond != crossingsPerSecond ||
+        p.xMin != static_cast<float>(xMin) || p.xMax != static_cast<float>(xMax) ||
+        p.yMin != static_cast<float>(yMin) || p.yMax != static_cast<float>(yMax) ||
+        p.zMin != static_cast<float>(zMin) || p.zMax != static_cast<float>(zMax))
+    {
+        printf("SweepMatchesCircuits: mismatch for %s knob=%0.3f cv=%0.3f\n", Analog::SlothVariantName(static_cast<Analog::SlothVariant>(p.variant)), p.knob, p.cv);
+        return false;
+    }
+    return true;
+}
+
+
+bool SweepMatchesCircuits()
+{
+    // Verify that a parallel sweep, running its points in bank lanes
+    // across a thread pool, matches statistics computed one circuit at a time.
+
+    using namespace Analog;
+
+    printf("SweepMatchesCircuits: starting\n");
+
+    SlothSweepSpec spec;
+    spec.variants = {SlothVariant::Torpor, SlothVariant::Inertia};
+    spec.knobCount = 2;
+    spec.cvCount = 3;
+    spec.cvMin = -1.0;
+    spec.cvMax = +1.0;
+    spec.seconds = 3.0;
+
+    SlothThreadPool pool(2);
+    std::vector<SlothSweepPoint> results = RunSweep(pool, spec);
+    if (results.size() != 12)
+    {
+        printf("SweepMatchesCircuits: expected 12 points but found %d\n", static_cast<int>(results.size()));
+        return false;
+    }
+
+    int diverged = 0;
+    for (const SlothSweepPoint& p : results)
+    {
+        bool ok = (static_cast<SlothVariant>(p.variant) == SlothVariant::Torpor)
+            ? SweepPointMatches<TorporSlothCircuit>(spec, p)
+            : SweepPointMatches<InertiaSlothCircuit>(spec, p);
+        if (!ok)
+            return false;
+        if (p.divergenceSeconds >= 0.0f)
+            ++diverged;
+    }
+
+    printf("SweepMatchesCircuits: %d of %d points diverged\n", diverged, static_cast<int>(results.size()));
+
+    // At the positive rail, the twin must be perturbed inward, or it would be clamped onto the same trajectory.
+    if (spec.twinControlVoltage(+12.0) != +12.0 - spec.cvPerturbation || spec.twinControlVoltage(+20.0) != +12.0 - spec.cvPerturbation || spec.twinControlVoltage(-12.0) != -12.0 + spec.cvPerturbation)
+    {
+        printf("SweepMatchesCircuits: FAIL - twin control voltage at the rails\n");
+        return false;
+    }
+
+    spec.variants = {SlothVariant::Torpor};
+    spec.knobCount = 1;
+    spec.cvCount = 1;
+    spec.cvMin = spec.cvMax = +12.0;
+    results = RunSweep(pool, spec);
+    if (results.size() != 1 || results[0].cv != +12.0f || !SweepPointMatches<TorporSlothCircuit>(spec, results[0]))
+        return false;
+
+    printf("SweepMatchesCircuits: PASS\n");
+    return true;
+}
+
+
+template <typename circuit_t>
+bool LyapunovExponent(const char *name, double knob, double cv, int seconds)
+{
+    // Compare the tangent-linear estimate of the largest Lyapunov exponent
+    // with the classic shadow-trajectory estimate: a second circuit starts
+    // a tiny distance away, and is pulled back to that distance after every
+    // interval, accumulating the logarithm of how far it had separated.
+
+    using namespace Analog;
+
+    printf("LyapunovExponent(%s): starting\n", name);
+
+    const float SAMPLE_RATE = 44100.0f;
+    const int SETTLE_SAMPLES = 10 * 44100;
+    const int SAMPLES = seconds * 44100;
+    const int INTERVAL = 441;
+    const double separation = 1.0e-8;
+    const double zy = -SlothComponents::R4 / SlothComponents::R5;
+
+    LyapunovSlothCircuit<circuit_t> tangent;
+    tangent.setKnobPosition(knob);
+    tangent.setControlVoltage(cv);
+    circuit_t circuit;
+    circuit.setKnobPosition(knob);
+    circuit.setControlVoltage(cv);
+    circuit_t shadow = circuit;
+
+    // Let the trajectory settle onto its attractor before measuring.
+    for (int sample = 0; sample < SETTLE_SAMPLES; ++sample)
+    {
+        tangent.update(SAMPLE_RATE);
+        circuit.update(SAMPLE_RATE);
+    }
+    tangent.resetExponent();
+
+    double logGrowth = 0.0;
+    double startTime = TimeInSeconds();
+    for (int sample = 0; sample < SAMPLES; ++sample)
+    {
+        if (sample % INTERVAL == 0)
+        {
+            SlothState s = circuit.saveState();
+            SlothState t = shadow.saveState();
+            double dx = t.x - s.x, dw = t.w - s.w, dy = t.y - s.y;
+            double dist = std::sqrt(dx*dx + dw*dw + dy*dy);
+            if (sample == 0)
+            {
+                dx = dw = dy = 1.0;
+                dist = std::sqrt(3.0);
+            }
+            else
+            {
+                logGrowth += std::log(dist / separation);
+            }
+            double f = separation / dist;
+            shadow.restoreState(SlothState{s.x + f*dx, s.w + f*dw, s.y + f*dy, s.z + zy*f*dy});
+        }
+        tangent.update(SAMPLE_RATE);
+        circuit.update(SAMPLE_RATE);
+        shadow.update(SAMPLE_RATE);
+    }
+    double elapsed = TimeInSeconds() - startTime;
+
+    if (tangent.xVoltage() != circuit.xVoltage() || tangent.yVoltage() != circuit.yVoltage())
+    {
+        printf("LyapunovExponent(%s): tangent circuit does not follow the plain circuit.\n", name);
+        return false;
+    }
+
+    SlothState s = circuit.saveState();
+    SlothState t = shadow.saveState();
+    logGrowth += std::log(std::sqrt((t.x-s.x)*(t.x-s.x) + (t.w-s.w)*(t.w-s.w) + (t.y-s.y)*(t.y-s.y)) / separation);
+    double shadowExponent = logGrowth / tangent.measuredSeconds();
+    double tangentExponent = tangent.exponent();
+
+    printf("LyapunovExponent(%s): tangent = %0.6lf/s, shadow = %0.6lf/s, elapsed = %0.3lf seconds\n", name, tangentExponent, shadowExponent, elapsed);
+
+    if (!(tangentExponent > 0.0))
+    {
+        printf("LyapunovExponent(%s): FAIL - expected a chaotic trajectory.\n", name);
+        return false;
+    }
+
+    if (std::abs(tangentExponent - shadowExponent) > 0.01 * shadowExponent)
+    {
+        printf("LyapunovExponent(%s): FAIL - estimates do not agree.\n", name);
+        return false;
+    }
+
+    printf("LyapunovExponent(%s): PASS\n", name);
+    return true;
+}
+
+
+bool LogFileMatches(const char *filename)
+{
+    // Verify that SlothLog reads exactly the same values as
+    // the original fgets/sscanf loop in viewlog.cpp.
+
+    using namespace Analog;
+
+    double startTime = TimeInSeconds();
+    SlothLog log;
+    if (!log.load(filename))
+    {
+        printf("LogReader: cannot load %s (error line %d)\n", filename, log.errorLineNumber());
+        return false;
+    }
+    double elapsed = TimeInSeconds() - startTime;
+
+    FILE *infile = fopen(filename, "rt");
+    if (infile == nullptr)
+    {
+        printf("LogReader: cannot open %s\n", filename);
+        return false;
+    }
+
+    int row = 0;
+    char line[100];
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), infile))
+    {
+        int millis, ax, ay, az, aw;
+        int n = sscanf(line, "%d,%d,%d,%d,%d", &millis, &ax, &ay, &az, &aw);
+        ok = (n >= 4) && (row < log.rowCount()) && (log.hasW() == (n == 5)) &&
+            (log.millis()[row] == millis) && (log.x()[row] == ax) && (log.y()[row] == ay) && (log.z()[row] == az) &&
+            (n < 5 || log.w()[row] == aw);
+        ++row;
+    }
+    fclose(infile);
+
+    if (!ok || row != log.rowCount())
+    {
+        printf("LogReader: mismatch in %s at row %d\n", filename, row);
+        return false;
+    }
+
+    // Both binary encodings must reproduce the same samples and voltages.
+    for (SlothLogEncoding encoding : {SlothLogEncoding::Packed16, SlothLogEncoding::Delta8})
+    {
+        std::vector<unsigned char> file = log.encode(encoding);
+        SlothLog binary;
+        if (!binary.decode(file.data(), file.size()) || binary.rowCount() != log.rowCount() || binary.hasW() != log.hasW())
+        {
+            printf("LogReader: cannot decode binary version of %s\n", filename);
+            return false;
+        }
+        for (int r = 0; r < log.rowCount(); ++r)
+        {
+            if (binary.millis()[r] != log.millis()[r] || binary.xVoltage(r) != log.xVoltage(r) ||
+                binary.yVoltage(r) != log.yVoltage(r) || binary.zVoltage(r) != log.zVoltage(r) ||
+                binary.wVoltage(r) != log.wVoltage(r))
+            {
+                printf("LogReader: binary mismatch in %s at row %d\n", filename, r);
+                return false;
+            }
+        }
+        printf("LogReader: %s encoding of %s takes %d bytes\n", (encoding == SlothLogEncoding::Delta8) ? "delta" : "packed", filename, static_cast<int>(file.size()));
+    }
+
+    printf("LogReader: loaded %d rows from %s in %0.3lf ms\n", log.rowCount(), filename, 1000.0 * elapsed);
+    return true;
+}
+
+
+bool LogReader()
+{
+    using namespace Analog;
+
+    printf("LogReader: starting\n");
+
+    SlothLog log;
+    const char *text = "200,456,360,661\r\n400,457,373,649\r\n\r\n600,461,388,634";
+    if (!log.parse(text, strlen(text)) || log.rowCount() != 3 || log.hasW() || log.z()[2] != 634)
+    {
+        printf("LogReader: failed to parse 4-column text\n");
+        return false;
+    }
+
+    text = "200,533,685,343,385\n400,543,692,336,430\n";
+    if (!log.parse(text, strlen(text)) || log.rowCount() != 2 || !log.hasW() || log.w()[1] != 430)
+    {
+        printf("LogReader: failed to parse 5-column text\n");
+        return false;
+    }
+
+    text = "200,533,685,343,385\n400,543,692\n";
+    if (log.parse(text, strlen(text)) || log.errorLineNumber() != 2)
+    {
+        printf("LogReader: failed to reject a truncated row\n");
+        return false;
+    }
+
+    // A difference too large for 8 bits, and an irregular sample interval.
+    // Reject a reading outside the 10-bit ADC range, and a number too long for 32 bits.
+    const char *malformed[] =
+    {
+        "200,533,685,343\n400,1024,692,336\n",
+        "200,533,685,-1\n",
+        "200,533,685,343,70000\n",
+        "99999999999999999999,533,685,343\n",
+        "200,533,685,3430000000000\n",
+    };
+    for (const char *bad : malformed)
+    {
+        if (log.parse(bad, strlen(bad)) || log.errorLineNumber() == 0)
+        {
+            printf("LogReader: failed to reject malformed text: %s", bad);
+            return false;
+        }
+    }
+    text = "-2147483648,0,1023,0\n2147483647,1023,0,1023\n";
+    if (!log.parse(text, strlen(text)) || log.millis()[0] != INT32_MIN || log.millis()[1] != INT32_MAX || log.x()[1] != 1023)
+    {
+        printf("LogReader: failed to parse values at the limits\n");
+        return false;
+    }
+    // These two timestamps are further apart than an int32 can hold, so the log is irregular.
+    if (log.intervalMillis() != 0 || log.encode(SlothLogEncoding::Packed16).empty())
+    {
+        printf("LogReader: wrong interval for timestamps at the limits\n");
+        return false;
+    }
+
+    text = "200,18,500,500\n400,1019,500,500\n700,1019,500,500\n";
+    std::vector<unsigned char> file;
+    if (!log.parse(text, strlen(text)) || log.canDelta8() || log.intervalMillis() != 0)
+    {
+        printf("LogReader: wrong encoding choice for irregular text\n");
+        return false;
+    }
+    file = log.encode(SlothLogEncoding::Delta8);
+    SlothLog binary;
+    if (!binary.decode(file.data(), file.size()) || binary.rowCount() != 3 || binary.millis()[2] != 700 || binary.x()[1] != 1019 || std::abs(binary.xVoltage(1) - 12.0) > 1.0e-12)
+    {
+        printf("LogReader: failed to decode irregular log\n");
+        return false;
+    }
+
+    // Reject a binary log whose generated timestamps would overflow,
+    // or whose readings are outside the 10-bit ADC range.
+    text = "200,18,500,500\n400,1019,500,500\n600,1019,500,500\n";
+    if (!log.parse(text, strlen(text)) || log.intervalMillis() != 200)
+    {
+        printf("LogReader: failed to parse regular text\n");
+        return false;
+    }
+    file = log.encode(SlothLogEncoding::Packed16);
+    std::vector<unsigned char> corrupt = file;
+    const std::int32_t lateMillis = INT32_MAX - 300;
+    std::memcpy(corrupt.data() + offsetof(SlothLogHeader, firstMillis), &lateMillis, sizeof(lateMillis));
+    if (binary.decode(corrupt.data(), corrupt.size()))
+    {
+        printf("LogReader: failed to reject overflowing timestamps\n");
+        return false;
+    }
+    corrupt = file;
+    const std::int16_t reading = 1024;
+    std::memcpy(corrupt.data() + sizeof(SlothLogHeader) + 2, &reading, sizeof(reading));
+    if (binary.decode(corrupt.data(), corrupt.size()) || !binary.decode(file.data(), file.size()) || binary.millis()[2] != 600)
+    {
+        printf("LogReader: failed to reject a binary reading outside the ADC range\n");
+        return false;
+    }
+
+    if (!LogFileMatches("../hardware/data/cv0_r0.csv")) return false;
+    if (!LogFileMatches("../hardware/data/old/cvp5_r0.csv")) return false;
+
+    printf("LogReader: PASS\n");
+    return true;
+}
+
+
+struct SchematicParameters : Analog::TorporParameters
+{
+    // Torpor with the C2 value shown on the schematic.
+    static constexpr double C2 = 1.0e-6;
+};
+
+
+bool FitComponents()
+{
+    // Verify that bank lanes with run-time component values match the
+    // equivalent compile-time variant, then verify that the fitter can
+    // recover a known C2 from the signature of a simulated "measurement".
+
+    using namespace Analog;
+
+    printf("FitComponents: starting\n");
+
+    SlothComponentValues schematic;
+    schematic.C2 = SchematicParameters::C2;
+
+    SlothBank<8> bank;
+    bank.setComponents(3, schematic);
+    StaticSlothCircuit<SchematicParameters> reference;
+    TorporSlothCircuit standard;
+    const float SAMPLE_RATE = 44100.0f;
+    for (int sample = 0; sample < 10 * 44100; ++sample)
+    {
+        bank.update(SAMPLE_RATE);
+        reference.update(SAMPLE_RATE);
+        standard.update(SAMPLE_RATE);
+        if (bank.xVoltage(3) != reference.xVoltage() || bank.zVoltage(3) != reference.zVoltage() || bank.xVoltage(2) != standard.xVoltage())
+        {
+            printf("FitComponents: bank lane mismatch at sample %d\n", sample);
+            return false;
+        }
+    }
+
+    // Make the measurement from a later stretch of the trajectory than
+    // the fitter will simulate, so that no candidate can reproduce it exactly.
+    SlothFitSpec spec;
+    spec.sampleRateHz = 2000.0f;
+    spec.population = 8;
+    spec.elite = 3;
+    spec.generations = 8;
+
+    SlothFitTarget target;
+    target.seconds = 600.0;
+    SlothBank<1> measure;
+    measure.setComponents(0, schematic);
+    for (int s = 0; s < 2 * spec.skipSeconds * spec.sampleRateHz; ++s)
+        measure.update(spec.sampleRateHz);
+    SlothSignatureBuilder builder(target.intervalSeconds);
+    const int stride = static_cast<int>(target.intervalSeconds * spec.sampleRateHz);
+    for (int r = 0; r < target.seconds / target.intervalSeconds; ++r)
+    {
+        for (int s = 0; s < stride; ++s)
+            measure.update(spec.sampleRateHz);
+        builder.add(measure.xVoltage(0), measure.yVoltage(0), measure.zVoltage(0));
+    }
+    target.signature = builder.signature();
+
+    SlothThreadPool pool(1);
+    std::vector<SlothFitTarget> targets {target};
+    SlothFitter fitter(pool, targets, spec);
+    double initialDistance = fitter.evaluate({spec.initial})[0];
+    double startTime = TimeInSeconds();
+    SlothFitResult result = fitter.fit();
+    double elapsed = TimeInSeconds() - startTime;
+
+    double error = result.best.C2 / schematic.C2 - 1.0;
+    printf("FitComponents: C2 = %lg after %d generations, error = %0.2lf%%, distance %0.4lf -> %0.4lf, elapsed = %0.3lf seconds\n",
+        result.best.C2, result.generations, 100.0 * error, initialDistance, result.distance, elapsed);
+
+    if (std::abs(error) > 0.1)
+    {
+        printf("FitComponents: FAIL - C2 was not recovered.\n");
+        return false;
+    }
+
+    printf("FitComponents: PASS\n");
+    return true;
+}
+
+
+bool RingTransfer()
+{
+    // Verify that a producer thread and a consumer thread can pass a long sequence
+    // through a small ring buffer, in blocks of varying sizes, without losing,
+    // repeating, or reordering any items, while the ring keeps filling and emptying.
+
+    using namespace Analog;
+
+    printf("RingTransfer: starting\n");
+
+    const std::uint32_t NITEMS = 2000000;
+    SlothRing<std::uint32_t> ring(60);
+    if (ring.capacity() != 64)
+    {
+        printf("RingTransfer: FAIL - capacity is %d, expected 64.\n", static_cast<int>(ring.capacity()));
+        return false;
+    }
+
+    std::thread producer([&ring, NITEMS]()
+    {
+        std::uint32_t block[37];
+        std::uint32_t next = 0;
+        std::size_t size = 1;
+        while (next < NITEMS)
+        {
+            std::size_t n = std::min<std::size_t>(size, NITEMS - next);
+            for (std::size_t i = 0; i < n; ++i)
+                block[i] = next + static_cast<std::uint32_t>(i);
+            std::size_t written = ring.write(block, n);
+            if (written == 0)
+                std::this_thread::yield();
+            next += static_cast<std::uint32_t>(written);
+            size = 1 + (size * 7) % 37;
+        }
+    });
+
+    // Keep reading after a failure, so the producer can finish.
+    std::uint32_t block[23];
+    std::uint32_t expected = 0;
+    std::size_t size = 1;
+    bool ok = true;
+    while (expected < NITEMS)
+    {
+        std::size_t n = ring.read(block, size);
+        if (n == 0)
+            std::this_thread::yield();
+        for (std::size_t i = 0; i < n; ++i, ++expected)
+        {
+            if (ok && block[i] != expected)
+            {
+                printf("RingTransfer: FAIL - read %u, expected %u.\n", block[i], expected);
+                ok = false;
+            }
+        }
+        size = 1 + (size * 5) % 23;
+    }
+
+    producer.join();
+
+    if (ok && ring.available() != 0)
+    {
+        printf("RingTransfer: FAIL - %d items left over.\n", static_cast<int>(ring.available()));
+        return false;
+    }
+
+    if (ok)
+        printf("RingTransfer: PASS\n");
+    return ok;
+}
+
+
+bool AudioVoice()
+{
+    // Verify that an audio voice renders exactly the circuit's own samples
+    // when its parameters are steady, no matter how the callback blocks are sized,
+    // and that a jump in a parameter is followed smoothly and completely.
+
+    using namespace Analog;
+
+    printf("AudioVoice: starting\n");
+
+    const float SAMPLE_RATE = 44100.0f;
+    const int MAX_FRAMES = 700;
+    SlothAudioVoice<ApathySlothCircuit> voice;
+    voice.knob.set(0.3f);
+    voice.controlVoltage.set(-0.5f);
+    voice.snapParameters();
+
+    ApathySlothCircuit reference;
+    reference.setKnobPosition(0.3f);
+    reference.setControlVoltage(-0.5f);
+
+    std::vector<float> stereo(2 * MAX_FRAMES);
+    std::vector<float> x(MAX_FRAMES), y(MAX_FRAMES);
+    const float gain = voice.volume.get();
+    int frames = 1;
+    for (int block = 0; block < 200; ++block)
+    {
+        voice.render(SAMPLE_RATE, stereo.data(), frames);
+        reference.process(SAMPLE_RATE, frames, x.data(), y.data(), nullptr);
+        for (int i = 0; i < frames; ++i)
+        {
+            if (stereo[2*i] != gain * x[i] || stereo[2*i + 1] != gain * y[i])
+            {
+                printf("AudioVoice: FAIL - mismatch in block %d, frame %d\n", block, i);
+                return false;
+            }
+        }
+        frames = 1 + (frames * 37 + 11) % MAX_FRAMES;
+    }
+
+    // Jump the knob, and follow it for one smoothing time constant (20 ms), then for ten.
+    voice.knob.set(1.0f);
+    const int tau = static_cast<int>(0.02f * SAMPLE_RATE);
+    float previous = voice.knob.value();
+    for (int s = 0; s < 10*tau; s += 64)
+    {
+        voice.render(SAMPLE_RATE, stereo.data(), 64);
+        const float knob = voice.knob.value();
+        if (knob < previous || knob > 1.0f)
+        {
+            printf("AudioVoice: FAIL - knob moved from %g to %g while approaching 1.\n", previous, knob);
+            return false;
+        }
+        for (int i = 0; i < 2*64; ++i)
+            if (!CheckVoltage(stereo[i], "stereo", s + i/2))
+                return false;
+        if (s + 64 > tau && s <= tau)
+        {
+            // After about one time constant, the knob should be about 63% of the way there.
+            const float fraction = (knob - 0.3f) / 0.7f;
+            if (fraction < 0.55f || fraction > 0.72f)
+            {
+                printf("AudioVoice: FAIL - knob is %g after one time constant.\n", knob);
+                return false;
+            }
+        }
+        previous = knob;
+    }
+
+    for (int block = 0; block < 100 && voice.knob.value() != 1.0f; ++block)
+        voice.render(SAMPLE_RATE, stereo.data(), MAX_FRAMES);
+    if (voice.knob.value() != 1.0f)
+    {
+        printf("AudioVoice: FAIL - knob settled at %g instead of 1.\n", voice.knob.value());
+        return false;
+    }
+
+    printf("AudioVoice: PASS\n");
+    return true;
+}
+
+
+bool SolverStatistics(Analog::SlothIntegrator integrator)
+{
+    // Verify that collecting solver statistics does not change the simulation,
+    // and that the statistics agree with what can be observed from outside the solver.
+
+    using namespace Analog;
+
+    const char *name = (integrator == SlothIntegrator::Exact) ? "Exact" : "Midpoint";
+    printf("SolverStatistics(%s): starting\n", name);
+
+    TorporSlothCircuitT<double, SlothSolverStats> circuit;
+    TorporSlothCircuit reference;
+    circuit.setIntegrator(integrator);
+    reference.setIntegrator(integrator);
+    circuit.setKnobPosition(0.5);
+    reference.setKnobPosition(0.5);
+
+    const float SAMPLE_RATE = 44100.0f;
+    const int NSAMPLES = 44100 * 60;
+    long long iterationTotal = 0;
+    long long limitSteps = 0;
+    long long toggles = 0;
+    for (int s = 0; s < NSAMPLES; ++s)
+    {
+        const bool q1 = (circuit.zVoltage() < 0.0);
+        const int iter = circuit.update(SAMPLE_RATE);
+        if (iter != reference.update(SAMPLE_RATE) || circuit.xVoltage() != reference.xVoltage() || circuit.yVoltage() != reference.yVoltage())
+        {
+            printf("SolverStatistics(%s): FAIL - collecting statistics changed sample %d.\n", name, s);
+            return false;
+        }
+        iterationTotal += iter;
+        if (iter >= circuit.iterationLimit)
+            ++limitSteps;
+        if (q1 != (circuit.zVoltage() < 0.0))
+            ++toggles;
+    }
+
+    const SlothSolverStats& stats = circuit.stats();
+    long long histogramTotal = 0;
+    for (int n = 0; n <= SlothSolverStats::maxHistogramIterations; ++n)
+        histogramTotal += stats.iterations[n];
+
+    printf("SolverStatistics(%s): mean iterations = %0.4lf, exact = %lld, limit hits = %lld, crossings = %lld, toggles = %lld, mean residual = %0.3lg V, max residual = %0.3lg V\n",
+        name, stats.meanIterations(), stats.exactSteps, stats.limitHits, stats.crossings, stats.toggles, stats.meanResidual(), stats.residualMax);
+
+    if (stats.steps != NSAMPLES || histogramTotal != NSAMPLES)
+    {
+        printf("SolverStatistics(%s): FAIL - counted %lld steps and %lld histogram entries, expected %d.\n", name, stats.steps, histogramTotal, NSAMPLES);
+        return false;
+    }
+
+    if (std::abs(stats.meanIterations() - static_cast<double>(iterationTotal) / NSAMPLES) > 1.0e-12)
+    {
+        printf("SolverStatistics(%s): FAIL - mean iterations does not match the returned iteration counts.\n", name);
+        return false;
+    }
+
+    if (stats.toggles != toggles || toggles == 0)
+    {
+        printf("SolverStatistics(%s): FAIL - counted %lld toggles, but observed %lld.\n", name, stats.toggles, toggles);
+        return false;
+    }
+
+    if (stats.limitHits > limitSteps || stats.iterations[0] != 0)
+    {
+        printf("SolverStatistics(%s): FAIL - inconsistent limit hits %lld (at most %lld expected).\n", name, stats.limitHits, limitSteps);
+        return false;
+    }
+
+    if ((integrator == SlothIntegrator::Exact) != (stats.exactSteps > 0))
+    {
+        printf("SolverStatistics(%s): FAIL - exact step count %lld is inconsistent with the integrator.\n", name, stats.exactSteps);
+        return false;
+    }
+
+    circuit.resetStats();
+    if (circuit.stats().steps != 0)
+    {
+        printf("SolverStatistics(%s): FAIL - resetStats did not clear the statistics.\n", name);
+        return false;
+    }
+
+    printf("SolverStatistics(%s): PASS\n", name);
+    return true;
+}
+
+
+template <typename circuit_t>
+bool PredictiveSolver(const char *name)
+{
+    // Verify that the predictive solver takes one iteration fewer than the
+    // normal one for typical samples, while every step it takes stays within
+    // the solver tolerance of the normal solver's step from the same state.
+
+    using namespace Analog;
+
+    printf("PredictiveSolver(%s): starting\n", name);
+
+    circuit_t normal;
+    circuit_t predictive;
+    predictive.setIntegrator(SlothIntegrator::Predictive);
+    normal.setKnobPosition(0.3);
+    predictive.setKnobPosition(0.3);
+
+    const float SAMPLE_RATE = 44100.0f;
+    const int NSAMPLES = 44100 * 100;
+    long long normalIterations = 0;
+    long long predictiveIterations = 0;
+    double maxDiff = 0.0;
+    for (int s = 0; s < NSAMPLES; ++s)
+    {
+        predictive.restoreState(normal.saveState());
+        normalIterations += normal.update(SAMPLE_RATE);
+        predictiveIterations += predictive.update(SAMPLE_RATE);
+        double diff = std::max({
+            std::abs(predictive.xVoltage() - normal.xVoltage()),
+            std::abs(predictive.wVoltage() - normal.wVoltage()),
+            std::abs(predictive.yVoltage() - normal.yVoltage())
+        });
+        maxDiff = std::max(maxDiff, diff);
+    }
+
+    const double normalMean = static_cast<double>(normalIterations) / NSAMPLES;
+    const double predictiveMean = static_cast<double>(predictiveIterations) / NSAMPLES;
+    printf("PredictiveSolver(%s): mean iterations %0.4lf -> %0.4lf, max step difference = %lg V\n", name, normalMean, predictiveMean, maxDiff);
+
+    // Step the CV from a resting state, where x, w, and y are not changing.
+    // The stored z is left over from the old CV, so the first iteration's
+    // deltas are zero even though the circuit is about to move.
+    const double zRest = -QPOS * (SlothComponents::R1 / SlothComponents::R2);
+    const SlothState rest{0.0, 0.0, zRest * (-SlothComponents::R5 / SlothComponents::R4), zRest};
+    for (double cv : {+1.0, -0.01})
+    {
+        normal.setControlVoltage(0.0);
+        predictive.setControlVoltage(0.0);
+        normal.restoreState(rest);
+        predictive.restoreState(rest);
+        normal.update(SAMPLE_RATE);
+        predictive.update(SAMPLE_RATE);
+        const double restDiff = std::abs(predictive.xVoltage() - normal.xVoltage());
+        if (restDiff > 2 * SlothSolverT<double>::tolerance || std::abs(normal.xVoltage()) > 1.0e-12)
+        {
+            printf("PredictiveSolver(%s): FAIL - the resting state moved by %lg V, difference %lg V.\n", name, normal.xVoltage(), restDiff);
+            return false;
+        }
+
+        normal.setControlVoltage(cv);
+        predictive.setControlVoltage(cv);
+        normal.update(SAMPLE_RATE);
+        predictive.update(SAMPLE_RATE);
+        const double stepDiff = std::max({
+            std::abs(predictive.xVoltage() - normal.xVoltage()),
+            std::abs(predictive.wVoltage() - normal.wVoltage()),
+            std::abs(predictive.yVoltage() - normal.yVoltage())
+        });
+        if (stepDiff > 2 * SlothSolverT<double>::tolerance)
+        {
+            printf("PredictiveSolver(%s): FAIL - a CV step from rest differs by %lg V.\n", name, stepDiff);
+            return false;
+        }
+    }
+
+    if (maxDiff > 2 * SlothSolverT<double>::tolerance)
+    {
+        printf("PredictiveSolver(%s): FAIL - a predictive step was not within tolerance.\n", name);
+        return false;
+    }
+
+    if (predictiveMean > normalMean - 0.9)
+    {
+        printf("PredictiveSolver(%s): FAIL - the predictive solver did not save an iteration per sample.\n", name);
+        return false;
+    }
+
+    printf("PredictiveSolver(%s): PASS\n", name);
+    return true;
+}
+
+
+bool PolyModuleMatchesCircuits()
+{
+    // Verify that every channel of a polyphonic module produces exactly
+    // the same voltages as its own scalar circuit, while each channel's CV
+    // changes on every sample and the channel count changes.
+
+    using namespace Analog;
+
+    printf("PolyModuleMatchesCircuits: starting\n");
+
+    const int N = SlothPolyModule::MaxChannels;
+    const float SAMPLE_RATE = 48000.0f;
+    SlothPolyModule module;
+    module.setVariant(SlothVariant::Apathy);
+    module.setKnobPosition(0.25);
+    module.setChannelCount(N);
+
+    std::vector<ApathySlothCircuit> circuits(N);
+    for (ApathySlothCircuit& circuit : circuits)
+        circuit.setKnobPosition(0.25);
+
+    float cv[N], x[N], y[N], z[N];
+    double startTime = TimeInSeconds();
+    const int NSAMPLES = 48000 * 10;
+    for (int s = 0; s < NSAMPLES; ++s)
+    {
+        if (s == NSAMPLES / 2)
+        {
+            // Drop to 5 channels, then restore all of them, which restarts channels 5..15.
+            module.setChannelCount(5);
+            module.setChannelCount(N);
+            for (int c = 5; c < N; ++c)
+                circuits[c].initialize();
+        }
+
+        for (int c = 0; c < N; ++c)
+        {
+            cv[c] = static_cast<float>(std::sin(0.001 * s * (c + 1)));
+            circuits[c].setControlVoltage(cv[c]);
+            circuits[c].update(SAMPLE_RATE);
+        }
+
+        module.process(SAMPLE_RATE, cv, x, y, z);
+
+        for (int c = 0; c < N; ++c)
+        {
+            if (x[c] != static_cast<float>(circuits[c].xVoltage()) ||
+                y[c] != static_cast<float>(circuits[c].yVoltage()) ||
+                z[c] != static_cast<float>(circuits[c].zVoltage()))
+            {
+                printf("PolyModuleMatchesCircuits: FAIL - channel %d mismatch at sample %d\n", c, s);
+                return false;
+            }
+        }
+    }
+    double elapsed = TimeInSeconds() - startTime;
+    printf("PolyModuleMatchesCircuits: %d channels x %d samples, elapsed = %0.3lf seconds (including the scalar circuits)\n", N, NSAMPLES, elapsed);
+
+    printf("PolyModuleMatchesCircuits: PASS\n");
+    return true;
+}
+
+
+bool NetworkMatchesCircuits()
+{
+    // Verify that every node of a SlothNetwork without incoming connections
+    // produces exactly the same voltages as a scalar SlothCircuit with the same
+    // settings, even while other nodes in the network are driven by it.
+
+    using namespace Analog;
+
+    printf("NetworkMatchesCircuits: starting\n");
+
+    // Use an odd number of nodes, so the network has to pad its SIMD lanes.
+    const int NNODES = 7;
+    TorporSlothCircuit torpor[3];
+    ApathySlothCircuit apathy[2];
+    InertiaSlothCircuit inertia[2];
+    SlothCircuit *circuit[NNODES] =
+    {
+        &torpor[0], &apathy[0], &inertia[0], &torpor[1],
+        &apathy[1], &inertia[1], &torpor[2]
+    };
+
+    SlothNetwork<NNODES> network;
+    for (int i = 0; i < NNODES; ++i)
+    {
+        circuit[i]->setControlVoltage(-2.0 + 0.5*i);
+        circuit[i]->setKnobPosition(i / (NNODES - 1.0));
+        network.setVoice(i, *circuit[i]);
+    }
+
+    // Node 6 listens to nodes 0 and 2. Nodes 0..5 are free running.
+    const int LISTENER = 6;
+    if (!network.connect(0, LISTENER, 0.3) || !network.connect(2, LISTENER, -0.2, SlothNetworkOutput::Y))
+    {
+        printf("NetworkMatchesCircuits: FAIL - could not connect nodes\n");
+        return false;
+    }
+
+    if (network.connect(0, NNODES, 1.0) || network.connectionCount() != 2)
+    {
+        printf("NetworkMatchesCircuits: FAIL - accepted a connection to a nonexistent node\n");
+        return false;
+    }
+
+    const int SAMPLE_RATE = 44100;
+    const int SIMULATION_SECONDS = 30;
+    const int SIMULATION_SAMPLES = SIMULATION_SECONDS * SAMPLE_RATE;
+
+    for (int sample = 0; sample < SIMULATION_SAMPLES; ++sample)
+    {
+        int networkIter = network.update(SAMPLE_RATE);
+        if (networkIter < 2 || networkIter > network.iterationLimit)
+        {
+            printf("NetworkMatchesCircuits: unexpected iteration count %d at sample %d\n", networkIter, sample);
+            return false;
+        }
+
+        for (int i = 0; i < LISTENER; ++i)
+        {
+            circuit[i]->update(SAMPLE_RATE);
+            if (network.xVoltage(i) != circuit[i]->xVoltage() ||
+                network.wVoltage(i) != circuit[i]->wVoltage() ||
+                network.yVoltage(i) != circuit[i]->yVoltage() ||
+                network.zVoltage(i) != circuit[i]->zVoltage())
+            {
+                printf("NetworkMatchesCircuits: MISMATCH in node %d at sample %d\n", i, sample);
+                return false;
+            }
+        }
+
+        if (!CheckVoltage(network.xVoltage(LISTENER), "x", sample)) return false;
+        if (!CheckVoltage(network.yVoltage(LISTENER), "y", sample)) return false;
+        if (!CheckVoltage(network.zVoltage(LISTENER), "z", sample)) return false;
+    }
+
+    printf("NetworkMatchesCircuits: PASS\n");
+    return true;
+}
+
+
+bool NetworkCoupling()
+{
+    // Verify that solving coupled circuits together removes the one-sample
+    // delay of patching separate circuit objects into each other.
+    // Torpor's x drives Apathy's CV, and Apathy's x feeds back into Torpor's CV.
+    // The same network run at 64 times the sample rate is the reference.
+    // Separate circuits that see each other's voltages one sample late
+    // make first-order errors; the network should be far more accurate.
+
+    using namespace Analog;
+
+    printf("NetworkCoupling: starting\n");
+
+    const double FORWARD_GAIN = 1.0;
+    const double FEEDBACK_GAIN = 1.0;
+    const int SAMPLE_RATE = 44100;
+    const int OVERSAMPLE = 64;
+    const int SIMULATION_SAMPLES = 2 * SAMPLE_RATE;
+
+    // Start both circuits on their attractors, away from the power-up state.
+    TorporSlothCircuit delayedA;
+    ApathySlothCircuit delayedB;
+    delayedA.advance(10.0);
+    delayedB.advance(10.0);
+
+    SlothNetwork<2> network, reference;
+    for (SlothNetwork<2> *n : {&network, &reference})
+    {
+        n->setVoice(0, delayedA);
+        n->setVoice(1, delayedB);
+        n->connect(0, 1, FORWARD_GAIN);
+        n->connect(1, 0, FEEDBACK_GAIN);
+    }
+
+    int limitCount = 0;
+    double networkError = 0.0;
+    double delayedError = 0.0;
+    for (int sample = 0; sample < SIMULATION_SAMPLES; ++sample)
+    {
+        if (network.update(SAMPLE_RATE) >= network.iterationLimit)
+            ++limitCount;
+
+        for (int k = 0; k < OVERSAMPLE; ++k)
+            reference.update(SAMPLE_RATE * OVERSAMPLE);
+
+        // Each separate circuit sees the other's voltage from the previous sample.
+        const double ax = delayedA.xVoltage();
+        delayedA.setControlVoltage(FEEDBACK_GAIN * delayedB.xVoltage());
+        delayedB.setControlVoltage(FORWARD_GAIN * ax);
+        delayedA.update(SAMPLE_RATE);
+        delayedB.update(SAMPLE_RATE);
+
+        if (!CheckVoltage(network.xVoltage(0), "x", sample)) return false;
+        if (!CheckVoltage(network.xVoltage(1), "x", sample)) return false;
+
+        networkError = std::max(networkError, std::abs(network.xVoltage(0) - reference.xVoltage(0)));
+        networkError = std::max(networkError, std::abs(network.xVoltage(1) - reference.xVoltage(1)));
+        delayedError = std::max(delayedError, std::abs(delayedA.xVoltage() - reference.xVoltage(0)));
+        delayedError = std::max(delayedError, std::abs(delayedB.xVoltage() - reference.xVoltage(1)));
+    }
+
+    printf("NetworkCoupling: max error network = %lg V, delayed circuits = %lg V, iteration limit hit %d times\n", networkError, delayedError, limitCount);
+
+    if (networkError > delayedError / 100)
+    {
+        printf("NetworkCoupling: FAIL - the network is not much more accurate than delayed circuits.\n");
+        return false;
+    }
+
+    if (limitCount > SIMULATION_SAMPLES / 1000)
+    {
+        printf("NetworkCoupling: FAIL - EXCESSIVE number of iteration limit hits.\n");
+        return false;
+    }
+
+    printf("NetworkCoupling: PASS\n");
+    return true;
+}
+
+
+bool NetlistBasics()
+{
+    // Verify the netlist engine against circuits whose answers are known exactly:
+    // an RC circuit charging toward a fixed voltage, and an inverting amplifier.
+
+    using namespace Analog;
+
+    printf("NetlistBasics: starting\n");
+
+    const double R = 10.0e+3;
+    const double C = 1.0e-6;
+    const double VIN = 1.0;
+    const int SAMPLE_RATE = 44100;
+
+    NetlistCircuit rc;
+    int ng = rc.createGroundNode();
+    int nin = rc.createForcedVoltageNode(VIN);
+    int na = rc.createNode();
+    rc.addResistor(R, nin, na);
+    rc.addCapacitor(C, na, ng);
+    rc.lock();
+
+    double rcError = 0.0;
+    for (int sample = 1; sample <= SAMPLE_RATE / 10; ++sample)
+    {
+        rc.update(SAMPLE_RATE);
+        double t = static_cast<double>(sample) / SAMPLE_RATE;
+        double expected = VIN * (1.0 - std::exp(-t / (R*C)));
+        rcError = std::max(rcError, std::abs(rc.nodeVoltage(na) - expected));
+    }
+
+    printf("NetlistBasics: RC max error = %lg V\n", rcError);
+    if (rcError > 1.0e-6)
+    {
+        printf("NetlistBasics: FAIL - EXCESSIVE RC error.\n");
+        return false;
+    }
+
+    NetlistCircuit amp;
+    int vin = amp.createForcedVoltageNode(2.0);
+    int neg = amp.createNode();
+    int out = amp.createNode();
+    amp.addResistor(10.0e+3, vin, neg);
+    int feedback = amp.addResistor(47.0e+3, neg, out);
+    amp.addLinearAmp(neg, out);
+    amp.lock();
+    amp.update(SAMPLE_RATE);
+    double gainError = std::abs(amp.nodeVoltage(out) - (-9.4));
+    amp.setResistance(feedback, 22.0e+3);
+    amp.setForcedVoltage(vin, -1.0);
+    amp.update(SAMPLE_RATE);
+    gainError = std::max(gainError, std::abs(amp.nodeVoltage(out) - 2.2));
+    if (gainError > 1.0e-12 || amp.unknownCount() != 1)
+    {
+        printf("NetlistBasics: FAIL - inverting amplifier error = %lg V, unknowns = %d\n", gainError, amp.unknownCount());
+        return false;
+    }
+
+    bool rejected = false;
+    try
+    {
+        NetlistCircuit bad;
+        int ground = bad.createGroundNode();
+        int n1 = bad.createNode();
+        bad.addLinearAmp(ground, n1);
+    }
+    catch (const std::logic_error&)
+    {
+        rejected = true;
+    }
+
+    if (!rejected)
+    {
+        printf("NetlistBasics: FAIL - accepted a linear amp whose input is grounded.\n");
+        return false;
+    }
+
+    printf("NetlistBasics: PASS\n");
+    return true;
+}
+
+
+template <typename circuit_t, typename params_t>
+bool NetlistMatchesCircuit(const char *name)
+{
+    // Verify that the Sloth schematic, solved as a general netlist,
+    // follows the same trajectory as the hand-derived update in SlothCircuit.hpp.
+    // The two use different second-order integrators, so they agree closely but not exactly.
+
+    using namespace Analog;
+
+    printf("NetlistMatchesCircuit(%s): starting\n", name);
+
+    circuit_t circuit;
+    SlothNetlist<params_t> netlist;
+    if (netlist.unknownCount() != 4)
+    {
+        printf("NetlistMatchesCircuit(%s): FAIL - expected 4 unknowns but found %d\n", name, netlist.unknownCount());
+        return false;
+    }
+
+    const int SAMPLE_RATE = 44100;
+    const int SIMULATION_SAMPLES = 2 * SAMPLE_RATE;
+    const double TOLERANCE = 1.0e-4;
+
+    int splitCount = 0;
+    double maxError = 0.0;
+    for (int sample = 0; sample < SIMULATION_SAMPLES; ++sample)
+    {
+        if (sample % 4410 == 0)
+        {
+            double knob = (sample % 3) / 2.0;
+            double cv = 0.25 * ((sample / 4410) % 5 - 2);
+            circuit.setKnobPosition(knob);
+            circuit.setControlVoltage(cv);
+            netlist.setKnobPosition(knob);
+            netlist.setControlVoltage(cv);
+        }
+
+        circuit.update(SAMPLE_RATE);
+        if (netlist.update(SAMPLE_RATE) > 1)
+            ++splitCount;
+
+        maxError = std::max(maxError, std::abs(netlist.xVoltage() - circuit.xVoltage()));
+        maxError = std::max(maxError, std::abs(netlist.wVoltage() - circuit.wVoltage()));
+        maxError = std::max(maxError, std::abs(netlist.yVoltage() - circuit.yVoltage()));
+        maxError = std::max(maxError, std::abs(netlist.zVoltage() - circuit.zVoltage()));
+    }
+
+    printf("NetlistMatchesCircuit(%s): max error = %lg V, split steps = %d\n", name, maxError, splitCount);
+
+    if (maxError > TOLERANCE)
+    {
+        printf("NetlistMatchesCircuit(%s): FAIL - EXCESSIVE error.\n", name);
+        return false;
+    }
+
+    printf("NetlistMatchesCircuit(%s): PASS\n", name);
+    return true;
+}
+
+
+template <typename kernel_t, typename circuit_t>
+bool KernelMatchesCircuit(const char *name)
+{
+    // Verify that the update kernel generated from the netlist
+    // follows the hand-derived SlothCircuit with the knob at 0.
+    // Both use the same midpoint solver, so only roundoff separates them.
+
+    using namespace Analog;
+
+    printf("KernelMatchesCircuit(%s): starting\n", name);
+
+    kernel_t kernel;
+    circuit_t circuit;
+
+    const int SAMPLE_RATE = 44100;
+    const int SIMULATION_SAMPLES = 10 * SAMPLE_RATE;
+    const double TOLERANCE = 1.0e-12;
+
+    double maxError = 0.0;
+    for (int sample = 0; sample < SIMULATION_SAMPLES; ++sample)
+    {
+        if (sample % SAMPLE_RATE == 0)
+        {
+            // SlothCircuit keeps its stored z until the end of the step after a CV change,
+            // while the kernel calculates z from the new CV immediately.
+            // Give the circuit the consistent z, so that both solve the same problem.
+            // Two of the control voltages are beyond the supply rails, where both must clamp.
+            const double cvList[] = { -1.0, -0.5, 0.0, +0.5, +1.0, +15.0, -0.5, -20.0, +0.5, +1.0 };
+            double cv = cvList[sample / SAMPLE_RATE];
+            circuit.setControlVoltage(cv);
+            kernel.setControlVoltage(cv);
+            SlothState state = circuit.saveState();
+            state.z = kernel.zVoltage();
+            circuit.restoreState(state);
+        }
+
+        int iter = kernel.update(SAMPLE_RATE);
+        circuit.update(SAMPLE_RATE);
+        if (iter < 2 || iter > kernel.iterationLimit)
+        {
+            printf("KernelMatchesCircuit(%s): FAIL - unexpected iteration count %d at sample %d\n", name, iter, sample);
+            return false;
+        }
+
+        maxError = std::max(maxError, std::abs(kernel.xVoltage() - circuit.xVoltage()));
+        maxError = std::max(maxError, std::abs(kernel.wVoltage() - circuit.wVoltage()));
+        maxError = std::max(maxError, std::abs(kernel.yVoltage() - circuit.yVoltage()));
+        maxError = std::max(maxError, std::abs(kernel.zVoltage() - circuit.zVoltage()));
+    }
+
+    printf("KernelMatchesCircuit(%s): max error = %lg V\n", name, maxError);
+
+    if (maxError > TOLERANCE)
+    {
+        printf("KernelMatchesCircuit(%s): FAIL - EXCESSIVE error.\n", name);
+        return false;
+    }
+
+    printf("KernelMatchesCircuit(%s): PASS\n", name);
+    return true;
+}
+
+
+bool KernelSourceIsCurrent()
+{
+    // Verify that SlothKernels.hpp is exactly what the generator produces today,
+    // so a change to the netlist engine or generator cannot leave it stale.
+
+    using namespace Analog;
+
+    printf("KernelSourceIsCurrent: starting\n");
+
+    const char *filename = "SlothKernels.hpp";
+    FILE *infile = fopen(filename, "rb");
+    if (infile == nullptr)
+    {
+        printf("KernelSourceIsCurrent: FAIL - cannot open %s\n", filename);
+        return false;
+    }
+
+    std::string text;
+    char buffer[4096];
+    size_t nread;
+    while ((nread = fread(buffer, 1, sizeof(buffer), infile)) > 0)
+        text.append(buffer, nread);
+    fclose(infile);
+
+    if (text != GenerateSlothKernels())
+    {
+        printf("KernelSourceIsCurrent: FAIL - %s is stale. Run ./kg to regenerate it.\n", filename);
+        return false;
+    }
+
+    printf("KernelSourceIsCurrent: PASS\n");
+    return true;
+}
+
+
+static bool ReadWholeFile(const char *filename, std::vector<unsigned char>& data)
+{
+    data.clear();
+    FILE *infile = fopen(filename, "rb");
+    if (infile == nullptr)
+        return false;
+    unsigned char buffer[4096];
+    size_t nread;
+    while ((nread = fread(buffer, 1, sizeof(buffer), infile)) > 0)
+        data.insert(data.end(), buffer, buffer + nread);
+    fclose(infile);
+    return true;
+}
+
+
+bool RenderMatchesUpdate()
+{
+    // Verify that rendered files hold exactly the samples of calling `update`
+    // once per sample, regardless of the chunk size, the file format,
+    // or how many renders run in parallel.
+
+    using namespace Analog;
+
+    printf("RenderMatchesUpdate: starting\n");
+
+    SlothRenderSpec spec;
+    spec.seconds = 0.5;
+    spec.chunkFrames = 1000;        // rounded up to 1024, so the renders need many chunks
+
+    std::vector<SlothRenderJob> jobs(3);
+    jobs[0] = SlothRenderJob{SlothVariant::Torpor,  0.3, +1.5, "render_test_0.wav"};
+    jobs[1] = SlothRenderJob{SlothVariant::Inertia, 0.8, -2.0, "render_test_1.wav"};
+    jobs[2] = SlothRenderJob{SlothVariant::Torpor,  0.3, +1.5, "render_test_2.raw"};
+
+    SlothThreadPool pool(2);
+    int failures = RunRenders(pool, std::vector<SlothRenderJob>(jobs.begin(), jobs.begin() + 2), spec);
+    spec.format = SlothRenderFormat::Raw;
+    spec.chunkFrames = 65536;
+    failures += RunRenders(pool, std::vector<SlothRenderJob>(jobs.begin() + 2, jobs.end()), spec);
+    if (failures != 0)
+    {
+        printf("RenderMatchesUpdate: FAIL - %d renders could not be written.\n", failures);
+        return false;
+    }
+
+    std::vector<unsigned char> wav, inertia, raw;
+    bool ok = ReadWholeFile(jobs[0].filename.c_str(), wav) && ReadWholeFile(jobs[1].filename.c_str(), inertia) && ReadWholeFile(jobs[2].filename.c_str(), raw);
+    for (const SlothRenderJob& job : jobs)
+        remove(job.filename.c_str());
+
+    if (!ok)
+    {
+        printf("RenderMatchesUpdate: FAIL - cannot read back the rendered files.\n");
+        return false;
+    }
+
+    const long long frames = spec.frameCount();
+    const size_t dataBytes = static_cast<size_t>(frames) * 3 * sizeof(float);
+    if (wav.size() != SlothWavHeader::size + dataBytes || memcmp(&wav[0], "RIFF", 4) || memcmp(&wav[8], "WAVE", 4) || memcmp(&wav[SlothWavHeader::size - 8], "data", 4))
+    {
+        printf("RenderMatchesUpdate: FAIL - incorrect WAV file layout.\n");
+        return false;
+    }
+
+    if (raw.size() != dataBytes || memcmp(&raw[0], &wav[SlothWavHeader::size], dataBytes))
+    {
+        printf("RenderMatchesUpdate: FAIL - the raw file does not match the WAV samples.\n");
+        return false;
+    }
+
+    TorporSlothCircuit torpor;
+    InertiaSlothCircuit inertiaCircuit;
+    torpor.setKnobPosition(0.3);
+    torpor.setControlVoltage(+1.5);
+    inertiaCircuit.setKnobPosition(0.8);
+    inertiaCircuit.setControlVoltage(-2.0);
+    for (long long i = 0; i < frames; ++i)
+    {
+        torpor.update(spec.sampleRateHz);
+        inertiaCircuit.update(spec.sampleRateHz);
+        const float expected[2][3] =
+        {
+            { static_cast<float>(torpor.xVoltage()), static_cast<float>(torpor.yVoltage()), static_cast<float>(torpor.zVoltage()) },
+            { static_cast<float>(inertiaCircuit.xVoltage()), static_cast<float>(inertiaCircuit.yVoltage()), static_cast<float>(inertiaCircuit.zVoltage()) },
+        };
+        const size_t offset = SlothWavHeader::size + static_cast<size_t>(i) * sizeof(expected[0]);
+        if (memcmp(&wav[offset], expected[0], sizeof(expected[0])) || memcmp(&inertia[offset], expected[1], sizeof(expected[1])))
+        {
+            printf("RenderMatchesUpdate: FAIL - rendered samples do not match update at frame %lld\n", i);
+            return false;
+        }
+    }
+
+    // Two renders of the same file at once would corrupt it, so they are refused.
+    const std::vector<SlothRenderJob> duplicates {jobs[0], jobs[1], jobs[0]};
+    if (FindDuplicateRender(duplicates) != 2 || RunRenders(pool, duplicates, spec) != 3 || ReadWholeFile(jobs[0].filename.c_str(), wav))
+    {
+        printf("RenderMatchesUpdate: FAIL - renders with the same filename were not refused.\n");
+        remove(jobs[0].filename.c_str());
+        remove(jobs[1].filename.c_str());
+        return false;
+    }
+
+    printf("RenderMatchesUpdate: PASS\n");
+    return true;
+}
+
+
+static bool BruteEnvelope(const Analog::SlothTrace& trace, int channel, long long a, long long b, Analog::SlothEnvelope& env)
+{
+    // The exact envelope of frames [a, b), clipped to the trace.
+    a = std::max(0LL, a);
+    b = std::min(trace.frameCount(), b);
+    if (b <= a)
+        return false;
+    double sum = 0.0;
+    env.min = env.max = trace.sample(a, channel);
+    for (long long f = a; f < b; ++f)
+    {
+        const float v = trace.sample(f, channel);
+        env.min = std::min(env.min, v);
+        env.max = std::max(env.max, v);
+        sum += v;
+    }
+    env.mean = static_cast<float>(sum / (b - a));
+    return true;
+}
+
+
+bool OverviewMatchesSamples()
+{
+    // Verify that overview windows agree with the envelopes of the samples they cover,
+    // from the whole recording down to single frames, and that overview files
+    // load back exactly as they were saved.
+
+    using namespace Analog;
+
+    printf("OverviewMatchesSamples: starting\n");
+
+    SlothRenderSpec spec;
+    spec.seconds = 2.0;
+    const SlothRenderJob job{SlothVariant::Torpor, 0.5, +0.7, "overview_test.wav"};
+    const std::string overviewFileName = OverviewFileName(job.filename.c_str());
+    SlothTrace trace;
+    if (!RenderJob(job, spec) || !trace.load(job.filename.c_str()))
+    {
+        printf("OverviewMatchesSamples: FAIL - cannot render and open %s\n", job.filename.c_str());
+        remove(job.filename.c_str());
+        return false;
+    }
+
+    if (trace.channelCount() != 3 || trace.frameCount() != spec.frameCount() || trace.secondsPerFrame() != 1.0 / 44100.0)
+    {
+        printf("OverviewMatchesSamples: FAIL - channels=%d, frames=%lld, secondsPerFrame=%g\n", trace.channelCount(), trace.frameCount(), trace.secondsPerFrame());
+        return false;
+    }
+
+    TorporSlothCircuit circuit;
+    circuit.setKnobPosition(job.knob);
+    circuit.setControlVoltage(job.cv);
+    for (long long f = 0; f < 100; ++f)
+    {
+        circuit.update(spec.sampleRateHz);
+        if (trace.sample(f, 0) != static_cast<float>(circuit.xVoltage()) || trace.sample(f, 2) != static_cast<float>(circuit.zVoltage()))
+        {
+            printf("OverviewMatchesSamples: FAIL - trace does not match the circuit at frame %lld\n", f);
+            return false;
+        }
+    }
+
+    SlothOverview overview;
+    overview.build(trace, 3);
+    const long long frames = trace.frameCount();
+    if (overview.levelCount() != 15 || !overview.matches(trace))
+    {
+        printf("OverviewMatchesSamples: FAIL - levelCount=%d, matches=%d\n", overview.levelCount(), overview.matches(trace));
+        return false;
+    }
+
+    struct Window { long long first; long long count; int pixels; };
+    const Window windows[] =
+    {
+        {0, frames, 800},               // the whole recording
+        {0, frames, 1},
+        {12345, 44100, 800},            // one second
+        {70000, 4000, 800},             // fine enough to use the samples
+        {70000, 100, 800},              // zoomed in past single frames
+        {frames - 1000, 50000, 500},    // mostly past the end
+        {3000, 9000, 301},              // a bucket size that does not divide the pixels evenly
+    };
+
+    std::vector<SlothEnvelope> out(800), fine(800), loaded(800);
+    for (const Window& w : windows)
+    {
+        const double framesPerPixel = static_cast<double>(w.count) / w.pixels;
+        for (int c = 0; c < trace.channelCount(); ++c)
+        {
+            const int n = overview.window(c, w.first, w.count, w.pixels, out.data());
+            const int m = overview.window(c, w.first, w.count, w.pixels, fine.data(), trace.samples());
+            if (n != m)
+            {
+                printf("OverviewMatchesSamples: FAIL - filled %d and %d pixels\n", n, m);
+                return false;
+            }
+            for (int p = 0; p < n; ++p)
+            {
+                long long a = w.first + (p * w.count) / w.pixels;
+                long long b = std::max(a + 1, w.first + ((p + 1) * w.count) / w.pixels);
+                SlothEnvelope exact, outer;
+                if (!BruteEnvelope(trace, c, a, b, exact))
+                {
+                    printf("OverviewMatchesSamples: FAIL - pixel %d of window at %lld is empty\n", p, w.first);
+                    return false;
+                }
+
+                // With the samples, a fine window is exact.
+                if (framesPerPixel < 8.0 && (fine[p].min != exact.min || fine[p].max != exact.max || std::abs(fine[p].mean - exact.mean) > 1.0e-6))
+                {
+                    printf("OverviewMatchesSamples: FAIL - fine pixel %d of window at %lld differs\n", p, w.first);
+                    return false;
+                }
+
+                // Otherwise it covers the pixel, plus less than a bucket on either side.
+                const long long margin = std::max(8LL, static_cast<long long>(framesPerPixel));
+                BruteEnvelope(trace, c, a - margin, b + margin, outer);
+                if (out[p].min > exact.min || out[p].max < exact.max || out[p].min < outer.min || out[p].max > outer.max || out[p].mean < out[p].min || out[p].mean > out[p].max)
+                {
+                    printf("OverviewMatchesSamples: FAIL - pixel %d of window at %lld, channel %d: [%g, %g] does not cover [%g, %g] within [%g, %g]\n",
+                        p, w.first, c, out[p].min, out[p].max, exact.min, exact.max, outer.min, outer.max);
+                    return false;
+                }
+
+                if (w.pixels == 1 && (out[p].min != exact.min || out[p].max != exact.max || std::abs(out[p].mean - exact.mean) > 1.0e-5))
+                {
+                    printf("OverviewMatchesSamples: FAIL - the whole recording's envelope differs\n");
+                    return false;
+                }
+            }
+
+            if ((w.first + w.count > frames) ? (n >= w.pixels) : (n != w.pixels))
+            {
+                printf("OverviewMatchesSamples: FAIL - filled %d of %d pixels in the window at %lld\n", n, w.pixels, w.first);
+                return false;
+            }
+        }
+    }
+
+    SlothEnvelope total = overview.total(1);
+    SlothEnvelope everything;
+    BruteEnvelope(trace, 1, 0, frames, everything);
+    if (total.min != everything.min || total.max != everything.max)
+    {
+        printf("OverviewMatchesSamples: FAIL - total envelope differs\n");
+        return false;
+    }
+
+    if (overview.window(0, -1, 100, 10, out.data()) != 0 || overview.window(0, frames, 100, 10, out.data()) != 0)
+    {
+        printf("OverviewMatchesSamples: FAIL - filled pixels of a window outside the recording\n");
+        return false;
+    }
+
+    // Save, load, and compare.
+    SlothOverview copy;
+    bool ok = overview.save(overviewFileName.c_str()) && copy.load(overviewFileName.c_str()) && copy.matches(trace);
+    ok = ok && (copy.levelCount() == overview.levelCount()) && (copy.bucketShift() == 3) && (copy.secondsPerFrame() == trace.secondsPerFrame());
+    for (int c = 0; ok && c < trace.channelCount(); ++c)
+    {
+        const int n = overview.window(c, 3333, 55555, 777, out.data());
+        ok = (copy.window(c, 3333, 55555, 777, loaded.data()) == n) && !memcmp(out.data(), loaded.data(), n * sizeof(SlothEnvelope));
+    }
+    if (!ok)
+    {
+        printf("OverviewMatchesSamples: FAIL - overview file did not load back identically\n");
+        return false;
+    }
+
+    // An overview of the same samples from somewhere else does not match the file.
+    SlothOverview unrelated;
+    unrelated.build(trace.samples(), trace.frameCount(), trace.channelCount(), trace.secondsPerFrame());
+    if (unrelated.matches(trace) || LoadOrBuildOverview(unrelated, trace, overviewFileName.c_str()) != true || !unrelated.matches(trace))
+    {
+        printf("OverviewMatchesSamples: FAIL - overview file matching\n");
+        return false;
+    }
+
+    // A truncated or corrupt overview file is rejected before anything is allocated for it.
+    std::vector<unsigned char> ovw;
+    ok = ReadWholeFile(overviewFileName.c_str(), ovw) && ovw.size() > sizeof(SlothOverviewHeader);
+    for (int corruption = 0; ok && corruption < 2; ++corruption)
+    {
+        std::vector<unsigned char> bad = ovw;
+        if (corruption == 0)
+        {
+            bad.pop_back();
+        }
+        else
+        {
+            const std::uint64_t hugeFrameCount = 1ULL << 44;
+            memcpy(&bad[offsetof(SlothOverviewHeader, frameCount)], &hugeFrameCount, sizeof(hugeFrameCount));
+        }
+        FILE *outfile = fopen(overviewFileName.c_str(), "wb");
+        ok = (outfile != nullptr) && (fwrite(bad.data(), 1, bad.size(), outfile) == bad.size());
+        if (outfile != nullptr)
+            ok = (fclose(outfile) == 0) && ok;
+        ok = ok && !copy.load(overviewFileName.c_str()) && copy.levelCount() == 0;
+        ok = ok && !LoadOrBuildOverview(copy, trace, overviewFileName.c_str()) && copy.matches(trace) && copy.load(overviewFileName.c_str());
+    }
+    if (!ok)
+    {
+        printf("OverviewMatchesSamples: FAIL - a corrupt overview file was not rejected and rebuilt\n");
+        return false;
+    }
+
+    remove(job.filename.c_str());
+    remove(overviewFileName.c_str());
+
+    // A hardware log becomes 4 channels of volts, including w.
+    const char *logFileName = "overview_test.csv";
+    FILE *logFile = fopen(logFileName, "wt");
+    if (logFile == nullptr)
+    {
+        printf("OverviewMatchesSamples: FAIL - cannot create %s\n", logFileName);
+        return false;
+    }
+    fprintf(logFile, "1000,100,200,300,500\n1200,110,210,310,510\n1400,120,220,320,520\n");
+    fclose(logFile);
+
+    SlothTrace logTrace;
+    ok = logTrace.load(logFileName);
+    ok = ok && logTrace.channelCount() == 4 && logTrace.frameCount() == 3;
+    ok = ok && std::abs(logTrace.secondsPerFrame() - 0.2) < 1.0e-12 && logTrace.startSeconds() == 1.0;
+    ok = ok && logTrace.sample(2, 1) == static_cast<float>(ArduinoVoltage(220));
+    ok = ok && logTrace.sample(1, 3) == static_cast<float>(Node3Voltage(510));
+    remove(logFileName);
+    if (!ok)
+    {
+        printf("OverviewMatchesSamples: FAIL - hardware log trace\n");
+        return false;
+    }
+
+    printf("OverviewMatchesSamples: PASS\n");
+    return true;
+}
+
+
 int main()
 {
     using namespace Analog;
 
     return (
+        FloatContraction() &&
         PerformanceAndStability<TorporSlothCircuit>("Torpor") &&
         PerformanceAndStability<ApathySlothCircuit>("Apathy") &&
         PerformanceAndStability<InertiaSlothCircuit>("Inertia") &&
-        ButterflyEffect<TorporSlothCircuit>("Torpor")
+        ButterflyEffect<TorporSlothCircuit>("Torpor") &&
+        BlockProcessing<TorporSlothCircuit>("Torpor") &&
+        BlockProcessing<InertiaSlothCircuit>("Inertia") &&
+        BlockProcessing<ApathySlothCircuit>("Apathy", SlothIntegrator::Exact) &&
+        ExactIntegrator<TorporSlothCircuit>("Torpor") &&
+        ExactIntegrator<ApathySlothCircuit>("Apathy") &&
+        ExactIntegrator<InertiaSlothCircuit>("Inertia") &&
+        ControlRate<TorporSlothCircuit>("Torpor") &&
+        ControlRate<ApathySlothCircuit>("Apathy") &&
+        ControlRate<InertiaSlothCircuit>("Inertia") &&
+        AdaptiveIntegration<TorporSlothCircuit>("Torpor") &&
+        SaveRestoreAdvance<TorporSlothCircuit>("Torpor") &&
+        SaveRestoreAdvance<InertiaSlothCircuit>("Inertia") &&
+        SnapshotTable() &&
+        FloatPrecision<TorporSlothCircuitT<float>, TorporSlothCircuit>("Torpor") &&
+        FloatPrecision<InertiaSlothCircuitT<float>, InertiaSlothCircuit>("Inertia") &&
+        StaticMatchesCircuit<StaticTorporSlothCircuit, TorporSlothCircuit>("Torpor") &&
+        StaticMatchesCircuit<StaticInertiaSlothCircuit, InertiaSlothCircuit>("Inertia") &&
+        StaticCustomVariant() &&
+        ThreadPoolBatches() &&
+        EnsembleMatchesCircuits() &&
+        BankMatchesCircuits() &&
+        SweepMatchesCircuits() &&
+        LyapunovExponent<TorporSlothCircuit>("Torpor", 0.5, 0.1, 100) &&
+        LyapunovExponent<ApathySlothCircuit>("Apathy", 0.0, 0.0, 100) &&
+        LyapunovExponent<InertiaSlothCircuit>("Inertia", 0.0, 0.0, 100) &&
+        LogReader() &&
+        FitComponents() &&
+        RingTransfer() &&
+        AudioVoice() &&
+        SolverStatistics(SlothIntegrator::Midpoint) &&
+        SolverStatistics(SlothIntegrator::Exact) &&
+        PredictiveSolver<TorporSlothCircuit>("Torpor") &&
+        PredictiveSolver<ApathySlothCircuit>("Apathy") &&
+        PredictiveSolver<InertiaSlothCircuit>("Inertia") &&
+        PolyModuleMatchesCircuits() &&
+        NetworkMatchesCircuits() &&
+        NetworkCoupling() &&
+        NetlistBasics() &&
+        NetlistMatchesCircuit<TorporSlothCircuit, TorporParameters>("Torpor") &&
+        NetlistMatchesCircuit<ApathySlothCircuit, ApathyParameters>("Apathy") &&
+        NetlistMatchesCircuit<InertiaSlothCircuit, InertiaParameters>("Inertia") &&
+        KernelMatchesCircuit<TorporKernel, TorporSlothCircuit>("Torpor") &&
+        KernelMatchesCircuit<ApathyKernel, ApathySlothCircuit>("Apathy") &&
+        KernelMatchesCircuit<InertiaKernel, InertiaSlothCircuit>("Inertia") &&
+        KernelSourceIsCurrent() &&
+        RenderMatchesUpdate() &&
+        OverviewMatchesSamples()
     ) ? 0 : 1;
 }
@@ -0,0 +1,226 @@
+/*
+    fit.cpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Fits Sloth Torpor component values to hardware voltage logs.
+    See SlothFit.hpp for how the simulation and the logs are compared.
+
+    https://github.com/cosinekitty/sloth
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "SlothFit.hpp"
+#include "TimeInSeconds.hpp"
+
+
+static int PrintUsage()
+{
+    printf(
+        "USAGE: fit [options] logfile [logfile ...]\n"
+        "\n"
+        "Each log's control voltage is taken from its file name, as in\n"
+        "cv0_r0.csv (0 V), cvn5_r0.csv (-5 V), or cvp1_r0.csv (+1 V).\n"
+        "\n"
+        "Options:\n"
+        "    -v name,name,...   components to fit (default C2,QNEG,QPOS)\n"
+        "                       from C1 C2 C3 R1 R2 R4 R5 R6 R7 R8 QNEG QPOS\n"
+        "    -k knob            knob position for all logs (default 0)\n"
+        "    -t seconds         longest stretch of each log to use (default 3600)\n"
+        "    -g generations     maximum number of generations (default 20)\n"
+        "    -p population      candidates per generation (default 32)\n"
+        "    -r rate            simulation sample rate in Hz (default 4000)\n"
+        "    -j threads         total threads to use (default: all hardware threads)\n"
+    );
+    return 1;
+}
+
+
+struct Variable
+{
+    const char *name;
+    double Analog::SlothComponentValues::*member;
+};
+
+
+static const Variable Variables[] =
+{
+    { "C1",   &Analog::SlothComponentValues::C1   },
+    { "C2",   &Analog::SlothComponentValues::C2   },
+    { "C3",   &Analog::SlothComponentValues::C3   },
+    { "R1",   &Analog::SlothComponentValues::R1   },
+    { "R2",   &Analog::SlothComponentValues::R2   },
+    { "R4",   &Analog::SlothComponentValues::R4   },
+    { "R5",   &Analog::SlothComponentValues::R5   },
+    { "R6",   &Analog::SlothComponentValues::R6   },
+    { "R7",   &Analog::SlothComponentValues::R7   },
+    { "R8",   &Analog::SlothComponentValues::R8   },
+    { "QNEG", &Analog::SlothComponentValues::QNEG },
+    { "QPOS", &Analog::SlothComponentValues::QPOS },
+};
+
+
+static std::vector<const Variable *> fitted;
+
+
+static bool ParseVariables(const char *text)
+{
+    fitted.clear();
+    std::string list(text);
+    std::size_t start = 0;
+    while (true)
+    {
+        std::size_t comma = list.find(',', start);
+        std::string name = list.substr(start, (comma == std::string::npos) ? std::string::npos : comma - start);
+        const Variable *found = nullptr;
+        for (const Variable& v : Variables)
+            if (name == v.name)
+                found = &v;
+        if (found == nullptr)
+            return false;
+        fitted.push_back(found);
+        if (comma == std::string::npos)
+            return true;
+        start = comma + 1;
+    }
+}
+
+
+static bool ParseControlVoltage(const char *filename, double& cv)
+{
+    // Find "cv" followed by an optional 'n' or 'p' and an integer in the file name.
+    const char *slash = strrchr(filename, '/');
+    const char *name = (slash != nullptr) ? slash + 1 : filename;
+    if (strncmp(name, "cv", 2))
+        return false;
+    const char *p = name + 2;
+    double sign = +1.0;
+    if (*p == 'n')
+    {
+        sign = -1.0;
+        ++p;
+    }
+    else if (*p == 'p')
+    {
+        ++p;
+    }
+    if (*p < '0' || *p > '9')
+        return false;
+    cv = sign * atoi(p);
+    return true;
+}
+
+
+static void PrintProgress(int generation, const Analog::SlothFitResult& result, const std::vector<double>& spread)
+{
+    printf("fit: generation %2d: distance = %0.6lf", generation + 1, result.distance);
+    for (std::size_t v = 0; v < fitted.size(); ++v)
+        printf("  %s = %0.6lg (spread %0.4lf)", fitted[v]->name, result.best.*fitted[v]->member, spread[v]);
+    printf("\n");
+    fflush(stdout);
+}
+
+
+int main(int argc, const char *argv[])
+{
+    using namespace Analog;
+
+    SlothFitSpec spec;
+    double knob = 0.0;
+    double maxSeconds = 3600.0;
+    int threads = SlothThreadPool::defaultWorkerCount() + 1;
+    ParseVariables("C2,QNEG,QPOS");
+
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; ++i)
+    {
+        const char *opt = argv[i];
+        if (i + 1 >= argc)
+            return PrintUsage();
+        const char *arg = argv[++i];
+        if (!strcmp(opt, "-v"))
+        {
+            if (!ParseVariables(arg))
+                return PrintUsage();
+        }
+        else if (!strcmp(opt, "-k"))
+            knob = atof(arg);
+        else if (!strcmp(opt, "-t"))
+            maxSeconds = atof(arg);
+        else if (!strcmp(opt, "-g"))
+            spec.generations = atoi(arg);
+        else if (!strcmp(opt, "-p"))
+            spec.population = atoi(arg);
+        else if (!strcmp(opt, "-r"))
+            spec.sampleRateHz = static_cast<float>(atof(arg));
+        else if (!strcmp(opt, "-j"))
+            threads = atoi(arg);
+        else
+            return PrintUsage();
+    }
+
+    if (i == argc || maxSeconds <= 0.0 || spec.generations < 1 || spec.population < 2 || spec.sampleRateHz <= 0.0f || threads < 1)
+        return PrintUsage();
+
+    spec.variables.clear();
+    for (const Variable *v : fitted)
+        spec.variables.push_back(v->member);
+    spec.elite = std::max(2, spec.population / 5);
+
+    std::vector<SlothFitTarget> targets;
+    for (; i < argc; ++i)
+    {
+        const char *filename = argv[i];
+        SlothFitTarget target;
+        target.knob = knob;
+        if (!ParseControlVoltage(filename, target.cv))
+        {
+            printf("fit: cannot tell the control voltage from the file name: %s\n", filename);
+            return 1;
+        }
+
+        SlothLog log;
+        if (!log.load(filename))
+        {
+            printf("fit: cannot load log file: %s\n", filename);
+            return 1;
+        }
+        if (log.intervalMillis() <= 0)
+        {
+            printf("fit: log file does not have a regular sample interval: %s\n", filename);
+            return 1;
+        }
+
+        // Use the same stretch of each log that the simulation will produce.
+        target.intervalSeconds = log.intervalMillis() / 1000.0;
+        double logSeconds = log.rowCount() * target.intervalSeconds - spec.skipSeconds;
+        target.seconds = std::min(maxSeconds, logSeconds);
+        if (target.seconds < SlothSignature::SegmentLength * target.intervalSeconds)
+        {
+            printf("fit: log file is too short: %s\n", filename);
+            return 1;
+        }
+        if (!targets.empty() && target.intervalSeconds != targets[0].intervalSeconds)
+        {
+            printf("fit: all log files must have the same sample interval: %s\n", filename);
+            return 1;
+        }
+
+        const int rows = static_cast<int>((spec.skipSeconds + target.seconds) / target.intervalSeconds);
+        target.signature = LogSignature(log, spec.skipSeconds, rows);
+        printf("fit: %s: cv = %+0.1lf V, %0.0lf seconds, %0.4lf crossings/second\n", filename, target.cv, target.seconds, target.signature.crossingsPerSecond);
+        targets.push_back(target);
+    }
+
+    SlothThreadPool pool(threads - 1);
+    SlothFitter fitter(pool, targets, spec);
+    double startTime = TimeInSeconds();
+    SlothFitResult result = fitter.fit(PrintProgress);
+    double elapsed = TimeInSeconds() - startTime;
+
+    printf("fit: finished %d generations in %0.3lf seconds. Best distance = %0.6lf\n", result.generations, elapsed, result.distance);
+    for (const Variable *v : fitted)
+        printf("fit: %-4s = %0.6lg\n", v->name, result.best.*v->member);
+    return 0;
+}
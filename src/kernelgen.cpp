@@ -0,0 +1,29 @@
+/*
+    kernelgen.cpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Generates SlothKernels.hpp: specialized update kernels for the Sloth
+    variants, derived from their netlists by NetlistKernel.hpp.
+    Build and run with the script `kg`.
+*/
+
+#include <cstdio>
+#include <string>
+#include "NetlistKernel.hpp"
+
+static const char *OUTPUT_FILENAME = "SlothKernels.hpp";
+
+
+int main()
+{
+    const std::string code = Analog::GenerateSlothKernels();
+    FILE *outfile = std::fopen(OUTPUT_FILENAME, "wt");
+    if (outfile == nullptr)
+    {
+        std::fprintf(stderr, "kernelgen: cannot open output file: %s\n", OUTPUT_FILENAME);
+        return 1;
+    }
+    std::fputs(code.c_str(), outfile);
+    std::fclose(outfile);
+    std::printf("kernelgen: wrote %s\n", OUTPUT_FILENAME);
+    return 0;
+}
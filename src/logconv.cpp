@@ -0,0 +1,88 @@
+/*
+    logconv.cpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Converts Sloth hardware logs between the Arduino CSV format
+    and the compact binary format described in SlothLog.hpp.
+
+    https://github.com/cosinekitty/sloth
+*/
+
+#include <cstdio>
+#include <cstring>
+#include "SlothLog.hpp"
+#include "TimeInSeconds.hpp"
+
+
+static int PrintUsage()
+{
+    printf(
+        "USAGE: logconv infile outfile [packed|delta]\n"
+        "\n"
+        "Reads a hardware log in either CSV or binary format, and writes it\n"
+        "as a binary log. The default encoding is delta, which stores the\n"
+        "difference between consecutive samples in 8 bits. If any difference\n"
+        "is too large, the 16-bit packed encoding is used instead.\n"
+    );
+    return 1;
+}
+
+
+int main(int argc, const char *argv[])
+{
+    using namespace Analog;
+
+    if (argc < 3 || argc > 4)
+        return PrintUsage();
+
+    const char *inFileName = argv[1];
+    const char *outFileName = argv[2];
+    SlothLogEncoding encoding = SlothLogEncoding::Delta8;
+    if (argc == 4)
+    {
+        if (!strcmp(argv[3], "packed"))
+            encoding = SlothLogEncoding::Packed16;
+        else if (strcmp(argv[3], "delta"))
+            return PrintUsage();
+    }
+
+    double startTime = TimeInSeconds();
+    SlothLog log;
+    if (!log.load(inFileName))
+    {
+        if (log.errorLineNumber() > 0)
+            printf("logconv: invalid data in line %d of file: %s\n", log.errorLineNumber(), inFileName);
+        else
+            printf("logconv: cannot read file: %s\n", inFileName);
+        return 1;
+    }
+    double loadTime = TimeInSeconds() - startTime;
+
+    if (!log.save(outFileName, encoding))
+    {
+        printf("logconv: error writing file: %s\n", outFileName);
+        return 1;
+    }
+
+    // Read the binary file back, to make sure it holds exactly the same samples.
+    SlothLog check;
+    bool same = check.load(outFileName) && check.rowCount() == log.rowCount() && check.hasW() == log.hasW();
+    for (int r = 0; same && r < log.rowCount(); ++r)
+    {
+        same =
+            check.millis()[r] == log.millis()[r] &&
+            check.x()[r] == log.x()[r] &&
+            check.y()[r] == log.y()[r] &&
+            check.z()[r] == log.z()[r] &&
+            (!log.hasW() || check.w()[r] == log.w()[r]);
+    }
+    if (!same)
+    {
+        printf("logconv: verification failed for file: %s\n", outFileName);
+        return 1;
+    }
+
+    printf("logconv: converted %d rows from %s to %s (%lu bytes, %s) in %0.3lf ms.\n",
+        log.rowCount(), inFileName, outFileName, static_cast<unsigned long>(log.encode(encoding).size()),
+        log.canDelta8() && encoding == SlothLogEncoding::Delta8 ? "delta" : "packed", 1000.0 * loadTime);
+    return 0;
+}
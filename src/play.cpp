@@ -0,0 +1,116 @@
+/*
+    play.cpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Plays a Sloth circuit through the sound card in real time,
+    with x on the left channel and y on the right.
+    The keyboard adjusts the knob, control voltage, and volume while it plays.
+
+    https://github.com/cosinekitty/sloth
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "SlothAudio.hpp"
+#include "raylib.h"
+
+
+const int AUDIO_SAMPLE_RATE = 44100;
+const int AUDIO_BUFFER_FRAMES = 512;
+
+
+template <typename circuit_t>
+struct Player
+{
+    // raylib's audio callback has no context pointer, so the voice must be static.
+    static Analog::SlothAudioVoice<circuit_t> voice;
+
+    static void callback(void *buffer, unsigned int frames)
+    {
+        // Runs on raylib's audio thread.
+        voice.render(AUDIO_SAMPLE_RATE, static_cast<float *>(buffer), static_cast<int>(frames));
+    }
+};
+
+template <typename circuit_t>
+Analog::SlothAudioVoice<circuit_t> Player<circuit_t>::voice;
+
+
+template <typename circuit_t>
+int Play(const char *name)
+{
+    using voice_t = Analog::SlothAudioVoice<circuit_t>;
+    voice_t& voice = Player<circuit_t>::voice;
+    voice.snapParameters();
+
+    InitWindow(480, 160, TextFormat("Sloth %s Player", name));
+    SetTargetFPS(60);
+    InitAudioDevice();
+    if (!IsAudioDeviceReady())
+    {
+        printf("ERROR: Cannot open the audio device.\n");
+        CloseWindow();
+        return 1;
+    }
+
+    SetAudioStreamBufferSizeDefault(AUDIO_BUFFER_FRAMES);
+    AudioStream stream = LoadAudioStream(AUDIO_SAMPLE_RATE, 32, 2);
+    SetAudioStreamCallback(stream, Player<circuit_t>::callback);
+    PlayAudioStream(stream);
+
+    while (!WindowShouldClose())
+    {
+        // Only the parameter slots are shared with the audio thread.
+        if (IsKeyPressed(KEY_UP))
+            voice.knob.set(std::min(1.0f, voice.knob.get() + 0.05f));
+        if (IsKeyPressed(KEY_DOWN))
+            voice.knob.set(std::max(0.0f, voice.knob.get() - 0.05f));
+        if (IsKeyPressed(KEY_RIGHT))
+            voice.controlVoltage.set(std::min(+12.0f, voice.controlVoltage.get() + 0.25f));
+        if (IsKeyPressed(KEY_LEFT))
+            voice.controlVoltage.set(std::max(-12.0f, voice.controlVoltage.get() - 0.25f));
+        if (IsKeyPressed(KEY_PAGE_UP))
+            voice.volume.set(std::min(1.0f, voice.volume.get() * 1.25f));
+        if (IsKeyPressed(KEY_PAGE_DOWN))
+            voice.volume.set(voice.volume.get() / 1.25f);
+
+        BeginDrawing();
+        ClearBackground(BLACK);
+        DrawText(TextFormat("knob %0.2f", voice.knob.get()), 10, 10, 20, GREEN);
+        DrawText(TextFormat("CV %+0.2f V", voice.controlVoltage.get()), 10, 40, 20, GREEN);
+        DrawText(TextFormat("volume %0.3f per volt", voice.volume.get()), 10, 70, 20, GREEN);
+        DrawText("UP/DOWN knob  LEFT/RIGHT CV  PGUP/PGDN volume", 10, 120, 16, GRAY);
+        EndDrawing();
+    }
+
+    StopAudioStream(stream);
+    UnloadAudioStream(stream);
+    CloseAudioDevice();
+    CloseWindow();
+    return 0;
+}
+
+
+int main(int argc, const char *argv[])
+{
+    using namespace Analog;
+
+    const char *variant = (argc < 2) ? "torpor" : argv[1];
+    if (argc > 2)
+    {
+        printf("USAGE: play [torpor|apathy|inertia]\n");
+        return 1;
+    }
+
+    if (!strcmp(variant, "torpor"))
+        return Play<TorporSlothCircuit>("Torpor");
+
+    if (!strcmp(variant, "apathy"))
+        return Play<ApathySlothCircuit>("Apathy");
+
+    if (!strcmp(variant, "inertia"))
+        return Play<InertiaSlothCircuit>("Inertia");
+
+    printf("ERROR: Unknown variant '%s'. Use torpor, apathy, or inertia.\n", variant);
+    return 1;
+}
@@ -4,6 +4,7 @@
 #include <cmath>
 #include <vector>
 #include "raylib.h"
+#include "rlgl.h"
 
 const int SCREEN_WIDTH  = 800;
 const int SCREEN_HEIGHT = 800;
@@ -14,75 +15,234 @@ const int SAMPLES_PER_FRAME = SAMPLE_RATE / FRAME_RATE;
 const double MIN_VOLTAGE = -7.0;
 const double MAX_VOLTAGE = +7.0;
 
-struct PlotPoint
+inline Vector2 ScreenPosition(double vx, double vy)
 {
-    int x;
-    int y;
-
-    PlotPoint()
-        : x(-1)
-        , y(-1)
-        {}
-
-    PlotPoint(int _x, int _y)
-        : x(_x)
-        , y(_y)
-        {}
-};
+    // Map voltage ranges MIN_VOLTAGE..MAX_VOLTAGE to screen dimensions.
+    Vector2 point;
+    point.x = static_cast<float>(((vx - MIN_VOLTAGE) / (MAX_VOLTAGE - MIN_VOLTAGE)) * SCREEN_WIDTH);
+    point.y = static_cast<float>(((MAX_VOLTAGE - vy) / (MAX_VOLTAGE - MIN_VOLTAGE)) * SCREEN_HEIGHT);
+    return point;
+}
 
 class Plotter
 {
 private:
+    // The trail is a ring buffer of screen positions. The oldest point is at `trailIndex`.
     const std::size_t trailLength;
     std::size_t trailIndex = 0;
-    std::vector<PlotPoint> trail;
+    std::vector<Vector2> trail;
+    const Color target;
+
+    // The trail is drawn from its own vertex batch, big enough to hold
+    // every segment, so the whole trail is uploaded and drawn in one call.
+    // The batch is created on the first draw, because that needs the window's graphics context.
+    // A Plotter must therefore be destroyed before the window is closed.
+    rlRenderBatch batch{};
+    bool batchLoaded = false;
 
 public:
-    explicit Plotter(int _trailLength)
+    explicit Plotter(int _trailLength, Color _target = GREEN)
         : trailLength(std::max(2, _trailLength))
+        , target(_target)
         {}
 
-    void plot(double vx, double vy)
+    ~Plotter()
     {
-        // Map voltage ranges -12V..+12V to screen dimensions.
-        int sx = static_cast<int>(std::round(((vx - MIN_VOLTAGE) / (MAX_VOLTAGE - MIN_VOLTAGE)) * SCREEN_WIDTH));
-        int sy = static_cast<int>(std::round(((MAX_VOLTAGE - vy) / (MAX_VOLTAGE - MIN_VOLTAGE)) * SCREEN_HEIGHT));
+        if (batchLoaded)
+            rlUnloadRenderBatch(batch);
+    }
+
+    Plotter(const Plotter&) = delete;
+    Plotter& operator = (const Plotter&) = delete;
+
+    void clear()
+    {
+        // Forget the trail, so the next point starts a new one.
+        trail.clear();
+        trailIndex = 0;
+    }
+
+    void append(double vx, double vy)
+    {
+        // Add a point to the trail without drawing anything.
+        Vector2 point = ScreenPosition(vx, vy);
 
         // On the first render, prefill the trail buffer.
-        while (trail.size() < trailLength)
-            trail.push_back(PlotPoint(sx, sy));
+        if (trail.empty())
+            trail.assign(trailLength, point);
+
+        trail[trailIndex] = point;
+        if (++trailIndex == trailLength)
+            trailIndex = 0;
+    }
+
+    void plot(double vx, double vy)
+    {
+        append(vx, vy);
+        draw();
+    }
 
-        trail.at(trailIndex) = PlotPoint(sx, sy);
-        trailIndex = (trailIndex + 1) % trailLength;
+    void draw()
+    {
+        // Draw the trail, fading in from black over its oldest half,
+        // with a dot at its newest point.
+        if (trail.empty())
+            return;
 
-        Color color = BLACK;
-        Color target = GREEN;
+        if (!batchLoaded)
+        {
+            // Each batch element holds 4 vertices, and each line segment needs 2.
+            batch = rlLoadRenderBatch(1, static_cast<int>(trailLength/2 + 1));
+            batchLoaded = true;
+        }
 
-        const std::size_t fadeLength = std::max({target.r, target.g, target.b, static_cast<unsigned char>(1)});
-        const std::size_t fadeInterval = std::max(std::size_t{1}, trailLength / (2 * fadeLength));
-        std::size_t fadeCount = fadeInterval;
+        // Switching batches flushes whatever was already queued,
+        // so the trail is drawn on top of it.
+        rlSetRenderBatchActive(&batch);
+        rlBegin(RL_LINES);
 
-        std::size_t i = trailIndex;
-        while (true)
+        const float fade = 2.0f / trailLength;
+        std::size_t k = trailIndex;
+        const Vector2 *prev = &trail[k];
+        for (std::size_t i = 1; i < trailLength; ++i)
         {
-            std::size_t j = (i + 1) % trailLength;
-            if (j == trailIndex)
-                break;
-
-            const PlotPoint &a = trail.at(i);
-            const PlotPoint &b = trail.at(j);
-            DrawLine(a.x, a.y, b.x, b.y, color);
-            i = j;
-
-            if (--fadeCount == 0)
-            {
-                fadeCount = fadeInterval;
-                if (color.r < target.r) ++color.r;
-                if (color.g < target.g) ++color.g;
-                if (color.b < target.b) ++color.b;
-            }
+            if (++k == trailLength)
+                k = 0;
+            const Vector2 *next = &trail[k];
+
+            float a = std::min(1.0f, (i - 1) * fade);
+            float b = std::min(1.0f, i * fade);
+            rlColor4ub(
+                static_cast<unsigned char>(a * target.r),
+                static_cast<unsigned char>(a * target.g),
+                static_cast<unsigned char>(a * target.b),
+                255
+            );
+            rlVertex2f(prev->x, prev->y);
+            rlColor4ub(
+                static_cast<unsigned char>(b * target.r),
+                static_cast<unsigned char>(b * target.g),
+                static_cast<unsigned char>(b * target.b),
+                255
+            );
+            rlVertex2f(next->x, next->y);
+            prev = next;
         }
 
-        DrawCircle(sx, sy, 2.0f, WHITE);
+        rlEnd();
+        rlSetRenderBatchActive(nullptr);     // draws the trail and restores the default batch
+
+        DrawCircleV(*prev, 2.0f, WHITE);
+    }
+};
+
+
+class PhosphorPlotter
+{
+private:
+    // Like the phosphor on an analog oscilloscope screen, every sample deposits
+    // brightness at its position, and all brightness decays exponentially over time.
+    // The cost of each frame is fixed by the screen size and the number of samples,
+    // no matter how long the visible history is.
+    std::vector<float> density;         // accumulated sample weight at each pixel
+    std::vector<Color> pixels;
+    const Color target;
+    float decay;                        // fraction of density that remains after each frame
+    float exposure = 200.0f;            // density that is drawn at half brightness
+
+    // The texture is created on the first draw, because that needs the window's graphics context.
+    // A PhosphorPlotter must therefore be destroyed before the window is closed.
+    Texture2D texture{};
+    bool textureLoaded = false;
+
+    void deposit(int px, int py, float weight)
+    {
+        if (px >= 0 && px < SCREEN_WIDTH && py >= 0 && py < SCREEN_HEIGHT)
+            density[static_cast<std::size_t>(py)*SCREEN_WIDTH + px] += weight;
+    }
+
+public:
+    explicit PhosphorPlotter(double halfLifeFrames, Color _target = GREEN)
+        : density(static_cast<std::size_t>(SCREEN_WIDTH) * SCREEN_HEIGHT, 0.0f)
+        , pixels(density.size(), BLACK)
+        , target(_target)
+    {
+        setHalfLife(halfLifeFrames);
+    }
+
+    ~PhosphorPlotter()
+    {
+        if (textureLoaded)
+            UnloadTexture(texture);
+    }
+
+    PhosphorPlotter(const PhosphorPlotter&) = delete;
+    PhosphorPlotter& operator = (const PhosphorPlotter&) = delete;
+
+    void setHalfLife(double frames)
+    {
+        // The number of frames it takes for brightness to fall to half.
+        decay = static_cast<float>(std::pow(0.5, 1.0 / std::max(1.0e-3, frames)));
+    }
+
+    void setExposure(double samples)
+    {
+        // How many samples must land on a pixel to light it to half brightness.
+        // The circuit moves slowly enough that hundreds of consecutive samples
+        // typically land on the same pixel.
+        exposure = static_cast<float>(std::max(1.0e-3, samples));
+    }
+
+    void clear()
+    {
+        std::fill(density.begin(), density.end(), 0.0f);
+    }
+
+    void append(double vx, double vy)
+    {
+        // Deposit one sample, spread over its four nearest pixels
+        // so the trace does not snap to the pixel grid.
+        Vector2 point = ScreenPosition(vx, vy);
+        float fx = point.x - 0.5f;
+        float fy = point.y - 0.5f;
+        float x0 = std::floor(fx);
+        float y0 = std::floor(fy);
+        float tx = fx - x0;
+        float ty = fy - y0;
+        int px = static_cast<int>(x0);
+        int py = static_cast<int>(y0);
+        deposit(px,   py,   (1.0f - tx) * (1.0f - ty));
+        deposit(px+1, py,   tx * (1.0f - ty));
+        deposit(px,   py+1, (1.0f - tx) * ty);
+        deposit(px+1, py+1, tx * ty);
+    }
+
+    void draw()
+    {
+        // Decay the density by one frame and convert it to pixel colors in the same pass.
+        // Brightness d/(d + exposure) rises smoothly toward full without clipping.
+        const std::size_t n = density.size();
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            float d = density[i];
+            float b = d / (d + exposure);
+            pixels[i] = Color{
+                static_cast<unsigned char>(b * target.r),
+                static_cast<unsigned char>(b * target.g),
+                static_cast<unsigned char>(b * target.b),
+                255
+            };
+            density[i] = d * decay;
+        }
+
+        if (!textureLoaded)
+        {
+            Image image = GenImageColor(SCREEN_WIDTH, SCREEN_HEIGHT, BLACK);
+            texture = LoadTextureFromImage(image);
+            UnloadImage(image);
+            textureLoaded = true;
+        }
+        UpdateTexture(texture, pixels.data());
+        DrawTexture(texture, 0, 0, WHITE);
     }
 };
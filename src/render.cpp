@@ -0,0 +1,202 @@
+/*
+    render.cpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Renders Sloth trajectories to disk, one file per combination of
+    variant, knob position, and control voltage, for building sample libraries.
+    See SlothRender.hpp for the file formats.
+
+    https://github.com/cosinekitty/sloth
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "SlothRender.hpp"
+#include "TimeInSeconds.hpp"
+
+
+static int PrintUsage()
+{
+    printf(
+        "USAGE: render outdir [options]\n"
+        "\n"
+        "Writes one file per variant, knob position, and control voltage into the existing\n"
+        "directory outdir, each holding x, y, and z as three channels of 32-bit floats.\n"
+        "\n"
+        "Options:\n"
+        "    -v torpor,apathy,inertia   variants to render (default torpor)\n"
+        "    -k count min max           knob positions (default 1 0 0)\n"
+        "    -c count min max           control voltages (default 1 0 0)\n"
+        "    -t seconds                 simulated time per file (default 60)\n"
+        "    -r rate                    sample rate in Hz (default 44100)\n"
+        "    -f wav|raw                 file format (default wav)\n"
+        "    -j threads                 total threads to use (default: all hardware threads)\n"
+    );
+    return 1;
+}
+
+
+static bool ParseVariants(const char *text, std::vector<Analog::SlothVariant>& variants)
+{
+    using namespace Analog;
+    variants.clear();
+    std::string list(text);
+    std::size_t start = 0;
+    while (start <= list.size())
+    {
+        std::size_t comma = list.find(',', start);
+        std::string name = list.substr(start, (comma == std::string::npos) ? std::string::npos : comma - start);
+        if (name == "torpor")
+            variants.push_back(SlothVariant::Torpor);
+        else if (name == "apathy")
+            variants.push_back(SlothVariant::Apathy);
+        else if (name == "inertia")
+            variants.push_back(SlothVariant::Inertia);
+        else
+            return false;
+        if (comma == std::string::npos)
+            break;
+        start = comma + 1;
+    }
+    return !variants.empty();
+}
+
+
+static double GridValue(double lo, double hi, int count, int index)
+{
+    return (count > 1) ? lo + (hi - lo) * (static_cast<double>(index) / (count - 1)) : lo;
+}
+
+
+static std::string LowerCase(const char *text)
+{
+    std::string s(text);
+    for (char& c : s)
+        if (c >= 'A' && c <= 'Z')
+            c = static_cast<char>(c - 'A' + 'a');
+    return s;
+}
+
+
+int main(int argc, const char *argv[])
+{
+    using namespace Analog;
+
+    if (argc < 2)
+        return PrintUsage();
+
+    const char *outdir = argv[1];
+    SlothRenderSpec spec;
+    std::vector<SlothVariant> variants {SlothVariant::Torpor};
+    int knobCount = 1;
+    double knobMin = 0.0;
+    double knobMax = 0.0;
+    int cvCount = 1;
+    double cvMin = 0.0;
+    double cvMax = 0.0;
+    int threads = SlothThreadPool::defaultWorkerCount() + 1;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        const char *opt = argv[i];
+        int remaining = argc - i - 1;
+        if (!strcmp(opt, "-v") && remaining >= 1)
+        {
+            if (!ParseVariants(argv[++i], variants))
+                return PrintUsage();
+        }
+        else if (!strcmp(opt, "-k") && remaining >= 3)
+        {
+            knobCount = atoi(argv[++i]);
+            knobMin = atof(argv[++i]);
+            knobMax = atof(argv[++i]);
+        }
+        else if (!strcmp(opt, "-c") && remaining >= 3)
+        {
+            cvCount = atoi(argv[++i]);
+            cvMin = atof(argv[++i]);
+            cvMax = atof(argv[++i]);
+        }
+        else if (!strcmp(opt, "-t") && remaining >= 1)
+        {
+            spec.seconds = atof(argv[++i]);
+        }
+        else if (!strcmp(opt, "-r") && remaining >= 1)
+        {
+            spec.sampleRateHz = static_cast<float>(atof(argv[++i]));
+        }
+        else if (!strcmp(opt, "-f") && remaining >= 1)
+        {
+            const char *format = argv[++i];
+            if (!strcmp(format, "wav"))
+                spec.format = SlothRenderFormat::Wav;
+            else if (!strcmp(format, "raw"))
+                spec.format = SlothRenderFormat::Raw;
+            else
+                return PrintUsage();
+        }
+        else if (!strcmp(opt, "-j") && remaining >= 1)
+        {
+            threads = atoi(argv[++i]);
+        }
+        else
+        {
+            return PrintUsage();
+        }
+    }
+
+    if (knobCount < 1 || cvCount < 1 || spec.seconds <= 0.0 || spec.sampleRateHz <= 0.0f || threads < 1)
+        return PrintUsage();
+
+    // Name the files with 3 decimal places, or more if needed to tell the grid points apart.
+    const char *extension = (spec.format == SlothRenderFormat::Wav) ? "wav" : "raw";
+    std::vector<SlothRenderJob> jobs;
+    for (int digits = 3; digits <= 9; ++digits)
+    {
+        jobs.clear();
+        for (SlothVariant variant : variants)
+        {
+            for (int k = 0; k < knobCount; ++k)
+            {
+                for (int c = 0; c < cvCount; ++c)
+                {
+                    SlothRenderJob job;
+                    job.variant = variant;
+                    job.knob = GridValue(knobMin, knobMax, knobCount, k);
+                    job.cv = GridValue(cvMin, cvMax, cvCount, c);
+                    char name[100];
+                    snprintf(name, sizeof(name), "/%s_k%0.*lf_cv%+0.*lf.%s", LowerCase(SlothVariantName(variant)).c_str(), digits, job.knob, digits, job.cv, extension);
+                    job.filename = std::string(outdir) + name;
+                    jobs.push_back(job);
+                }
+            }
+        }
+        if (FindDuplicateRender(jobs) < 0)
+            break;
+    }
+
+    const int duplicate = FindDuplicateRender(jobs);
+    if (duplicate >= 0)
+    {
+        printf("render: ERROR - more than one grid point would be written to %s\n", jobs[duplicate].filename.c_str());
+        return 1;
+    }
+
+    SlothThreadPool pool(threads - 1);
+    printf("render: rendering %d files of %0.1lf seconds each, using %d threads.\n", static_cast<int>(jobs.size()), spec.seconds, threads);
+    double startTime = TimeInSeconds();
+    int failures = RunRenders(pool, jobs, spec);
+    double elapsed = TimeInSeconds() - startTime;
+
+    if (failures > 0)
+    {
+        printf("render: error writing %d of the files in %s\n", failures, outdir);
+        return 1;
+    }
+
+    double samples = static_cast<double>(jobs.size()) * spec.frameCount();
+    printf("render: wrote %d files in %0.3lf seconds (%0.1lf million samples per second).\n", static_cast<int>(jobs.size()), elapsed, samples / elapsed / 1.0e+6);
+    return 0;
+}
@@ -0,0 +1,226 @@
+/*
+    scrub.cpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Shows a hardware log or a render as strip charts of voltage against time,
+    one per circuit variable, and lets you zoom from the whole recording
+    down to single samples and scroll through it at any zoom.
+
+    The first time a recording is opened, its overview is built and saved
+    alongside it, as described in SlothOverview.hpp.
+
+    https://github.com/cosinekitty/sloth
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include "plotter.hpp"
+#include "SlothOverview.hpp"
+#include "TimeInSeconds.hpp"
+
+
+class StripPlotter
+{
+private:
+    // Draws one channel of a recording as a strip chart of voltage against time,
+    // using a SlothOverview so the cost depends only on the width of the strip.
+    // Each pixel column shows the range of the samples it covers, with a brighter
+    // line through their means.
+    std::vector<Analog::SlothEnvelope> envelope;
+    const Color range;
+    const Color mean;
+
+public:
+    explicit StripPlotter(Color _range = Color{0, 110, 24, 255}, Color _mean = GREEN)
+        : range(_range)
+        , mean(_mean)
+        {}
+
+    void draw(
+        const Analog::SlothOverview& overview,
+        const Analog::SlothTrace& trace,
+        int channel,
+        long long firstFrame,
+        long long frameCount,
+        int left, int top, int width, int height,
+        double minVoltage, double maxVoltage)
+    {
+        envelope.resize(static_cast<std::size_t>(std::max(0, width)));
+        const int n = overview.window(channel, firstFrame, frameCount, width, envelope.data(), trace.samples());
+
+        const double scale = height / (maxVoltage - minVoltage);
+        auto screenY = [&](float v)
+        {
+            return static_cast<float>(top + (maxVoltage - v) * scale);
+        };
+
+        Vector2 prev{};
+        for (int p = 0; p < n; ++p)
+        {
+            const Analog::SlothEnvelope& e = envelope[p];
+            const float x = left + p + 0.5f;
+            const float ymax = screenY(e.max);
+            const float ymin = screenY(e.min);
+            DrawLineV(Vector2{x, ymax}, Vector2{x, std::max(ymin, ymax + 1.0f)}, range);
+
+            const Vector2 next{x, screenY(e.mean)};
+            if (p > 0)
+                DrawLineV(prev, next, mean);
+            prev = next;
+        }
+    }
+};
+
+
+static const char *FormatTime(double seconds)
+{
+    // Formats a time as hours, minutes, and seconds to the millisecond.
+    long long millis = static_cast<long long>(std::floor(seconds * 1000.0 + 0.5));
+    return TextFormat("%02lld:%02lld:%02lld.%03lld",
+        millis / 3600000, (millis / 60000) % 60, (millis / 1000) % 60, millis % 1000);
+}
+
+
+static const char *FormatSpan(double seconds)
+{
+    if (seconds >= 3600.0)
+        return TextFormat("%.2f hours", seconds / 3600.0);
+    if (seconds >= 60.0)
+        return TextFormat("%.2f minutes", seconds / 60.0);
+    if (seconds >= 1.0)
+        return TextFormat("%.3f seconds", seconds);
+    return TextFormat("%.3f ms", seconds * 1000.0);
+}
+
+
+int main(int argc, const char *argv[])
+{
+    using namespace Analog;
+
+    if (argc < 2 || argc > 3)
+    {
+        printf("USAGE: scrub filename [raw_sample_rate]\n");
+        printf("\n");
+        printf("The file may be a hardware log, in CSV or binary format,\n");
+        printf("or a render made by the render tool, in WAV or raw format.\n");
+        printf("A raw render must be named *.raw; its sample rate defaults to 44100 Hz.\n");
+        printf("\n");
+        printf("Mouse wheel or UP/DOWN = zoom in/out, drag or LEFT/RIGHT = scroll,\n");
+        printf("HOME/END = jump to start/end, SPACE = show the whole recording.\n");
+        return 1;
+    }
+    const char *filename = argv[1];
+    const float rawSampleRateHz = (argc < 3) ? 44100.0f : static_cast<float>(atof(argv[2]));
+    if (rawSampleRateHz <= 0.0f)
+    {
+        printf("ERROR: Invalid sample rate: %s\n", argv[2]);
+        return 1;
+    }
+
+    SlothTrace trace;
+    if (!trace.load(filename, rawSampleRateHz))
+    {
+        printf("ERROR: Cannot load recording from file: %s\n", filename);
+        return 1;
+    }
+
+    const long long frames = trace.frameCount();
+    if (frames == 0)
+    {
+        printf("ERROR: No data in file: %s\n", filename);
+        return 1;
+    }
+
+    SlothOverview overview;
+    const std::string overviewFileName = OverviewFileName(filename);
+    double startTime = TimeInSeconds();
+    if (LoadOrBuildOverview(overview, trace, overviewFileName.c_str()))
+        printf("Loaded %s in %0.3f seconds.\n", overviewFileName.c_str(), TimeInSeconds() - startTime);
+    else
+        printf("Built %s in %0.3f seconds.\n", overviewFileName.c_str(), TimeInSeconds() - startTime);
+
+    const int channels = trace.channelCount();
+    const int STATUS_HEIGHT = 40;
+    const int stripHeight = (SCREEN_HEIGHT - STATUS_HEIGHT) / channels;
+
+    // Give each strip the range of its channel over the whole recording, plus a small margin.
+    std::vector<double> minVoltage(channels);
+    std::vector<double> maxVoltage(channels);
+    for (int c = 0; c < channels; ++c)
+    {
+        const SlothEnvelope total = overview.total(c);
+        double margin = 0.05 * (total.max - total.min);
+        if (margin == 0.0)
+            margin = 1.0;
+        minVoltage[c] = total.min - margin;
+        maxVoltage[c] = total.max + margin;
+    }
+
+    // The view is fractional, so zooming in and out around the same point does not drift.
+    const double minView = std::min(static_cast<double>(frames), 16.0);
+    double viewFrames = static_cast<double>(frames);
+    double viewFirst = 0.0;
+
+    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Sloth Scrubber");
+    SetTargetFPS(FRAME_RATE);
+    StripPlotter plotter;
+    while (!WindowShouldClose())
+    {
+        // Zoom around the mouse pointer, or around the middle of the view when using the keyboard.
+        double zoom = std::pow(0.8, GetMouseWheelMove());
+        double anchor = static_cast<double>(GetMouseX()) / SCREEN_WIDTH;
+        if (IsKeyPressed(KEY_UP))
+        {
+            zoom *= 0.5;
+            anchor = 0.5;
+        }
+        if (IsKeyPressed(KEY_DOWN))
+        {
+            zoom *= 2.0;
+            anchor = 0.5;
+        }
+        if (zoom != 1.0)
+        {
+            const double pivot = viewFirst + anchor*viewFrames;
+            const double zoomed = std::max(minView, std::min(static_cast<double>(frames), zoom * viewFrames));
+            viewFirst = pivot - anchor*zoomed;
+            viewFrames = zoomed;
+        }
+
+        if (IsMouseButtonDown(MOUSE_BUTTON_LEFT))
+            viewFirst -= GetMouseDelta().x * viewFrames / SCREEN_WIDTH;
+        if (IsKeyDown(KEY_RIGHT))
+            viewFirst += viewFrames / FRAME_RATE;
+        if (IsKeyDown(KEY_LEFT))
+            viewFirst -= viewFrames / FRAME_RATE;
+        if (IsKeyPressed(KEY_HOME))
+            viewFirst = 0.0;
+        if (IsKeyPressed(KEY_END))
+            viewFirst = static_cast<double>(frames);
+        if (IsKeyPressed(KEY_SPACE))
+        {
+            viewFirst = 0.0;
+            viewFrames = static_cast<double>(frames);
+        }
+        viewFirst = std::max(0.0, std::min(frames - viewFrames, viewFirst));
+
+        const long long firstFrame = static_cast<long long>(viewFirst);
+        const long long frameCount = std::max(1LL, static_cast<long long>(viewFrames + 0.5));
+
+        BeginDrawing();
+        ClearBackground(BLACK);
+        for (int c = 0; c < channels; ++c)
+        {
+            const int top = STATUS_HEIGHT + c*stripHeight;
+            DrawLine(0, top, SCREEN_WIDTH, top, Color{40, 40, 40, 255});
+            plotter.draw(overview, trace, c, firstFrame, frameCount, 0, top, SCREEN_WIDTH, stripHeight, minVoltage[c], maxVoltage[c]);
+            DrawText(TextFormat("%s  %+0.3f..%+0.3f V", SlothTrace::channelName(c), minVoltage[c], maxVoltage[c]), 10, top + 5, 10, GRAY);
+        }
+
+        const double seconds = trace.secondsPerFrame();
+        const char *status = TextFormat("%s  +%s", FormatTime(trace.startSeconds() + firstFrame*seconds), FormatSpan(frameCount*seconds));
+        DrawText(status, 10, 10, 20, GRAY);
+        EndDrawing();
+    }
+    CloseWindow();
+    return 0;
+}
@@ -0,0 +1,114 @@
+/*
+    snapshot.cpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Generates a snapshot file of pre-warmed Sloth circuit states.
+    See SlothSnapshot.hpp for a description of the file format.
+
+    https://github.com/cosinekitty/sloth
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "SlothSnapshot.hpp"
+#include "TimeInSeconds.hpp"
+
+
+static int PrintUsage()
+{
+    printf(
+        "USAGE: snapshot outfile.bin [knobCount cvCount timeCount timeMin timeMax]\n"
+        "\n"
+        "Simulates every Sloth variant over a grid of knob positions in [0, 1],\n"
+        "control voltages in [-1, +1] V, and elapsed times in seconds,\n"
+        "and writes the resulting states to a binary snapshot file.\n"
+    );
+    return 1;
+}
+
+
+static bool VerifyFile(const char *filename, std::size_t expectedSize)
+{
+    // Memory-map the file, the way a plugin would at startup, and make sure it is usable.
+    using namespace Analog;
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        printf("snapshot: cannot open file for verification: %s\n", filename);
+        return false;
+    }
+
+    struct stat info;
+    bool ok = (fstat(fd, &info) == 0) && (static_cast<std::size_t>(info.st_size) == expectedSize);
+    if (ok)
+    {
+        void *data = mmap(nullptr, expectedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            ok = false;
+        }
+        else
+        {
+            SlothSnapshotTable table;
+            ok = table.attach(data, expectedSize) && table.hasVariant(SlothVariant::Inertia);
+            munmap(data, expectedSize);
+        }
+    }
+    close(fd);
+
+    if (!ok)
+        printf("snapshot: verification failed for file: %s\n", filename);
+    return ok;
+}
+
+
+int main(int argc, const char *argv[])
+{
+    using namespace Analog;
+
+    if (argc != 2 && argc != 7)
+        return PrintUsage();
+
+    const char *filename = argv[1];
+    SlothSnapshotGrid grid;
+    if (argc == 7)
+    {
+        grid.knobCount = static_cast<std::uint32_t>(atoi(argv[2]));
+        grid.cvCount   = static_cast<std::uint32_t>(atoi(argv[3]));
+        grid.timeCount = static_cast<std::uint32_t>(atoi(argv[4]));
+        grid.timeMin = static_cast<float>(atof(argv[5]));
+        grid.timeMax = static_cast<float>(atof(argv[6]));
+        if (grid.knobCount < 1 || grid.cvCount < 1 || grid.timeCount < 1 || grid.timeMin < 0.0f || grid.timeMax < grid.timeMin)
+            return PrintUsage();
+    }
+
+    double startTime = TimeInSeconds();
+    std::vector<float> file = GenerateSnapshotFile(grid);
+    double elapsed = TimeInSeconds() - startTime;
+    const std::size_t size = file.size() * sizeof(float);
+
+    FILE *outfile = fopen(filename, "wb");
+    if (outfile == nullptr)
+    {
+        printf("snapshot: cannot open output file: %s\n", filename);
+        return 1;
+    }
+    bool written = (fwrite(file.data(), 1, size, outfile) == size);
+    written = (fclose(outfile) == 0) && written;
+    if (!written)
+    {
+        printf("snapshot: error writing file: %s\n", filename);
+        return 1;
+    }
+
+    if (!VerifyFile(filename, size))
+        return 1;
+
+    printf("snapshot: wrote %u x %u x %u states per variant (%lu bytes) to %s in %0.3lf seconds.\n",
+        grid.knobCount, grid.cvCount, grid.timeCount, static_cast<unsigned long>(size), filename, elapsed);
+    return 0;
+}
@@ -0,0 +1,140 @@
+/*
+    sweep.cpp  -  Don Cross <cosinekitty@gmail.com>  -  2026-10-14
+
+    Runs a parameter sweep over the Sloth variants, knob positions,
+    and control voltages, and writes per-point summary statistics.
+    See SlothSweep.hpp for a description of the statistics.
+
+    https://github.com/cosinekitty/sloth
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "SlothSweep.hpp"
+#include "TimeInSeconds.hpp"
+
+
+static int PrintUsage()
+{
+    printf(
+        "USAGE: sweep outfile [options]\n"
+        "\n"
+        "Writes a binary sweep file, or a CSV file if outfile ends with .csv.\n"
+        "\n"
+        "Options:\n"
+        "    -v torpor,apathy,inertia   variants to sweep (default all)\n"
+        "    -k count min max           knob positions (default 11 0 1)\n"
+        "    -c count min max           control voltages (default 25 -12 +12)\n"
+        "    -t seconds                 simulated time per point (default 100)\n"
+        "    -r rate                    sample rate in Hz (default 44100)\n"
+        "    -j threads                 total threads to use (default: all hardware threads)\n"
+    );
+    return 1;
+}
+
+
+static bool ParseVariants(const char *text, std::vector<Analog::SlothVariant>& variants)
+{
+    using namespace Analog;
+    variants.clear();
+    std::string list(text);
+    std::size_t start = 0;
+    while (start <= list.size())
+    {
+        std::size_t comma = list.find(',', start);
+        std::string name = list.substr(start, (comma == std::string::npos) ? std::string::npos : comma - start);
+        if (name == "torpor")
+            variants.push_back(SlothVariant::Torpor);
+        else if (name == "apathy")
+            variants.push_back(SlothVariant::Apathy);
+        else if (name == "inertia")
+            variants.push_back(SlothVariant::Inertia);
+        else
+            return false;
+        if (comma == std::string::npos)
+            break;
+        start = comma + 1;
+    }
+    return !variants.empty();
+}
+
+
+static bool EndsWith(const char *text, const char *suffix)
+{
+    std::size_t n = strlen(text);
+    std::size_t m = strlen(suffix);
+    return (n >= m) && !strcmp(text + n - m, suffix);
+}
+
+
+int main(int argc, const char *argv[])
+{
+    using namespace Analog;
+
+    if (argc < 2)
+        return PrintUsage();
+
+    const char *filename = argv[1];
+    SlothSweepSpec spec;
+    int threads = SlothThreadPool::defaultWorkerCount() + 1;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        const char *opt = argv[i];
+        int remaining = argc - i - 1;
+        if (!strcmp(opt, "-v") && remaining >= 1)
+        {
+            if (!ParseVariants(argv[++i], spec.variants))
+                return PrintUsage();
+        }
+        else if (!strcmp(opt, "-k") && remaining >= 3)
+        {
+            spec.knobCount = atoi(argv[++i]);
+            spec.knobMin = atof(argv[++i]);
+            spec.knobMax = atof(argv[++i]);
+        }
+        else if (!strcmp(opt, "-c") && remaining >= 3)
+        {
+            spec.cvCount = atoi(argv[++i]);
+            spec.cvMin = atof(argv[++i]);
+            spec.cvMax = atof(argv[++i]);
+        }
+        else if (!strcmp(opt, "-t") && remaining >= 1)
+        {
+            spec.seconds = atof(argv[++i]);
+        }
+        else if (!strcmp(opt, "-r") && remaining >= 1)
+        {
+            spec.sampleRateHz = static_cast<float>(atof(argv[++i]));
+        }
+        else if (!strcmp(opt, "-j") && remaining >= 1)
+        {
+            threads = atoi(argv[++i]);
+        }
+        else
+        {
+            return PrintUsage();
+        }
+    }
+
+    if (spec.knobCount < 1 || spec.cvCount < 1 || spec.seconds <= 0.0 || spec.sampleRateHz <= 0.0f || threads < 1)
+        return PrintUsage();
+
+    SlothThreadPool pool(threads - 1);
+    printf("sweep: simulating %d points for %0.1lf seconds each, using %d threads.\n", spec.pointCount(), spec.seconds, threads);
+    double startTime = TimeInSeconds();
+    std::vector<SlothSweepPoint> results = RunSweep(pool, spec);
+    double elapsed = TimeInSeconds() - startTime;
+
+    bool ok = EndsWith(filename, ".csv") ? WriteSweepCsv(filename, results) : WriteSweepFile(filename, spec, results);
+    if (!ok)
+    {
+        printf("sweep: error writing file: %s\n", filename);
+        return 1;
+    }
+
+    printf("sweep: wrote %s in %0.3lf seconds.\n", filename, elapsed);
+    return 0;
+}
@@ -7,44 +7,20 @@
 */
 
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include "SlothLog.hpp"
 #include "plotter.hpp"
 
 
-double ArduinoVoltage(int a)
-{
-    // https://docs.google.com/spreadsheets/d/12UB6mihdSQhdCoypwO_CTBR4rIwEmjkxOjuWeSCxXrg/edit#gid=0
-    // The range a=[18, 1019] maps to circuit voltages [-12, +12].
-    return ((a - 18.0) / (1019.0 - 18.0))*24.0 - 12.0;
-}
-
-
-double Node3Voltage(int a)
-{
-    // https://docs.google.com/spreadsheets/d/12UB6mihdSQhdCoypwO_CTBR4rIwEmjkxOjuWeSCxXrg/edit#gid=1457893736
-    // I used a different op-amp circuit than the other voltages, because
-    // this node's voltage varies from about -0.25 V to +0.25 V.
-    // I assumed a safe range of -0.5 V to +0.5 V.
-    // Then I chose 4 resistors combined with the op-amp to produce
-    // the formula A = 5*w + 2.5, to convert to the range [0 V, +5 V].
-    // Based on direct measurements, I found the following:
-    // w = -0.499 V     ==>  A = -0.014 V   ==>     -2.96 arduino units
-    // w =  0 V         ==>  A =  2.52 V    ==>    515.59 arduino units
-    // w = +0.500 V     ==>  A = +5.06 V    ==>   1035.18 arduino units
-    // Using these as a reference, I came up with the following formula
-    // for the inferred value of the voltage `w` from the arduino units `a`:
-    return (a*(5.0 / 1023.0) - 2.52) / 5.079079079;
-}
-
-
-double SelectVoltage(char varname, double x, double y, double z, double w)
+double SelectVoltage(const Analog::SlothLog& log, int row, char varname)
 {
     switch (varname)
     {
-    case 'x': return x;
-    case 'y': return y;
-    case 'z': return z;
-    case 'w': return w;
+    case 'x': return log.xVoltage(row);
+    case 'y': return log.yVoltage(row);
+    case 'z': return log.zVoltage(row);
+    case 'w': return log.wVoltage(row);
     default:  return 0;
     }
 }
@@ -52,9 +28,14 @@ double SelectVoltage(char varname, double x, double y, double z, double w)
 
 int main(int argc, const char *argv[])
 {
-    if (argc != 3)
+    if (argc < 3 || argc > 4)
     {
-        printf("USAGE: viewlog filename.csv varpair\n");
+        printf("USAGE: viewlog logfile varpair [rows_per_frame]\n");
+        printf("\n");
+        printf("The log file may be an Arduino CSV log or a binary log made by logconv.\n");
+        printf("\n");
+        printf("While playing: UP/DOWN = faster/slower, LEFT/RIGHT = skip back/ahead,\n");
+        printf("SPACE = pause/resume, HOME = restart.\n");
         return 1;
     }
     const char *filename = argv[1];
@@ -65,55 +46,96 @@ int main(int argc, const char *argv[])
         return 1;
     }
 
-    FILE *infile = fopen(filename, "rt");
-    if (infile == nullptr)
+    const int MAX_SPEED = 4096;
+    int speed = (argc < 4) ? 1 : atoi(argv[3]);     // rows per frame
+    if (speed < 1 || speed > MAX_SPEED)
+    {
+        printf("ERROR: rows_per_frame must be an integer in the range 1..%d.\n", MAX_SPEED);
+        return 1;
+    }
+
+    Analog::SlothLog log;
+    if (!log.load(filename))
+    {
+        if (log.errorLineNumber() > 0)
+            printf("ERROR: Invalid data in line %d of file: %s\n", log.errorLineNumber(), filename);
+        else
+            printf("ERROR: Cannot open input file: %s\n", filename);
+        return 1;
+    }
+
+    if (log.rowCount() == 0)
     {
-        printf("ERROR: Cannot open input file: %s\n", filename);
+        printf("ERROR: No data in file: %s\n", filename);
         return 1;
     }
 
-    Plotter plotter(500);
+    const int TRAIL_LENGTH = 500;
+    const int skipRows = std::max(1, log.rowCount() / 100);
+    int row = 0;            // the next row to plot
+    bool paused = false;
+    bool jumped = false;
 
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Sloth Torpor Data");
     SetTargetFPS(FRAME_RATE);
-    while (!WindowShouldClose())
     {
-        BeginDrawing();
-        if (infile != nullptr)
+        // The plotter holds graphics resources, so it must be destroyed before the window is closed.
+        Plotter plotter(TRAIL_LENGTH);
+        while (!WindowShouldClose())
         {
-            char line[100];
-            if (fgets(line, sizeof(line), infile))
+            if (IsKeyPressed(KEY_UP))
+                speed = std::min(MAX_SPEED, 2*speed);
+            if (IsKeyPressed(KEY_DOWN))
+                speed = std::max(1, speed/2);
+            if (IsKeyPressed(KEY_SPACE))
+                paused = !paused;
+            if (IsKeyPressed(KEY_HOME))
             {
-                int millis, ax, ay, az, aw;
-                int n = sscanf(line, "%d,%d,%d,%d,%d", &millis, &ax, &ay, &az, &aw);
-                if (n < 4)
-                {
-                    printf("Unexpected number of circuit data read from %s: %d\n", filename, n);
-                    fclose(infile);
-                    infile = nullptr;
-                }
-                else
-                {
-                    ClearBackground(BLACK);
-                    double vx = ArduinoVoltage(ax);
-                    double vy = ArduinoVoltage(ay);
-                    double vz = ArduinoVoltage(az);
-                    double vw = (n < 5) ? 0.0 : Node3Voltage(aw);    // `w` requires a different conversion formula
-                    double first = SelectVoltage(varlist[0], vx, vy, vz, vw);
-                    double second = SelectVoltage(varlist[1], vx, vy, vz, vw);
-                    plotter.plot(first, second);
-                }
+                row = 0;
+                jumped = true;
             }
-            else
+            if (IsKeyPressed(KEY_RIGHT))
             {
-                printf("Hit end of file: %s\n", filename);
-                fclose(infile);
-                infile = nullptr;
+                row = std::min(log.rowCount() - 1, row + skipRows);
+                jumped = true;
             }
+            if (IsKeyPressed(KEY_LEFT))
+            {
+                row = std::max(0, row - skipRows);
+                jumped = true;
+            }
+
+            if (jumped)
+            {
+                // Rebuild the trail leading up to the new position.
+                plotter.clear();
+                for (int r = std::max(0, row - TRAIL_LENGTH); r < row; ++r)
+                    plotter.append(SelectVoltage(log, r, varlist[0]), SelectVoltage(log, r, varlist[1]));
+                jumped = false;
+            }
+
+            if (!paused)
+            {
+                for (int n = 0; n < speed && row < log.rowCount(); ++n, ++row)
+                    plotter.append(SelectVoltage(log, row, varlist[0]), SelectVoltage(log, row, varlist[1]));
+            }
+
+            BeginDrawing();
+            ClearBackground(BLACK);
+            plotter.draw();
+
+            int shown = std::max(0, row - 1);
+            int seconds = log.millis()[shown] / 1000;
+            const char *status = TextFormat(
+                "%02d:%02d:%02d  row %d/%d  %dx%s",
+                seconds / 3600, (seconds / 60) % 60, seconds % 60,
+                shown + 1, log.rowCount(), speed,
+                paused ? "  PAUSED" : ((row == log.rowCount()) ? "  END" : "")
+            );
+            DrawText(status, 10, 10, 20, GRAY);
+            EndDrawing();
         }
-        EndDrawing();
     }
     CloseWindow();
-    if (infile != nullptr) fclose(infile);
     return 0;
 }